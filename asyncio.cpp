@@ -0,0 +1,341 @@
+/**
+ * \file asyncio.cpp
+ *
+ * Ez a fájl tartalmazza az AsyncIO osztály megvalósítását
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+#include "asyncio.h"
+#include "memtrace.h"
+
+#if defined( __linux__ )
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+// Az IORING_OP_READ és az opkódok lekérdezése (probe) 5.6-os kernel fejlécekkel érhető el
+#if defined( __linux__ ) && defined( __NR_io_uring_setup ) && defined( IO_URING_OP_SUPPORTED )
+#define NHF_URING
+#endif
+
+namespace
+{
+    /// A környezeti változó szerinti háttér (NHF_ASYNC_IO=threads esetén a szálkészlet)
+    File::AsyncIO::Backend preferredBackend()
+    {
+        const char* choice = std::getenv( "NHF_ASYNC_IO" );
+        return choice != nullptr && std::strcmp( choice, "threads" ) == 0 ? File::AsyncIO::THREADS : File::AsyncIO::URING;
+    }
+
+#ifdef NHF_URING
+    /// A kernel támogatja-e az IORING_OP_READ opkódot (csak 5.6 óta létezik; régebbi kernelen
+    /// a gyűrű létrejön, de a kérések -EINVAL hibával térnének vissza)
+    /// @param fd - a gyűrű fájlleírója
+    bool supportsOps( int fd )
+    {
+        // io_uring_probe + IORING_OP_LAST darab io_uring_probe_op, io_uring_probe_op egységekben foglalva
+        std::vector<io_uring_probe_op> buffer( ( sizeof( io_uring_probe ) + IORING_OP_LAST * sizeof( io_uring_probe_op ) ) / sizeof( io_uring_probe_op ) );
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>( buffer.data() );
+        if ( syscall( __NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST ) < 0 ) return false;
+
+        if ( IORING_OP_READ > probe->last_op || IORING_OP_READ >= probe->ops_len ) return false;
+        return ( probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED ) != 0;
+    }
+#endif
+}
+
+/**
+ * Ring osztály
+ * Az io_uring leképezett beküldési és befejezési gyűrűje
+ */
+struct File::AsyncIO::Ring
+{
+#ifdef NHF_URING
+    int fd;                     /// A gyűrű fájlleírója
+    void* sqMap;                /// Beküldési gyűrű
+    void* cqMap;                /// Befejezési gyűrű (egyező lehet sqMap-pel)
+    void* sqeMap;               /// Beküldési bejegyzések
+    size_t sqSize, cqSize, sqeSize;
+
+    unsigned* sqHead;           /// Beküldési gyűrű eleje (a kernel írja)
+    unsigned* sqTail;           /// Beküldési gyűrű vége (mi írjuk)
+    unsigned* sqMask;
+    unsigned* sqArray;
+    unsigned sqEntries;         /// A beküldési gyűrű mérete
+    io_uring_sqe* sqes;
+
+    unsigned* cqHead;           /// Befejezési gyűrű eleje (mi írjuk)
+    unsigned* cqTail;
+    unsigned* cqMask;
+    io_uring_cqe* cqes;
+
+    Ring() :fd( -1 ), sqMap( MAP_FAILED ), cqMap( MAP_FAILED ), sqeMap( MAP_FAILED ), sqSize( 0 ), cqSize( 0 ), sqeSize( 0 ) {};
+
+    ~Ring()
+    {
+        if ( sqeMap != MAP_FAILED ) munmap( sqeMap, sqeSize );
+        if ( cqMap != MAP_FAILED && cqMap != sqMap ) munmap( cqMap, cqSize );
+        if ( sqMap != MAP_FAILED ) munmap( sqMap, sqSize );
+        if ( fd >= 0 ) close( fd );
+    }
+#endif
+};
+
+File::AsyncIO::Buffer::~Buffer() {
+    // posix_memalign foglalta, nem a memtrace - a free makrót meg kell kerülni
+    (std::free)( bytes );
+}
+
+void File::AsyncIO::Buffer::allocate( size_t length ) {
+    length = ( length + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+    void* aligned = nullptr;
+    if ( posix_memalign( &aligned, ALIGNMENT, length ) != 0 ) throw std::bad_alloc();
+
+    (std::free)( bytes );
+    bytes = (char*)aligned;
+}
+
+File::AsyncIO::AsyncIO( Backend preferred )
+    :backend( THREADS ), nextTicket( 1 ), ring( nullptr ), inFlight( 0 ), reaping( false ), stopping( false )
+{
+    if ( preferred == URING && setupRing() ) { backend = URING; return; }
+
+    for ( int i = 0; i < WORKERS; i++ ) workers.push_back( std::thread( &AsyncIO::work, this ) );
+}
+
+File::AsyncIO::~AsyncIO() {
+    std::unique_lock<std::mutex> lock( mutex );
+    if ( ring != nullptr )
+    {
+        while ( inFlight > 0 ) reap( lock );
+        delete ring;
+        return;
+    }
+
+    stopping = true;
+    pending.notify_all();
+    lock.unlock();
+    for ( size_t i = 0; i < workers.size(); i++ ) workers[i].join();
+}
+
+File::AsyncIO& File::AsyncIO::instance() {
+    static AsyncIO shared( preferredBackend() );
+    return shared;
+}
+
+bool File::AsyncIO::setupRing() {
+#ifdef NHF_URING
+    io_uring_params params;
+    std::memset( &params, 0, sizeof( params ) );
+    int fd = (int)syscall( __NR_io_uring_setup, QUEUE_DEPTH, &params );
+    if ( fd < 0 ) return false;
+    if ( !supportsOps( fd ) ) { close( fd ); return false; }
+
+    Ring* r = new Ring;
+    r->fd = fd;
+    r->sqSize = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+    r->cqSize = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+    r->sqeSize = params.sq_entries * sizeof( io_uring_sqe );
+
+    // Újabb kernelen a két gyűrű egyetlen leképezésben van
+    bool single = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+    if ( single ) r->sqSize = r->cqSize = std::max( r->sqSize, r->cqSize );
+
+    r->sqMap = mmap( nullptr, r->sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING );
+    if ( r->sqMap == MAP_FAILED ) { delete r; return false; }
+    r->cqMap = single ? r->sqMap : mmap( nullptr, r->cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING );
+    if ( r->cqMap == MAP_FAILED ) { delete r; return false; }
+    r->sqeMap = mmap( nullptr, r->sqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES );
+    if ( r->sqeMap == MAP_FAILED ) { delete r; return false; }
+
+    char* sq = (char*)r->sqMap;
+    r->sqHead = (unsigned*)( sq + params.sq_off.head );
+    r->sqTail = (unsigned*)( sq + params.sq_off.tail );
+    r->sqMask = (unsigned*)( sq + params.sq_off.ring_mask );
+    r->sqArray = (unsigned*)( sq + params.sq_off.array );
+    r->sqEntries = params.sq_entries;
+    r->sqes = (io_uring_sqe*)r->sqeMap;
+
+    char* cq = (char*)r->cqMap;
+    r->cqHead = (unsigned*)( cq + params.cq_off.head );
+    r->cqTail = (unsigned*)( cq + params.cq_off.tail );
+    r->cqMask = (unsigned*)( cq + params.cq_off.ring_mask );
+    r->cqes = (io_uring_cqe*)( cq + params.cq_off.cqes );
+
+    ring = r;
+    return true;
+#else
+    return false;
+#endif
+}
+
+unsigned long long File::AsyncIO::read( int fd, char* data, size_t length, long long offset ) {
+    std::unique_lock<std::mutex> lock( mutex );
+    return submit( fd, data, length, offset, lock );
+}
+
+unsigned long long File::AsyncIO::submit( int fd, char* data, size_t length, long long offset, std::unique_lock<std::mutex>& lock ) {
+    unsigned long long ticket = nextTicket++;
+    Request request = { ticket, fd, data, length, offset, 0 };
+
+    if ( ring == nullptr )
+    {
+        queue.push_back( request );
+        pending.notify_one();
+        return ticket;
+    }
+
+#ifdef NHF_URING
+    // Tele van a gyűrű - megvárjuk, hogy felszabaduljon egy hely
+    while ( inFlight >= ring->sqEntries ) reap( lock );
+#endif
+
+    active[ticket] = request;
+    long long error = push( request );
+    if ( error < 0 ) { active.erase( ticket ); results[ticket] = error; }
+    return ticket;
+}
+
+long long File::AsyncIO::push( const Request& request ) {
+#ifdef NHF_URING
+    unsigned tail = *ring->sqTail;
+    unsigned index = tail & *ring->sqMask;
+    io_uring_sqe* sqe = &ring->sqes[index];
+    std::memset( sqe, 0, sizeof( *sqe ) );
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = request.fd;
+    sqe->addr = (unsigned long long)request.data;
+    sqe->len = (unsigned)request.length;
+    sqe->off = (unsigned long long)request.offset;
+    sqe->user_data = request.ticket;
+    ring->sqArray[index] = index;
+    __atomic_store_n( ring->sqTail, tail + 1, __ATOMIC_RELEASE );
+    inFlight++;
+
+    while ( syscall( __NR_io_uring_enter, ring->fd, 1, 0, 0, nullptr, 0 ) < 0 )
+    {
+        int error = errno;
+        if ( error != EINTR && error != EAGAIN && error != EBUSY )
+        {
+            // Ha a kernel nem vette át a bejegyzést, visszavesszük (különben a következő beküldéssel együtt
+            // elküldené); ha átvette, az eredménye a befejezési gyűrűben érkezik
+            if ( __atomic_load_n( ring->sqHead, __ATOMIC_ACQUIRE ) != tail ) return 0;
+            __atomic_store_n( ring->sqTail, tail, __ATOMIC_RELEASE );
+            inFlight--;
+            return -error;
+        }
+        harvest();
+    }
+    return 0;
+#else
+    (void)request;
+    return -ENOSYS;
+#endif
+}
+
+void File::AsyncIO::harvest() {
+#ifdef NHF_URING
+    unsigned head = *ring->cqHead;
+    unsigned tail = __atomic_load_n( ring->cqTail, __ATOMIC_ACQUIRE );
+    std::vector<Request> retries;
+    for ( ; head != tail; head++ )
+    {
+        const io_uring_cqe& cqe = ring->cqes[head & *ring->cqMask];
+        inFlight--;
+
+        std::unordered_map<unsigned long long, Request>::iterator it = active.find( cqe.user_data );
+        if ( it == active.end() ) continue;
+        Request& request = it->second;
+
+        // Rövid olvasás - a hátralévő részt újra kérjük (a szálkészlet pread ciklusához hasonlóan)
+        if ( cqe.res > 0 && (size_t)cqe.res < request.length )
+        {
+            request.data += cqe.res;
+            request.length -= cqe.res;
+            request.offset += cqe.res;
+            request.transferred += cqe.res;
+            retries.push_back( request );
+            continue;
+        }
+
+        results[request.ticket] = cqe.res < 0 ? cqe.res : request.transferred + cqe.res;
+        active.erase( it );
+    }
+    __atomic_store_n( ring->cqHead, head, __ATOMIC_RELEASE );
+
+    // Minden folytatás helyére épp befejeződött egy kérés, így van hely a gyűrűben
+    for ( size_t i = 0; i < retries.size(); i++ )
+    {
+        long long error = push( retries[i] );
+        if ( error < 0 ) { active.erase( retries[i].ticket ); results[retries[i].ticket] = error; }
+    }
+#endif
+}
+
+void File::AsyncIO::reap( std::unique_lock<std::mutex>& lock ) {
+    if ( reaping ) { done.wait( lock ); return; }
+
+#ifdef NHF_URING
+    reaping = true;
+    lock.unlock();
+    syscall( __NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0 );
+    lock.lock();
+    reaping = false;
+
+    harvest();
+    done.notify_all();
+#endif
+}
+
+long long File::AsyncIO::wait( unsigned long long ticket ) {
+    std::unique_lock<std::mutex> lock( mutex );
+    while ( true )
+    {
+        if ( ring != nullptr ) harvest();
+
+        std::unordered_map<unsigned long long, long long>::iterator it = results.find( ticket );
+        if ( it != results.end() )
+        {
+            long long result = it->second;
+            results.erase( it );
+            return result;
+        }
+
+        if ( ring != nullptr ) reap( lock );
+        else done.wait( lock );
+    }
+}
+
+void File::AsyncIO::work() {
+    std::unique_lock<std::mutex> lock( mutex );
+    while ( true )
+    {
+        while ( !stopping && queue.empty() ) pending.wait( lock );
+        if ( queue.empty() ) return;
+
+        Request request = queue.front();
+        queue.pop_front();
+        lock.unlock();
+
+        // Rövid olvasás esetén folytatjuk, a fájl végén (0) megállunk
+        long long result = 0;
+        while ( (size_t)result < request.length )
+        {
+            ssize_t n = pread( request.fd, request.data + result, request.length - result, (off_t)( request.offset + result ) );
+            if ( n < 0 && errno == EINTR ) continue;
+            if ( n < 0 ) { result = -errno; break; }
+            if ( n == 0 ) break;
+            result += n;
+        }
+
+        lock.lock();
+        results[request.ticket] = result;
+        done.notify_all();
+    }
+}
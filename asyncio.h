@@ -0,0 +1,155 @@
+#ifndef NHF4_ASYNCIO_H
+#define NHF4_ASYNCIO_H
+/**
+ * \file asyncio.h
+ *
+ * Ez a fájl tartalmazza az adatfájlok aszinkron olvasásához szükséges AsyncIO osztályt
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "memtrace.h"
+
+namespace File
+{
+    /**
+     * AsyncIO osztály
+     * Aszinkron blokkolvasás: Linuxon io_uring-gal, ha az nem érhető el (régi kernel, tiltott
+     * rendszerhívás, más rendszer), akkor egy kis szálkészlettel, amely pread hívásokat végez.
+     * Írási kérés nincs: a Writer szinkron, vektoros writev hívásokkal ír.
+     * A kérések azonnal visszatérnek egy sorszámmal, az eredményt wait() adja vissza - így a hívó a következő
+     * blokkok olvasása közben feldolgozhatja az előzőt. Több szál is használhatja egyszerre.
+     * A háttér az NHF_ASYNC_IO környezeti változóval választható ("uring" vagy "threads").
+     */
+    class AsyncIO
+    {
+    public:
+        enum { BLOCK = 1 << 20 };       /// Egy kérés mérete (1 MiB), a fájlbeli eltolások ennek többszörösei
+        enum { ALIGNMENT = 4096 };      /// Az olvasópufferek igazítása (lapméret)
+        enum { DEPTH = 4 };             /// Fájlonként egyszerre futó kérések
+        enum { QUEUE_DEPTH = 64 };      /// A gyűrű mérete (io_uring)
+        enum { WORKERS = 4 };           /// A szálkészlet mérete (tartalék háttér)
+
+        /// A háttér típusa
+        enum Backend { URING, THREADS };
+
+        /**
+         * Buffer osztály
+         * Lapméretre igazított puffer az olvasásokhoz
+         */
+        class Buffer
+        {
+        private:
+            char* bytes;    /// Adat (nullptr, amíg nincs lefoglalva)
+
+            /// Másolás tiltása
+            Buffer( const Buffer& );
+            Buffer& operator=( const Buffer& );
+
+        public:
+            /// Default konstruktor - üres puffer
+            Buffer() :bytes( nullptr ) {};
+
+            /// Destruktor
+            ~Buffer();
+
+            /// Lefoglalja a puffert (std::bad_alloc hibát dob, ha nem sikerült)
+            /// @param length - méret (lapméretre kerekítjük)
+            void allocate( size_t length );
+
+            char* data() { return bytes; }
+            const char* data() const { return bytes; }
+        };
+
+    private:
+        /// Egy függő kérés (io_uring esetén a még hátralévő rész)
+        struct Request
+        {
+            unsigned long long ticket;  /// Sorszám
+            int fd;                     /// Fájlleíró
+            char* data;                 /// Puffer
+            size_t length;              /// Hossz
+            long long offset;           /// Fájlbeli eltolás
+            long long transferred;      /// A korábbi (rövid) olvasásokkal már beolvasott bájtok
+        };
+
+        Backend backend;                /// A használt háttér
+
+        std::mutex mutex;               /// A kéréseket és az eredményeket védi
+        std::condition_variable done;   /// Jelez, ha elkészült egy kérés
+        unsigned long long nextTicket;  /// A következő kérés sorszáma
+        std::unordered_map<unsigned long long, long long> results;  /// Sorszám -> eredmény (bájtok vagy -errno)
+
+        // io_uring
+        struct Ring;                    /// A gyűrű leképezései (asyncio.cpp - csak Linuxon)
+        Ring* ring;                     /// A gyűrű, nullptr ha a szálkészlet a háttér
+        std::unordered_map<unsigned long long, Request> active;    /// Sorszám -> beküldött kérés (rövid olvasás folytatásához)
+        unsigned int inFlight;          /// Beküldött, még be nem fejezett kérések
+        bool reaping;                   /// Vár-e valamelyik szál a befejezésekre
+
+        // Szálkészlet
+        std::vector<std::thread> workers;   /// Munkaszálak
+        std::deque<Request> queue;          /// Várakozó kérések
+        std::condition_variable pending;    /// Jelez, ha új kérés érkezett
+        bool stopping;                      /// Leállítás kérve
+
+        /// Másolás tiltása
+        AsyncIO( const AsyncIO& );
+        AsyncIO& operator=( const AsyncIO& );
+
+        /// A gyűrű létrehozása
+        /// @return bool - sikerült-e (ha nem, a szálkészlet lesz a háttér)
+        bool setupRing();
+
+        /// Olvasási kérés beküldése (mutex zárolva)
+        unsigned long long submit( int fd, char* data, size_t length, long long offset, std::unique_lock<std::mutex>& lock );
+
+        /// Bejegyzés a beküldési gyűrűbe és beküldése (mutex zárolva, a gyűrűben van hely)
+        /// @return long long - 0, vagy -errno, ha a kernel nem vette át a bejegyzést
+        long long push( const Request& request );
+
+        /// A befejezett io_uring kérések eredményének átvétele (mutex zárolva)
+        /// A rövid olvasás hátralévő részét újra beküldi, így csak a 0 bájtos olvasás jelent fájlvéget
+        void harvest();
+
+        /// Megvárja, hogy legalább egy io_uring kérés befejeződjön (mutex zárolva, várakozás közben elengedi)
+        /// Egyszerre csak egy szál vár a gyűrűn, a többi a done jelzésre
+        void reap( std::unique_lock<std::mutex>& lock );
+
+        /// Munkaszál: végrehajtja a sorban álló kéréseket
+        void work();
+
+    public:
+        /// Konstruktor
+        /// @param preferred - a kívánt háttér (ha az io_uring nem érhető el, a szálkészletet használja)
+        explicit AsyncIO( Backend preferred = URING );
+
+        /// Destruktor - megvárja a függő kéréseket
+        ~AsyncIO();
+
+        /// A közös példány (a háttér az NHF_ASYNC_IO környezeti változó szerint)
+        static AsyncIO& instance();
+
+        /// A használt háttér neve
+        const char* backendName() const { return backend == URING ? "io_uring" : "threads"; }
+
+        /// Olvasás indítása
+        /// @param fd - fájlleíró
+        /// @param data - puffer (a wait() visszatéréséig érvényes kell maradjon)
+        /// @param length - hossz
+        /// @param offset - fájlbeli eltolás
+        /// @return unsigned long long - a kérés sorszáma
+        unsigned long long read( int fd, char* data, size_t length, long long offset );
+
+        /// Megvárja a kérés befejezését
+        /// @param ticket - a kérés sorszáma
+        /// @return long long - az átvitt bájtok száma, hiba esetén -errno
+        long long wait( unsigned long long ticket );
+    };
+}
+
+#endif // NHF4_ASYNCIO_H
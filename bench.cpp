@@ -0,0 +1,872 @@
+/**
+ * \file bench.cpp
+ *
+ * Teljesítménymérő program
+ * Szintetikus adatfájlokat generál (recipes.dat, ingredients.dat, pantry.dat) a megadott méretben,
+ * majd megméri a fontosabb műveletek futási idejét. Az eredményt JSON formátumban írja ki,
+ * így az egyes futások összehasonlíthatóak.
+ *
+ * Használat: receptkonyv_bench [--scale N] [--ingredients M] [--pantry P] [--ops K]
+ *                              [--seed S] [--dir konyvtar] [--out fajl]
+ * A generált fájlok alapértelmezetten a bench_data könyvtárba kerülnek, hogy ne írják felül a valódi adatokat.
+ * A javasolt méret 10^3 és 10^7 rekord között van.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "memtrace.h"
+#include "string5.h"
+#include "list.h"
+#include "components.h"
+#include "file.h"
+#include "asyncio.h"
+#include "search.h"
+#include "similarity.h"
+#include "bktree.h"
+#include "shopping.h"
+#include "compact.h"
+#include "textcodec.h"
+#include "recipestore.h"
+#include "catalog.h"
+#include "rcu.h"
+#include "lrucache.h"
+#include "query.h"
+#include "rank.h"
+
+using namespace Components;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+namespace
+{
+    /// Alapanyagnevek - a szótár ezekből és egy sorszámból áll össze
+    const char* const ingredientNames[] = {
+            "paradicsom", "liszt", "tojas", "cukor", "vaj", "tej", "so", "bors", "hagyma",
+            "fokhagyma", "csirke", "sertes", "marha", "rizs", "burgonya", "sajt", "tejfol",
+            "paprika", "gomba", "repa", "alma", "citrom", "olaj", "eleszto", "tarkony"
+    };
+
+    /// Mértékegységek
+    const char* const units[] = { "g", "dkg", "kg", "ml", "dl", "l", "db", "ek", "tk", "csipet" };
+
+    /// Receptnév-töredékek
+    const char* const adjectives[] = { "Rantott", "Sult", "Fott", "Paradicsomos", "Sajtos", "Toltott", "Parolt", "Csipos" };
+    const char* const dishes[] = { "csirke", "palacsinta", "leves", "rakott krumpli", "fozelek", "pogacsa", "teszta", "rizotto" };
+
+    /// Instrukció-töredékek
+    const char* const instructions[] = {
+            "keverjuk ossze a hozzavalokat", "sutjuk 180 fokon 25 percig", "forraljuk fel a vizet",
+            "vagjuk apro kockakra", "sozzuk borsozzuk izles szerint", "hagyjuk pihenni 10 percig",
+            "piritsuk meg a hagymat az olajon", "tegyuk tepsibe es tegyuk be a suthobe"
+    };
+
+    template<class T, size_t N>
+    size_t countOf( T (&)[N] ) { return N; }
+
+    /**
+     * Random osztály
+     * Egyszerű, determinisztikus (xorshift) véletlenszám-generátor,
+     * hogy ugyanazzal a seed-del ugyanazt az adathalmazt kapjuk
+     */
+    class Random
+    {
+        unsigned long long state; /// Belső állapot
+
+    public:
+        /// Konstruktor
+        /// @param seed - kezdőérték
+        explicit Random( unsigned long long seed ) :state( seed ? seed : 88172645463325252ULL ) {};
+
+        /// Következő véletlenszám
+        /// @return 64 bites véletlenszám
+        unsigned long long next()
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+
+        /// Véletlenszám a [0, n) intervallumban
+        /// @param n - felső határ
+        /// @return véletlenszám
+        size_t below( size_t n ) { return n == 0 ? 0 : (size_t)(next() % n); }
+    };
+
+    /**
+     * Config osztály
+     * A parancssorból beállítható paraméterek
+     */
+    struct Config
+    {
+        size_t recipes;         /// Receptek száma
+        size_t ingredients;     /// Alapanyagok száma
+        size_t pantry;          /// Kamra elemeinek száma
+        size_t ops;             /// Ismétlésszám a push/pop/indexOf mérésekhez
+        unsigned long long seed;/// Seed
+        std::string dir;        /// Az adatfájlok könyvtára
+        std::string out;        /// Kimeneti fájl (üres esetén standard kimenet)
+
+        Config() :recipes( 1000 ), ingredients( 0 ), pantry( 0 ), ops( 100 ), seed( 42 ), dir( "bench_data" ) {};
+    };
+
+    /**
+     * Measurement osztály
+     * Egy mérés eredménye
+     */
+    struct Measurement
+    {
+        std::string name;   /// Mérés neve
+        long long ns;       /// Teljes eltelt idő nanoszekundumban
+        size_t ops;         /// Végrehajtott műveletek száma
+        size_t items;       /// Érintett elemek száma (pl. találatok, beolvasott elemek)
+
+        /// További, nem időmérő számlálók (pl. lapok, megvizsgált receptek)
+        std::vector<std::pair<std::string, size_t> > counters;
+
+        Measurement( const std::string& n, long long t, size_t o, size_t i ) :name( n ), ns( t ), ops( o ), items( i ) {};
+
+        /// Számláló hozzáadása
+        /// @param counter - számláló neve
+        /// @param value - értéke
+        /// @return Measurement& - önmaga (láncolható)
+        Measurement& with( const std::string& counter, size_t value )
+        {
+            counters.push_back( std::make_pair( counter, value ) );
+            return *this;
+        }
+
+        /// Egy műveletre jutó idő (ops = 0 esetén a teljes idő)
+        double nsPerOp() const { return ops ? (double)ns / (double)ops : (double)ns; }
+    };
+
+    /**
+     * Stopwatch osztály
+     * Egyszerű időmérő
+     */
+    class Stopwatch
+    {
+        std::chrono::steady_clock::time_point begin; /// Kezdés időpontja
+
+    public:
+        Stopwatch() :begin( std::chrono::steady_clock::now() ) {};
+
+        /// Az indítás óta eltelt idő
+        /// @return eltelt idő nanoszekundumban
+        long long elapsed() const
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - begin ).count();
+        }
+    };
+
+    std::string ingredientName( size_t i )
+    {
+        std::stringstream stream;
+        stream << ingredientNames[i % countOf( ingredientNames )];
+        if ( i >= countOf( ingredientNames ) ) stream << i / countOf( ingredientNames );
+        return stream.str();
+    }
+
+    const char* ingredientUnit( size_t i ) { return units[i % countOf( units )]; }
+
+    std::string path( const Config& config, const char* file ) { return config.dir + "/" + file; }
+
+    /// Legenerálja a három adatfájlt a beolvasó által várt formátumban
+    /// @param config - beállítások
+    void generate( const Config& config )
+    {
+        Random random( config.seed );
+
+        std::ofstream ingredientFile( path( config, "ingredients.dat" ).c_str() );
+        ingredientFile << "<Ingredient>\n";
+        for ( size_t i = 0; i < config.ingredients; i++ )
+            ingredientFile << ingredientName( i ) << ';' << ingredientUnit( i ) << '\n';
+        ingredientFile << "</Ingredient>\n";
+
+        std::ofstream pantryFile( path( config, "pantry.dat" ).c_str() );
+        pantryFile << "<IngredientQ>\n";
+        for ( size_t i = 0; i < config.pantry; i++ )
+            pantryFile << ingredientName( i ) << ';' << ingredientUnit( i ) << ';' << 1 + random.below( 1000 ) << '\n';
+        pantryFile << "</IngredientQ>\n";
+
+        std::ofstream recipeFile( path( config, "recipes.dat" ).c_str() );
+        recipeFile << "<RecipeList>\n";
+        for ( size_t i = 0; i < config.recipes; i++ )
+        {
+            recipeFile << "<Recipe>\n<Title>\n"
+                       << adjectives[random.below( countOf( adjectives ) )] << ' '
+                       << dishes[random.below( countOf( dishes ) )] << ' ' << i << "\n</Title>\n<IngredientQ>\n";
+
+            size_t count = 2 + random.below( 7 );
+            for ( size_t j = 0; j < count; j++ )
+            {
+                size_t ing = random.below( config.ingredients );
+                recipeFile << ingredientName( ing ) << ';' << ingredientUnit( ing ) << ';' << 1 + random.below( 500 ) << '\n';
+            }
+
+            recipeFile << "</IngredientQ>\n<Instructions>\n";
+            count = 3 + random.below( 6 );
+            for ( size_t j = 0; j < count; j++ )
+                recipeFile << instructions[random.below( countOf( instructions ) )] << '\n';
+            recipeFile << "</Instructions>\n</Recipe>\n";
+        }
+        recipeFile << "</RecipeList>\n";
+    }
+
+    /// Felszabadítja a keresés eredményeit, és visszaadja a találatok számát
+    size_t release( LinkedList< Result<Recipe>* >& results )
+    {
+        size_t count = results.size();
+        for ( LinkedList< Result<Recipe>* >::Iterator it = results.begin(); it != results.end(); it++ )
+            delete *it;
+        return count;
+    }
+
+    /// Egy lista memóriahasználata (a kimutatás neve, kimutatás)
+    typedef std::pair<std::string, MemoryUsage> MemoryRow;
+
+    /// Kiírja az eredményeket JSON formátumban
+    void report( std::ostream& os, const Config& config, const std::vector<Measurement>& results, const std::vector<MemoryRow>& memory )
+    {
+        os << "{\n"
+           << "  \"benchmark\": \"receptkonyv\",\n"
+           << "  \"scale\": { \"recipes\": " << config.recipes << ", \"ingredients\": " << config.ingredients
+           << ", \"pantry\": " << config.pantry << " },\n"
+           << "  \"ops\": " << config.ops << ",\n"
+           << "  \"seed\": " << config.seed << ",\n"
+           << "  \"results\": [\n";
+
+        for ( size_t i = 0; i < results.size(); i++ )
+        {
+            const Measurement& m = results[i];
+            os << "    { \"name\": \"" << m.name << "\", \"ns\": " << m.ns << ", \"ops\": " << m.ops
+               << ", \"ns_per_op\": " << m.nsPerOp() << ", \"items\": " << m.items;
+            if ( !m.counters.empty() )
+            {
+                os << ", \"counters\": { ";
+                for ( size_t k = 0; k < m.counters.size(); k++ )
+                    os << ( k ? ", " : "" ) << "\"" << m.counters[k].first << "\": " << m.counters[k].second;
+                os << " }";
+            }
+            os << " }" << ( i + 1 < results.size() ? ",\n" : "\n" );
+        }
+
+        os << "  ],\n"
+           << "  \"memory\": [\n";
+
+        for ( size_t i = 0; i < memory.size(); i++ )
+        {
+            const MemoryUsage& m = memory[i].second;
+            os << "    { \"name\": \"" << memory[i].first << "\", \"objects\": " << m.objects
+               << ", \"allocations\": " << m.allocations << ", \"payload\": " << m.payload
+               << ", \"overhead\": " << m.overhead << ", \"nodes\": " << m.nodes
+               << ", \"fragmentation\": " << m.fragmentation << ", \"total\": " << m.total() << " }"
+               << ( i + 1 < memory.size() ? ",\n" : "\n" );
+        }
+
+        os << "  ]\n}" << endl;
+    }
+
+    bool parseArgs( int argc, char* argv[], Config& config )
+    {
+        for ( int i = 1; i < argc; i++ )
+        {
+            std::string arg = argv[i];
+            if ( i + 1 >= argc ) { cerr << "Hianyzo ertek: " << arg << endl; return false; }
+
+            std::string value = argv[++i];
+            try {
+                if ( arg == "--scale" ) config.recipes = std::stoul( value );
+                else if ( arg == "--ingredients" ) config.ingredients = std::stoul( value );
+                else if ( arg == "--pantry" ) config.pantry = std::stoul( value );
+                else if ( arg == "--ops" ) config.ops = std::stoul( value );
+                else if ( arg == "--seed" ) config.seed = std::stoull( value );
+                else if ( arg == "--dir" ) config.dir = value;
+                else if ( arg == "--out" ) config.out = value;
+                else { cerr << "Ismeretlen kapcsolo: " << arg << endl; return false; }
+            } catch ( std::exception& ex ) { cerr << "Hibas szam! Kapott input: \"" << value << "\"" << endl; return false; }
+        }
+
+        if ( config.recipes < 1 ) { cerr << "A receptek szama legalabb 1 kell legyen!" << endl; return false; }
+
+        // Alapértelmezés szerint a szótár a receptek számához igazodik
+        if ( config.ingredients == 0 ) config.ingredients = std::min<size_t>( std::max<size_t>( config.recipes / 10, 50 ), 10000 );
+        if ( config.pantry == 0 ) config.pantry = config.ingredients / 2;
+        if ( config.pantry > config.ingredients ) config.pantry = config.ingredients;
+        return true;
+    }
+}
+
+
+int main( int argc, char* argv[] )
+{
+    Config config;
+    if ( !parseArgs( argc, argv, config ) ) return 1;
+
+    mkdir( config.dir.c_str(), 0755 );
+    cerr << "[Adatfajlok generalasa: " << config.recipes << " recept]" << endl;
+    generate( config );
+
+    std::vector<Measurement> results;
+    std::vector<MemoryRow> memory;
+    Random random( config.seed ^ 0x9e3779b97f4a7c15ULL );
+
+    LinkedList<Recipe> recipeList;
+    LinkedList<Ingredient> ingredientList;
+    LinkedList<IngredientQ> pantryList;
+    TextCodec codec;
+
+    try {
+        // Beolvasás
+        {
+            Stopwatch watch;
+            File::Reader reader( path( config, "recipes.dat" ).c_str() );
+            reader.read();
+            reader.parseRecipe( recipeList, codec );
+            results.push_back( Measurement( "reader_load_recipes", watch.elapsed(), 1, recipeList.size() ) );
+        }
+        {
+            Stopwatch watch;
+            File::Reader reader( path( config, "ingredients.dat" ).c_str() );
+            reader.read();
+            reader.parseIngredient( ingredientList );
+            results.push_back( Measurement( "reader_load_ingredients", watch.elapsed(), 1, ingredientList.size() ) );
+        }
+        {
+            Stopwatch watch;
+            File::Reader reader( path( config, "pantry.dat" ).c_str() );
+            reader.read();
+            reader.parseIngredientQ( pantryList );
+            results.push_back( Measurement( "reader_load_pantry", watch.elapsed(), 1, pantryList.size() ) );
+        }
+
+        // Memóriahasználat a betöltés után (a kimutatás bejárásának ideje is mérve)
+        {
+            Stopwatch watch;
+            memory.push_back( MemoryRow( "recipes", recipeList.memoryUsage() ) );
+            memory.push_back( MemoryRow( "ingredients", ingredientList.memoryUsage() ) );
+            memory.push_back( MemoryRow( "pantry", pantryList.memoryUsage() ) );
+            results.push_back( Measurement( "memory_usage", watch.elapsed(), 1, recipeList.size() + ingredientList.size() + pantryList.size() ) );
+        }
+
+        // A receptek hozzávalói és a kamra tömör rekordokban (a listás tárolással összehasonlítva)
+        {
+            MemoryUsage listed;
+            size_t rows = 0;
+            for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+            {
+                listed += it->getIngredients()->memoryUsage();
+                rows += it->getIngredients()->size();
+            }
+
+            Stopwatch watch;
+            IngredientTable compact;
+            compact.reserve( rows );
+            for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+                compact.addAll( *it->getIngredients() );
+            results.push_back( Measurement( "compact_ingredients_build", watch.elapsed(), 1, compact.size() ) );
+
+            IngredientTable compactPantry;
+            compactPantry.addAll( pantryList );
+            memory.push_back( MemoryRow( "recipe_ingredients", listed ) );
+            memory.push_back( MemoryRow( "recipe_ingredients_compact", memoryUsageOf( compact ) ) );
+            memory.push_back( MemoryRow( "pantry_compact", memoryUsageOf( compactPantry ) ) );
+        }
+
+        // Nyers blokkolvasás a két aszinkron háttérrel (io_uring, illetve szálkészlet + pread)
+        for ( int b = 0; b < 2; b++ )
+        {
+            File::AsyncIO io( b == 0 ? File::AsyncIO::URING : File::AsyncIO::THREADS );
+            int fd = open( path( config, "recipes.dat" ).c_str(), O_RDONLY );
+            if ( fd < 0 ) throw std::ifstream::failure( "recipes.dat" );
+
+            File::AsyncIO::Buffer slots[File::AsyncIO::DEPTH];
+            unsigned long long tickets[File::AsyncIO::DEPTH];
+            for ( int i = 0; i < File::AsyncIO::DEPTH; i++ ) slots[i].allocate( File::AsyncIO::BLOCK );
+
+            Stopwatch watch;
+            long long total = 0, blocks = 0, submitted = 0;
+            bool eof = false;
+            for ( ; submitted < File::AsyncIO::DEPTH; submitted++ )
+                tickets[submitted] = io.read( fd, slots[submitted].data(), File::AsyncIO::BLOCK, submitted * File::AsyncIO::BLOCK );
+            for ( long long k = 0; k < submitted; k++ )
+            {
+                long long n = io.wait( tickets[k % File::AsyncIO::DEPTH] );
+                if ( n <= 0 ) eof = true;
+                else { total += n; blocks++; }
+                if ( !eof )
+                {
+                    tickets[k % File::AsyncIO::DEPTH] = io.read( fd, slots[k % File::AsyncIO::DEPTH].data(), File::AsyncIO::BLOCK, submitted * File::AsyncIO::BLOCK );
+                    submitted++;
+                }
+            }
+            results.push_back( Measurement( std::string( "async_read_" ) + io.backendName(), watch.elapsed(), blocks, total ) );
+            close( fd );
+        }
+
+        // Mentés - külön fájlokba, hogy a generált adat megmaradjon
+        {
+            Stopwatch watch;
+            File::Writer writer( path( config, "recipes.out.dat" ).c_str() );
+            writer.parse( recipeList, codec );
+            writer.write();
+            results.push_back( Measurement( "writer_save_recipes", watch.elapsed(), 1, recipeList.size() ) );
+        }
+        {
+            // Ugyanez egy szálon (a párhuzamos szeletelés nyereségéhez)
+            Stopwatch watch;
+            File::Writer writer( path( config, "recipes.out.dat" ).c_str() );
+            writer.parse( recipeList, codec, 1 );
+            writer.write();
+            results.push_back( Measurement( "writer_save_recipes_1thread", watch.elapsed(), 1, recipeList.size() ) );
+        }
+        {
+            // Ellenőrzőösszeg a mentett fájl teljes tartalmán: crc32 utasítással (ha van), illetve táblákkal
+            std::ifstream saved( path( config, "recipes.out.dat" ).c_str(), std::ios::binary );
+            std::string bytes( ( std::istreambuf_iterator<char>( saved ) ), std::istreambuf_iterator<char>() );
+
+            // Az elemszám a két módszer egyezése esetén a fájl mérete
+            unsigned int hardware = 0, table = 0;
+            Stopwatch fast;
+            for ( size_t q = 0; q < 10; q++ ) hardware = File::Crc32c::extend( ~0u, bytes.data(), bytes.size() );
+            long long fastTime = fast.elapsed();
+
+            Stopwatch slow;
+            for ( size_t q = 0; q < 10; q++ ) table = File::Crc32c::extendTable( ~0u, bytes.data(), bytes.size() );
+            long long slowTime = slow.elapsed();
+
+            size_t agreed = hardware == table ? bytes.size() : 0;
+            results.push_back( Measurement( File::Crc32c::hardware() ? "crc32c_sse42" : "crc32c_fallback", fastTime, 10 * bytes.size(), agreed ) );
+            results.push_back( Measurement( "crc32c_table", slowTime, 10 * bytes.size(), agreed ) );
+        }
+        {
+            // Lusta betöltés (a tömörített mentésből): az instrukciók helyett csak a bájt tartományukat jegyezzük fel
+            LinkedList<Recipe> lazyList;
+            TextCodec lazyCodec;
+            Stopwatch watch;
+            File::Reader reader( path( config, "recipes.out.dat" ).c_str(), true );
+            reader.read();
+            reader.parseRecipe( lazyList, lazyCodec );
+            results.push_back( Measurement( "reader_load_recipes_lazy", watch.elapsed(), 1, lazyList.size() ) );
+
+            std::vector<const Recipe*> recipes;
+            for ( LinkedList<Recipe>::Iterator it = lazyList.begin(); it != lazyList.end(); it++ )
+                recipes.push_back( &*it );
+
+            size_t lines = 0;
+            std::ifstream source( path( config, "recipes.out.dat" ).c_str(), std::ios::binary );
+            Stopwatch fetch;
+            for ( size_t i = 0; i < config.ops && !recipes.empty(); i++ )
+            {
+                LinkedList<String> instructions;
+                File::Reader::readRange( source, recipes[random.below( recipes.size() )]->getInstructionRange(), instructions );
+                lines += instructions.size();
+            }
+            results.push_back( Measurement( "lazy_fetch_instructions", fetch.elapsed(), config.ops, lines ) );
+        }
+        {
+            Stopwatch watch;
+            File::Writer writer( path( config, "ingredients.out.dat" ).c_str() );
+            writer.parse( ingredientList );
+            writer.write();
+            results.push_back( Measurement( "writer_save_ingredients", watch.elapsed(), 1, ingredientList.size() ) );
+        }
+        {
+            Stopwatch watch;
+            File::Writer writer( path( config, "pantry.out.dat" ).c_str() );
+            writer.parse( pantryList );
+            writer.write();
+            results.push_back( Measurement( "writer_save_pantry", watch.elapsed(), 1, pantryList.size() ) );
+        }
+    } catch ( std::ios_base::failure& ex ) { cerr << ex.what() << endl; return 1; }
+
+    // Keresések
+    {
+        Stopwatch watch;
+        LinkedList< Result<Recipe>* > found = recipeList.search( title_contains( String( "csirke" ) ) );
+        size_t hits = release( found );
+        results.push_back( Measurement( "search_title_contains", watch.elapsed(), 1, hits ) );
+    }
+    {
+        LinkedList<Ingredient> query;
+        query.push( Ingredient( String( ingredientName( 0 ).c_str() ), String() ) );
+
+        Stopwatch watch;
+        LinkedList< Result<Recipe>* > found = recipeList.search( ingredient_contains( query ) );
+        size_t hits = release( found );
+        results.push_back( Measurement( "search_ingredient_contains_1", watch.elapsed(), 1, hits ) );
+    }
+    {
+        LinkedList<Ingredient> query;
+        query.push( Ingredient( String( ingredientName( 0 ).c_str() ), String() ) );
+        query.push( Ingredient( String( ingredientName( 1 ).c_str() ), String() ) );
+
+        Stopwatch watch;
+        LinkedList< Result<Recipe>* > found = recipeList.search( ingredient_contains( query ) );
+        size_t hits = release( found );
+        results.push_back( Measurement( "search_ingredient_contains_2", watch.elapsed(), 1, hits ) );
+    }
+
+    // Ismételt keresés a gyorsítótáron keresztül (az első hívás bejárja a listát, a többi a gyorsítótárból jön)
+    {
+        LruCache<std::string, std::vector<int> > cache( 256, 1 << 16 );
+        size_t hits = 0;
+
+        Stopwatch watch;
+        for ( size_t i = 0; i < config.ops; i++ )
+        {
+            const std::vector<int>* cached = cache.find( "T:csirke", recipeList.version() );
+            if ( cached == nullptr )
+            {
+                std::vector<int> orders;
+                LinkedList< Result<Recipe>* > found = recipeList.search( title_contains( String( "csirke" ) ) );
+                for ( LinkedList< Result<Recipe>* >::Iterator it = found.begin(); it != found.end(); it++ )
+                    orders.push_back( (*it)->getOrder() );
+                release( found );
+                cache.insert( "T:csirke", recipeList.version(), orders, orders.size() + 1 );
+                hits += orders.size();
+            }
+            else hits += cached->size();
+        }
+        results.push_back( Measurement( "search_title_cached", watch.elapsed(), config.ops, config.ops ? hits / config.ops : 0 ) );
+    }
+
+    // Hasonló receptek (MinHash + LSH)
+    {
+        SimilarityIndex index;
+        std::vector<Handle> ids;
+
+        Stopwatch watch;
+        unsigned int i = 0;
+        for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++, i++ )
+        {
+            ids.push_back( Handle( i, 0 ) );
+            index.update( ids.back(), *it );
+        }
+        results.push_back( Measurement( "similarity_build", watch.elapsed(), ids.size(), index.size() ) );
+
+        size_t hits = 0;
+        Stopwatch query;
+        for ( size_t q = 0; q < config.ops && !ids.empty(); q++ )
+            hits += index.similar( ids[random.below( ids.size() )], 5 ).size();
+        results.push_back( Measurement( "similarity_top5", query.elapsed(), config.ops, hits ) );
+    }
+
+    // Összetett keresés: cím-részlet ÉS hozzávaló ÉS legfeljebb 6 lépés - terv szerint, illetve teljes bejárással
+    {
+        IngredientIndex index;
+        std::vector<const Recipe*> byId;
+
+        Stopwatch watch;
+        unsigned int i = 0;
+        for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++, i++ )
+        {
+            index.update( Handle( i, 0 ), *it );
+            byId.push_back( &*it );
+        }
+        results.push_back( Measurement( "ingredient_index_build", watch.elapsed(), byId.size(), index.size() ) );
+
+        /// Azonosító -> recept a fenti számozással
+        struct Resolve
+        {
+            const std::vector<const Recipe*>& recipes;
+            const Recipe* operator()( const Handle& id ) const { return id.index < recipes.size() ? recipes[id.index] : nullptr; }
+        };
+        /// Lépések száma (a bench a receptet teljesen betölti)
+        struct Steps
+        {
+            int operator()( const Recipe& recipe ) const { return recipe.getInstructions()->size(); }
+        };
+
+        Query query;
+        query.title = "csirke";
+        query.ingredients.push_back( ingredientName( 0 ) );
+        query.maxSteps = 6;
+
+        QueryPlanner planner;
+        size_t hits = 0, examined = 0;
+        Stopwatch planned;
+        for ( size_t q = 0; q < config.ops; q++ )
+        {
+            QueryPlanner::Outcome outcome = planner.execute( planner.plan( query, recipeList.size(), index, false ),
+                                                             recipeList, index, pantryList, Resolve{ byId }, Steps() );
+            hits = outcome.matches.size();
+            examined = outcome.examined;
+        }
+        results.push_back( Measurement( "search_combined_planned", planned.elapsed(), config.ops, hits ).with( "examined", examined ) );
+
+        // Ugyanez terv nélkül: a feltételek a megadás sorrendjében, a teljes listán
+        QueryPlanner::Plan unplanned;
+        unplanned.total = recipeList.size();
+        unplanned.residuals.push_back( QueryPlanner::Filter( QueryPlanner::TITLE, query.title, 1.0, 1.0 ) );
+        for ( size_t k = 0; k < query.ingredients.size(); k++ )
+            unplanned.residuals.push_back( QueryPlanner::Filter( QueryPlanner::INGREDIENT, query.ingredients[k], 1.0, 1.0 ) );
+        unplanned.residuals.push_back( QueryPlanner::Filter( QueryPlanner::STEPS, std::string(), 1.0, 1.0 ) );
+        unplanned.residuals.back().limit = query.maxSteps;
+
+        Stopwatch full;
+        for ( size_t q = 0; q < config.ops; q++ )
+        {
+            QueryPlanner::Outcome outcome = planner.execute( unplanned, recipeList, index, pantryList, Resolve{ byId }, Steps() );
+            hits = outcome.matches.size();
+            examined = outcome.examined;
+        }
+        results.push_back( Measurement( "search_combined_scan", full.elapsed(), config.ops, hits ).with( "examined", examined ) );
+    }
+
+    // Találatok rangsorolása: az első oldal (20 legjobb) korlátos kupaccal, illetve az összes pontozása és rendezése
+    {
+        Relevance relevance( "e", std::vector<std::string>( 1, ingredientName( 0 ) ), pantryList );
+        std::vector<const Recipe*> matches;
+        for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+            if ( relevance.titleScore( *it ) > 0.0 ) matches.push_back( &*it );
+
+        size_t shown = 0;
+        Stopwatch top;
+        for ( size_t q = 0; q < config.ops; q++ )
+        {
+            TopK<Ranked, more_relevant> best( 20 );
+            for ( size_t i = 0; i < matches.size(); i++ )
+                best.push( Ranked( relevance.score( *matches[i] ), (int)i, Handle( (unsigned int)i, 0 ) ) );
+            shown = best.take().size();
+        }
+        results.push_back( Measurement( "rank_top20", top.elapsed(), config.ops, shown ) );
+
+        Stopwatch sorted;
+        for ( size_t q = 0; q < config.ops; q++ )
+        {
+            std::vector<Ranked> all;
+            for ( size_t i = 0; i < matches.size(); i++ )
+                all.push_back( Ranked( relevance.score( *matches[i] ), (int)i, Handle( (unsigned int)i, 0 ) ) );
+            std::sort( all.begin(), all.end(), more_relevant() );
+            shown = all.size();
+        }
+        results.push_back( Measurement( "rank_full_sort", sorted.elapsed(), config.ops, shown ) );
+    }
+
+    // Lemezes receptkönyv (B+fa) a memóriánál kisebb, 256 KB-os lapkerettel: felvétel, azonosító szerinti
+    // keresés és a cím eleje alapján bejárás
+    {
+        std::string storePath = path( config, "recipes.store" );
+        unlink( storePath.c_str() );
+        File::RecipeStore store( String( storePath.c_str() ), 256 << 10 );
+
+        std::vector<Handle> ids;
+        Stopwatch insert;
+        for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+            ids.push_back( store.insert( *it ) );
+        store.flush();
+        results.push_back( Measurement( "store_insert", insert.elapsed(), ids.size(), ids.size() ).with( "pages", store.buffers().pages() ) );
+
+        size_t found = 0;
+        Stopwatch find;
+        for ( size_t q = 0; q < config.ops && !ids.empty(); q++ )
+        {
+            Recipe recipe;
+            if ( store.find( ids[random.below( ids.size() )], recipe ) ) found++;
+        }
+        results.push_back( Measurement( "store_find", find.elapsed(), config.ops, found ) );
+
+        size_t scanned = 0;
+        Stopwatch scan;
+        for ( size_t q = 0; q < config.ops; q++ )
+        {
+            std::string prefix( 1, (char)( 'a' + random.below( 26 ) ) );
+            for ( File::RecipeStore::TitleCursor it = store.titles( prefix ); it.valid(); ++it ) scanned++;
+        }
+        results.push_back( Measurement( "store_prefix_scan", scan.elapsed(), config.ops, scanned ) );
+    }
+
+    // Elgépelés-tűrő alapanyag keresés (BK-fa)
+    {
+        BKTree names;
+        Stopwatch watch;
+        for ( LinkedList<Ingredient>::Iterator it = ingredientList.begin(); it != ingredientList.end(); it++ )
+            names.insert( it->getName().c_str() );
+        results.push_back( Measurement( "bktree_build", watch.elapsed(), ingredientList.size(), names.size() ) );
+
+        size_t hits = 0;
+        Stopwatch query;
+        for ( size_t i = 0; i < config.ops; i++ )
+        {
+            // Egy betű elhagyása a név közepéről
+            std::string typo = ingredientName( random.below( config.ingredients ) );
+            typo.erase( typo.size() / 2, 1 );
+            if ( !names.find( typo, 2 ).empty() ) hits++;
+        }
+        results.push_back( Measurement( "bktree_find_k2", query.elapsed(), config.ops, hits ) );
+    }
+
+    // Instrukciók tömörítése (szótár tanítás, kódolás, visszafejtés)
+    {
+        std::vector<std::string> plain;
+        for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+            for ( LinkedList<String>::Iterator line = it->getInstructions()->begin(); line != it->getInstructions()->end(); line++ )
+                plain.push_back( codec.decode( line->c_str() ) );
+
+        TextCodec trained;
+        Stopwatch train;
+        trained.train( plain );
+        results.push_back( Measurement( "codec_train", train.elapsed(), plain.size(), trained.size() ) );
+
+        size_t raw = 0, packed = 0;
+        std::vector<std::string> encoded;
+        Stopwatch encode;
+        for ( size_t i = 0; i < plain.size(); i++ )
+        {
+            encoded.push_back( trained.encode( plain[i] ) );
+            raw += plain[i].size();
+            packed += encoded.back().size();
+        }
+        results.push_back( Measurement( "codec_encode", encode.elapsed(), raw, packed ) );
+
+        size_t decoded = 0;
+        Stopwatch decode;
+        for ( size_t i = 0; i < encoded.size(); i++ ) decoded += trained.decode( encoded[i] ).size();
+        results.push_back( Measurement( "codec_decode", decode.elapsed(), packed, decoded ) );
+    }
+
+    // Bevásárlólista az összes receptre (egy szálon, illetve a hardver szerinti szálszámmal)
+    {
+        std::vector<const Recipe*> selected;
+        for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+            selected.push_back( &*it );
+
+        ShoppingList missing;
+        Stopwatch single;
+        missing.build( selected, pantryList, 1 );
+        results.push_back( Measurement( "shopping_list_1thread", single.elapsed(), selected.size(), missing.size() ) );
+
+        Stopwatch parallel;
+        missing.build( selected, pantryList );
+        results.push_back( Measurement( "shopping_list_auto", parallel.elapsed(), selected.size(), missing.size() ) );
+    }
+
+    // Pillanatkép-olvasás (RCU): egy, illetve a hardver szerinti számú olvasó szál, miközben egy író
+    // folyamatosan új változatot tesz közzé - az olvasók áteresztőképessége a szálszámmal nő
+    {
+        std::vector<Catalog::Entry> entries;
+        unsigned int i = 0;
+        for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++, i++ )
+        {
+            std::shared_ptr<Recipe> copy = std::make_shared<Recipe>( *it );
+            copy->setId( Handle( i, 0 ) );
+            entries.push_back( copy );
+        }
+
+        std::shared_ptr<const SimilarityIndex> similar = std::make_shared<SimilarityIndex>();
+        Rcu<Catalog> published;
+        unsigned int threads = std::max( 1u, std::thread::hardware_concurrency() );
+        size_t reads = config.ops * 1000;
+
+        for ( unsigned int round = 0; round < 2; round++ )
+        {
+            unsigned int readers = round == 0 ? 1 : threads;
+            std::atomic<unsigned int> running( readers );
+            std::atomic<size_t> hits( 0 );
+            size_t publishes = 0;
+
+            Stopwatch watch;
+            std::vector<std::thread> pool;
+            for ( unsigned int t = 0; t < readers; t++ )
+                pool.push_back( std::thread( [&, t]() {
+                    Random local( config.seed + t + 1 );
+                    size_t found = 0;
+                    for ( size_t r = 0; r < reads && !entries.empty(); r++ )
+                    {
+                        Rcu<Catalog>::Reader view( published );
+                        if ( view.get() != nullptr && view->find( Handle( (unsigned int)local.below( entries.size() ), 0 ) ) != nullptr ) found++;
+                    }
+                    hits += found;
+                    running--;
+                } ) );
+
+            // Az író a közös receptekből építi újra a pillanatképet, amíg az olvasók futnak
+            do {
+                Catalog* next = new Catalog( codec, true );
+                next->reserve( entries.size() );
+                for ( size_t e = 0; e < entries.size(); e++ ) next->push( entries[e] );
+                next->setSimilarIndex( similar );
+                published.publish( next );
+                publishes++;
+            } while ( running > 0 );
+
+            for ( size_t t = 0; t < pool.size(); t++ ) pool[t].join();
+            results.push_back( Measurement( round == 0 ? "rcu_read_1thread" : "rcu_read_auto", watch.elapsed(), reads * readers, publishes ) );
+        }
+    }
+
+    // Kiírás fájlba (pufferelt, oldalanként egy írás)
+    {
+        std::ofstream listing( path( config, "listing.out.txt" ).c_str() );
+        Stopwatch watch;
+        recipeList.printOrderedList( listing );
+        listing.flush();
+        results.push_back( Measurement( "render_recipe_list", watch.elapsed(), 1, recipeList.size() ) );
+    }
+    {
+        std::ofstream listing( path( config, "listing.out.txt" ).c_str() );
+        size_t pages = 0;
+        Stopwatch watch;
+        Pager<Ingredient> pager( ingredientList, 20 );
+        for ( ; pager.hasNext(); pages++ ) pager.next( listing );
+        results.push_back( Measurement( "render_ingredient_pages", watch.elapsed(), pages, ingredientList.size() ) );
+    }
+
+    // Listaműveletek az alapanyaglistán
+    {
+        Stopwatch watch;
+        for ( size_t i = 0; i < config.ops; i++ )
+        {
+            std::stringstream name;
+            name << "bench_push_" << i;
+            ingredientList.push( Ingredient( String( name.str().c_str() ), String( "g" ) ) );
+        }
+        results.push_back( Measurement( "list_push", watch.elapsed(), config.ops, ingredientList.size() ) );
+    }
+    {
+        size_t found = 0;
+        Stopwatch watch;
+        for ( size_t i = 0; i < config.ops; i++ )
+        {
+            Ingredient probe( String( ingredientName( random.below( config.ingredients ) ).c_str() ), String() );
+            if ( ingredientList.indexOf( probe ) != -1 ) found++;
+        }
+        results.push_back( Measurement( "list_indexOf", watch.elapsed(), config.ops, found ) );
+    }
+    {
+        size_t popped = 0;
+        Stopwatch watch;
+        for ( size_t i = 0; i < config.ops && !ingredientList.empty(); i++, popped++ )
+            ingredientList.pop( (int)random.below( ingredientList.size() ) );
+        results.push_back( Measurement( "list_pop", watch.elapsed(), popped, ingredientList.size() ) );
+    }
+
+    if ( config.out.empty() )
+    {
+        report( cout, config, results, memory );
+    }
+    else
+    {
+        std::ofstream file( config.out.c_str() );
+        if ( !file.is_open() ) { cerr << "Hiba tortent a(z) \"" << config.out << "\" megnyitasa kozben!" << endl; return 1; }
+        report( file, config, results, memory );
+    }
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * \file bktree.cpp
+ *
+ * Ez a fájl tartalmazza a BKTree osztály megvalósítását
+ */
+
+#include <algorithm>
+#include "bktree.h"
+#include "memtrace.h"
+
+namespace
+{
+    /// Találatok rendezése távolság, azon belül abc szerint
+    bool closer( const Components::BKTree::Match& a, const Components::BKTree::Match& b )
+    {
+        if ( a.second != b.second ) return a.second < b.second;
+        return a.first < b.first;
+    }
+}
+
+unsigned int Components::BKTree::distance( const std::string& a, const std::string& b ) {
+    // Két sorral számolt dinamikus programozás, O(|a| * |b|) idő, O(|b|) memória
+    std::vector<unsigned int> prev( b.size() + 1 ), curr( b.size() + 1 );
+    for ( size_t j = 0; j <= b.size(); j++ ) prev[j] = j;
+
+    for ( size_t i = 1; i <= a.size(); i++ )
+    {
+        curr[0] = i;
+        for ( size_t j = 1; j <= b.size(); j++ )
+        {
+            unsigned int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            curr[j] = std::min( std::min( prev[j] + 1, curr[j - 1] + 1 ), prev[j - 1] + cost );
+        }
+        prev.swap( curr );
+    }
+
+    return prev[b.size()];
+}
+
+Components::BKTree::Node* Components::BKTree::findNode( const std::string& word ) const {
+    Node* node = root;
+    while ( node != nullptr )
+    {
+        unsigned int d = distance( word, node->word );
+        if ( d == 0 ) return node;
+
+        std::map<unsigned int, Node*>::const_iterator child = node->children.find( d );
+        node = child != node->children.end() ? child->second : nullptr;
+    }
+    return nullptr;
+}
+
+void Components::BKTree::insert( const std::string& word ) {
+    if ( root == nullptr ) { root = new Node( word ); live++; return; }
+
+    Node* node = root;
+    while ( true )
+    {
+        unsigned int d = distance( word, node->word );
+        if ( d == 0 )
+        {
+            if ( node->count++ == 0 ) { live++; dead--; }
+            return;
+        }
+
+        std::map<unsigned int, Node*>::iterator child = node->children.find( d );
+        if ( child == node->children.end() )
+        {
+            node->children[d] = new Node( word );
+            live++;
+            return;
+        }
+        node = child->second;
+    }
+}
+
+bool Components::BKTree::remove( const std::string& word ) {
+    Node* node = findNode( word );
+    if ( node == nullptr || node->count == 0 ) return false;
+
+    if ( --node->count == 0 )
+    {
+        live--;
+        dead++;
+        if ( dead > live ) rebuild();
+    }
+    return true;
+}
+
+bool Components::BKTree::contains( const std::string& word ) const {
+    Node* node = findNode( word );
+    return node != nullptr && node->count > 0;
+}
+
+std::vector<Components::BKTree::Match> Components::BKTree::find( const std::string& word, unsigned int k ) const {
+    std::vector<Match> result;
+    if ( root == nullptr ) return result;
+
+    std::vector<const Node*> stack( 1, root );
+    while ( !stack.empty() )
+    {
+        const Node* node = stack.back();
+        stack.pop_back();
+
+        unsigned int d = distance( word, node->word );
+        if ( d <= k && node->count > 0 ) result.push_back( Match( node->word, d ) );
+
+        // Csak a [d-k, d+k] távolságú gyerekek tartalmazhatnak találatot
+        unsigned int low = d > k ? d - k : 0;
+        std::map<unsigned int, Node*>::const_iterator child = node->children.lower_bound( low );
+        for ( ; child != node->children.end() && child->first <= d + k; child++ ) stack.push_back( child->second );
+    }
+
+    std::sort( result.begin(), result.end(), closer );
+    return result;
+}
+
+Components::BKTree::BKTree( const BKTree& other ) :root( nullptr ), live( other.live ), dead( other.dead ) {
+    if ( other.root == nullptr ) return;
+
+    // Iteratív másolás (eredeti csúcs, másolat) párokkal, mint a felszabadításnál
+    root = new Node( other.root->word );
+    std::vector<std::pair<const Node*, Node*> > stack( 1, std::make_pair( other.root, root ) );
+    while ( !stack.empty() )
+    {
+        const Node* from = stack.back().first;
+        Node* to = stack.back().second;
+        stack.pop_back();
+
+        to->count = from->count;
+        for ( std::map<unsigned int, Node*>::const_iterator child = from->children.begin(); child != from->children.end(); child++ )
+        {
+            Node* copy = new Node( child->second->word );
+            to->children[child->first] = copy;
+            stack.push_back( std::make_pair( child->second, copy ) );
+        }
+    }
+}
+void Components::BKTree::destroy( Node* node ) {
+    if ( node == nullptr ) return;
+
+    std::vector<Node*> stack( 1, node );
+    while ( !stack.empty() )
+    {
+        Node* current = stack.back();
+        stack.pop_back();
+        for ( std::map<unsigned int, Node*>::iterator child = current->children.begin(); child != current->children.end(); child++ )
+            stack.push_back( child->second );
+        delete current;
+    }
+}
+
+void Components::BKTree::rebuild() {
+    std::vector<std::pair<std::string, unsigned int> > words;
+    if ( root != nullptr )
+    {
+        std::vector<Node*> stack( 1, root );
+        while ( !stack.empty() )
+        {
+            Node* current = stack.back();
+            stack.pop_back();
+            if ( current->count > 0 ) words.push_back( std::make_pair( current->word, current->count ) );
+            for ( std::map<unsigned int, Node*>::iterator child = current->children.begin(); child != current->children.end(); child++ )
+                stack.push_back( child->second );
+        }
+    }
+
+    clear();
+    for ( size_t i = 0; i < words.size(); i++ )
+    {
+        insert( words[i].first );
+        findNode( words[i].first )->count = words[i].second;
+    }
+}
+
+void Components::BKTree::clear() {
+    destroy( root );
+    root = nullptr;
+    live = 0;
+    dead = 0;
+}
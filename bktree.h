@@ -0,0 +1,107 @@
+#ifndef NHF4_BKTREE_H
+#define NHF4_BKTREE_H
+/**
+ * \file bktree.h
+ *
+ * Ez a fájl tartalmazza az elgépelés-tűrő kereséshez használt BKTree osztályt
+ */
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "memtrace.h"
+
+
+namespace Components
+{
+    /**
+     * BKTree osztály
+     * Burkhard-Keller fa szavakra, Levenshtein-távolság szerint
+     * Minden csúcs gyerekei a csúcs szavától mért távolság szerint vannak rendezve. Egy legfeljebb k
+     * távolságú keresésnél a háromszög-egyenlőtlenség miatt csak a [d-k, d+k] távolságú gyerekeket
+     * kell bejárni, így a szókincsnek csak egy kis részét kell megvizsgálni.
+     * A szavakat előfordulásszámmal tároljuk (pl. ugyanaz a hozzávaló több receptben); a 0-ra csökkent
+     * szavak csúcsa megmarad (a fa szerkezete miatt), de a keresés kihagyja őket. Ha az ilyen csúcsok
+     * száma meghaladja az élő szavakét, a fát újraépítjük.
+     * A távolság bájtokon értendő, így egy ékezetes (UTF-8) betű cseréje 2 lépésnek számít.
+     */
+    class BKTree
+    {
+    public:
+        /// Egy találat: a szó és a távolsága a keresett szótól
+        typedef std::pair<std::string, unsigned int> Match;
+
+    private:
+        /**
+         * Node osztály
+         * Egy szó, az előfordulásainak száma, és a gyerekek távolság szerint
+         */
+        struct Node
+        {
+            std::string word;                           /// Szó
+            unsigned int count;                         /// Előfordulások száma (0 = törölt)
+            std::map<unsigned int, Node*> children;     /// Távolság -> gyerek
+
+            explicit Node( const std::string& w ) :word( w ), count( 1 ) {};
+        };
+
+        Node* root;         /// Gyökér
+        size_t live;        /// Élő (count > 0) szavak száma
+        size_t dead;        /// Törölt (count = 0) csúcsok száma
+
+        BKTree& operator=( const BKTree& );
+
+        /// A megadott szó csúcsa, ha nincs ilyen akkor nullptr
+        Node* findNode( const std::string& word ) const;
+
+        /// Felszabadítja a részfát
+        static void destroy( Node* node );
+
+        /// Újraépíti a fát az élő szavakból (a törölt csúcsok eltávolítása)
+        void rebuild();
+
+    public:
+        /// Default konstruktor
+        BKTree() :root( nullptr ), live( 0 ), dead( 0 ) {};
+
+        /// Másoló konstruktor - a fa mély másolata (a törölt csúcsokkal együtt)
+        /// @param other - másolandó fa
+        BKTree( const BKTree& other );
+
+        /// Destruktor
+        ~BKTree() { destroy( root ); }
+
+        /// Levenshtein-távolság (beszúrás, törlés, csere egyaránt 1)
+        /// @param a - első szó
+        /// @param b - második szó
+        /// @return unsigned int - távolság
+        static unsigned int distance( const std::string& a, const std::string& b );
+
+        /// Különböző élő szavak száma
+        size_t size() const { return live; }
+
+        /// Szó felvétele (ha már szerepel, az előfordulásszáma nő)
+        /// @param word - szó
+        void insert( const std::string& word );
+
+        /// Szó egy előfordulásának törlése
+        /// @param word - szó
+        /// @return bool - szerepelt-e
+        bool remove( const std::string& word );
+
+        /// Szerepel-e a szó (pontos egyezés)
+        bool contains( const std::string& word ) const;
+
+        /// A megadott szótól legfeljebb k távolságú szavak
+        /// @param word - keresett szó
+        /// @param k - legnagyobb megengedett távolság
+        /// @return std::vector<Match> - találatok növekvő távolság (azon belül abc) sorrendben
+        std::vector<Match> find( const std::string& word, unsigned int k ) const;
+
+        /// Minden szó törlése
+        void clear();
+    };
+}
+
+#endif // NHF4_BKTREE_H
@@ -0,0 +1,359 @@
+/**
+ * \file btree.cpp
+ *
+ * Ez a fájl tartalmazza a BPlusTree osztály megvalósítását
+ *
+ * Lapformátum: 1 bájt típus (1 = levél, 2 = belső lap), 1 bájt kitöltés, 2 bájt bejegyzésszám,
+ * 4 bájt link (következő levél, illetve a legkisebb kulcsok részfája), majd a bejegyzések egymás után:
+ *  - levélben:     2 bájt kulcshossz, 2 bájt értékhossz, kulcs, érték
+ *                  (0xffff értékhossznál az érték helyén a túlcsordulási lánc első lapja és a teljes hossz)
+ *  - belső lapon:  2 bájt kulcshossz, 4 bájt gyereklap, kulcs
+ * Túlcsordulási lap: 4 bájt következő lap, 4 bájt használt hossz, adat.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "btree.h"
+#include "memtrace.h"
+
+namespace
+{
+    enum { HEADER = 8 };                /// A lapfejléc mérete
+    enum { LEAF = 1, INNER = 2 };       /// Laptípusok
+    enum { OVERFLOW_MARK = 0xffff };    /// Túlcsordulási érték jelzése az értékhosszban
+    enum { OVERFLOW_HEADER = 8 };       /// A túlcsordulási lap fejléce
+    enum { OVERFLOW_DATA = File::PageFile::PAGE_SIZE - OVERFLOW_HEADER };
+
+    unsigned int get16( const char* p ) { unsigned short v; std::memcpy( &v, p, sizeof( v ) ); return v; }
+    unsigned int get32( const char* p ) { unsigned int v; std::memcpy( &v, p, sizeof( v ) ); return v; }
+    void put16( char* p, unsigned int v ) { unsigned short s = (unsigned short)v; std::memcpy( p, &s, sizeof( s ) ); }
+    void put32( char* p, unsigned int v ) { std::memcpy( p, &v, sizeof( v ) ); }
+
+    /// Bájtonkénti összehasonlítás (memcmp, a rövidebb előtag a kisebb)
+    /// @return int - negatív, nulla, pozitív
+    int compare( const char* a, size_t length, const std::string& b )
+    {
+        int c = std::memcmp( a, b.data(), std::min( length, b.size() ) );
+        if ( c != 0 ) return c;
+        return length < b.size() ? -1 : ( length > b.size() ? 1 : 0 );
+    }
+}
+
+size_t File::BPlusTree::encodedSize( const Node& node ) {
+    size_t size = HEADER;
+    for ( size_t i = 0; i < node.cells.size(); i++ )
+        size += node.leaf ? 4 + node.cells[i].key.size() + node.cells[i].value.size() : 6 + node.cells[i].key.size();
+    return size;
+}
+
+void File::BPlusTree::decode( const char* page, Node& node ) {
+    node.leaf = page[0] != INNER;
+    node.link = get32( page + 4 );
+    node.cells.resize( get16( page + 2 ) );
+
+    const char* p = page + HEADER;
+    for ( size_t i = 0; i < node.cells.size(); i++ )
+    {
+        Cell& cell = node.cells[i];
+        size_t keyLength = get16( p );
+        if ( node.leaf )
+        {
+            size_t valueLength = get16( p + 2 );
+            cell.overflow = valueLength == OVERFLOW_MARK;
+            if ( cell.overflow ) valueLength = 8;
+
+            cell.key.assign( p + 4, keyLength );
+            cell.value.assign( p + 4 + keyLength, valueLength );
+            p += 4 + keyLength + valueLength;
+        }
+        else
+        {
+            cell.child = get32( p + 2 );
+            cell.key.assign( p + 6, keyLength );
+            p += 6 + keyLength;
+        }
+    }
+}
+
+void File::BPlusTree::encode( const Node& node, char* page ) {
+    std::memset( page, 0, PageFile::PAGE_SIZE );
+    page[0] = node.leaf ? LEAF : INNER;
+    put16( page + 2, (unsigned int)node.cells.size() );
+    put32( page + 4, node.link );
+
+    char* p = page + HEADER;
+    for ( size_t i = 0; i < node.cells.size(); i++ )
+    {
+        const Cell& cell = node.cells[i];
+        put16( p, (unsigned int)cell.key.size() );
+        if ( node.leaf )
+        {
+            put16( p + 2, cell.overflow ? (unsigned int)OVERFLOW_MARK : (unsigned int)cell.value.size() );
+            std::memcpy( p + 4, cell.key.data(), cell.key.size() );
+            std::memcpy( p + 4 + cell.key.size(), cell.value.data(), cell.value.size() );
+            p += 4 + cell.key.size() + cell.value.size();
+        }
+        else
+        {
+            put32( p + 2, cell.child );
+            std::memcpy( p + 6, cell.key.data(), cell.key.size() );
+            p += 6 + cell.key.size();
+        }
+    }
+}
+
+unsigned int File::BPlusTree::childFor( const char* page, const std::string& key ) {
+    unsigned int child = get32( page + 4 );
+    size_t count = get16( page + 2 );
+
+    const char* p = page + HEADER;
+    for ( size_t i = 0; i < count; i++ )
+    {
+        size_t keyLength = get16( p );
+        if ( compare( p + 6, keyLength, key ) > 0 ) break;
+        child = get32( p + 2 );
+        p += 6 + keyLength;
+    }
+    return child;
+}
+
+File::BufferPool::Page File::BPlusTree::leafFor( const std::string& key ) {
+    unsigned int id = pool.root( slot );
+    if ( id == 0 ) return BufferPool::Page();
+
+    BufferPool::Page page = pool.fetch( id );
+    while ( page.data()[0] == INNER )
+        page = pool.fetch( childFor( page.data(), key ) );
+    return page;
+}
+
+bool File::BPlusTree::find( const std::string& key, std::string& value ) {
+    BufferPool::Page page = leafFor( key );
+    if ( !page.valid() ) return false;
+
+    const char* data = page.data();
+    size_t count = get16( data + 2 );
+    const char* p = data + HEADER;
+    for ( size_t i = 0; i < count; i++ )
+    {
+        size_t keyLength = get16( p );
+        size_t valueLength = get16( p + 2 );
+        bool overflow = valueLength == OVERFLOW_MARK;
+        if ( overflow ) valueLength = 8;
+
+        int c = compare( p + 4, keyLength, key );
+        if ( c > 0 ) break;
+        if ( c == 0 )
+        {
+            value.assign( p + 4 + keyLength, valueLength );
+            if ( overflow ) value = readOverflow( value );
+            return true;
+        }
+        p += 4 + keyLength + valueLength;
+    }
+    return false;
+}
+
+bool File::BPlusTree::insert( const std::string& key, const std::string& value ) {
+    if ( key.size() > MAX_KEY ) throw std::length_error( "Tul hosszu kulcs!" );
+
+    Cell cell;
+    cell.key = key;
+    if ( value.size() > MAX_INLINE ) writeOverflow( value, cell );
+    else cell.value = value;
+
+    if ( pool.root( slot ) == 0 )
+    {
+        BufferPool::Page page = pool.allocate();
+        encode( Node(), page.edit() );
+        pool.setRoot( slot, page.id() );
+    }
+
+    Split split;
+    bool replaced = false;
+    unsigned int root = pool.root( slot );
+    if ( insertInto( root, cell, split, replaced ) )
+    {
+        // A gyökér kettévált: új gyökér a két féllel
+        Node node;
+        node.leaf = false;
+        node.link = root;
+        node.cells.resize( 1 );
+        node.cells[0].key = split.key;
+        node.cells[0].child = split.page;
+
+        BufferPool::Page page = pool.allocate();
+        encode( node, page.edit() );
+        pool.setRoot( slot, page.id() );
+    }
+
+    if ( !replaced ) count( 1 );
+    return !replaced;
+}
+
+bool File::BPlusTree::insertInto( unsigned int id, const Cell& cell, Split& split, bool& replaced ) {
+    BufferPool::Page page = pool.fetch( id );
+    Node node;
+    decode( page.data(), node );
+
+    // Az első, a beszúrandónál nagyobb kulcs helye (levélben: nem kisebb)
+    size_t pos = 0;
+    while ( pos < node.cells.size() && ( node.leaf ? node.cells[pos].key < cell.key : node.cells[pos].key <= cell.key ) ) pos++;
+
+    if ( node.leaf )
+    {
+        if ( pos < node.cells.size() && node.cells[pos].key == cell.key )
+        {
+            freeOverflow( node.cells[pos] );
+            node.cells[pos] = cell;
+            replaced = true;
+        }
+        else node.cells.insert( node.cells.begin() + pos, cell );
+    }
+    else
+    {
+        Split below;
+        if ( !insertInto( pos == 0 ? node.link : node.cells[pos - 1].child, cell, below, replaced ) ) return false;
+
+        Cell separator;
+        separator.key = below.key;
+        separator.child = below.page;
+        node.cells.insert( node.cells.begin() + pos, separator );
+    }
+
+    if ( encodedSize( node ) <= PageFile::PAGE_SIZE ) { encode( node, page.edit() ); return false; }
+
+    // Kettévágás nagyjából fele-fele bájtra
+    size_t half = ( encodedSize( node ) - HEADER ) / 2, used = 0, mid = 0;
+    while ( mid + 1 < node.cells.size() && used < half )
+    {
+        used += node.leaf ? 4 + node.cells[mid].key.size() + node.cells[mid].value.size() : 6 + node.cells[mid].key.size();
+        mid++;
+    }
+
+    BufferPool::Page fresh = pool.allocate();
+    Node right;
+    right.leaf = node.leaf;
+    if ( node.leaf )
+    {
+        right.cells.assign( node.cells.begin() + mid, node.cells.end() );
+        right.link = node.link;
+        node.link = fresh.id();
+        split.key = right.cells[0].key;
+    }
+    else
+    {
+        // A középső kulcs felkerül a szülőbe, a gyereke lesz a jobb oldal legkisebb részfája
+        split.key = node.cells[mid].key;
+        right.link = node.cells[mid].child;
+        right.cells.assign( node.cells.begin() + mid + 1, node.cells.end() );
+    }
+    node.cells.resize( mid );
+    split.page = fresh.id();
+
+    encode( right, fresh.edit() );
+    encode( node, page.edit() );
+    return true;
+}
+
+void File::BPlusTree::writeOverflow( const std::string& value, Cell& cell ) {
+    unsigned int first = 0;
+    BufferPool::Page previous;
+    for ( size_t done = 0; done < value.size(); )
+    {
+        BufferPool::Page page = pool.allocate();
+        size_t chunk = std::min( value.size() - done, (size_t)OVERFLOW_DATA );
+
+        char* data = page.edit();
+        put32( data + 4, (unsigned int)chunk );
+        std::memcpy( data + OVERFLOW_HEADER, value.data() + done, chunk );
+        done += chunk;
+
+        if ( previous.valid() ) put32( previous.edit(), page.id() );
+        else first = page.id();
+        previous = page;
+    }
+
+    char ref[8];
+    put32( ref, first );
+    put32( ref + 4, (unsigned int)value.size() );
+    cell.value.assign( ref, sizeof( ref ) );
+    cell.overflow = true;
+}
+
+void File::BPlusTree::freeOverflow( const Cell& cell ) {
+    if ( !cell.overflow ) return;
+
+    unsigned int id = get32( cell.value.data() );
+    while ( id != 0 )
+    {
+        unsigned int next = get32( pool.fetch( id ).data() );
+        pool.release( id );
+        id = next;
+    }
+}
+
+std::string File::BPlusTree::readOverflow( const std::string& ref ) const {
+    std::string value;
+    value.reserve( get32( ref.data() + 4 ) );
+
+    unsigned int id = get32( ref.data() );
+    while ( id != 0 )
+    {
+        BufferPool::Page page = pool.fetch( id );
+        value.append( page.data() + OVERFLOW_HEADER, get32( page.data() + 4 ) );
+        id = get32( page.data() );
+    }
+    return value;
+}
+
+bool File::BPlusTree::erase( const std::string& key ) {
+    BufferPool::Page page = leafFor( key );
+    if ( !page.valid() ) return false;
+
+    Node node;
+    decode( page.data(), node );
+
+    size_t pos = 0;
+    while ( pos < node.cells.size() && node.cells[pos].key < key ) pos++;
+    if ( pos == node.cells.size() || node.cells[pos].key != key ) return false;
+
+    freeOverflow( node.cells[pos] );
+    node.cells.erase( node.cells.begin() + pos );
+    encode( node, page.edit() );
+    count( -1 );
+    return true;
+}
+
+File::BPlusTree::Cursor File::BPlusTree::lowerBound( const std::string& key ) {
+    Cursor cursor;
+    BufferPool::Page page = leafFor( key );
+    if ( !page.valid() ) return cursor;
+
+    cursor.tree = this;
+    decode( page.data(), cursor.node );
+    while ( cursor.index < cursor.node.cells.size() && cursor.node.cells[cursor.index].key < key ) cursor.index++;
+    cursor.settle();
+    return cursor;
+}
+
+void File::BPlusTree::Cursor::settle() {
+    while ( index >= node.cells.size() && node.link != 0 )
+    {
+        BufferPool::Page page = tree->pool.fetch( node.link );
+        decode( page.data(), node );
+        index = 0;
+    }
+}
+
+std::string File::BPlusTree::Cursor::value() const {
+    const Cell& cell = node.cells[index];
+    return cell.overflow ? tree->readOverflow( cell.value ) : cell.value;
+}
+
+File::BPlusTree::Cursor& File::BPlusTree::Cursor::operator++() {
+    index++;
+    settle();
+    return *this;
+}
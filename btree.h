@@ -0,0 +1,162 @@
+#ifndef NHF4_BTREE_H
+#define NHF4_BTREE_H
+/**
+ * \file btree.h
+ *
+ * Ez a fájl tartalmazza a lemezen tárolt, rendezett kulcs-érték párokhoz szükséges BPlusTree osztályt
+ */
+
+#include <string>
+#include <vector>
+#include "memtrace.h"
+#include "bufferpool.h"
+
+namespace File
+{
+    /**
+     * BPlusTree osztály
+     * Lemezen tárolt B+fa változó hosszú (bájtsorozat) kulcsokkal és értékekkel, a BufferPool lapjain.
+     * A belső lapok csak elválasztó kulcsokat és gyereklapokat, a levelek a kulcs-érték párokat tárolják;
+     * a levelek a következő levélre mutatnak, így a rendezett bejárás lapról lapra halad. A kulcsok
+     * bájtonként (memcmp) rendeződnek. A MAX_INLINE-nál hosszabb érték túlcsordulási lapok láncába kerül.
+     * Keresésnél a lapokat nem bontja ki, csak beszúrásnál és törlésnél. Törléskor a lapokat nem vonja
+     * össze: az üres levél a láncban marad, a helyét a későbbi beszúrások használják fel.
+     * A fa gyökere és elemszáma a BufferPool fejlécének megadott sorszámú helyén van.
+     */
+    class BPlusTree
+    {
+    public:
+        enum { MAX_KEY = 256 };     /// A leghosszabb kulcs bájtban
+        enum { MAX_INLINE = 768 };  /// Ennél hosszabb érték túlcsordulási lapokra kerül (így egy lapra legalább 3 bejegyzés fér)
+
+    private:
+        /// Egy bejegyzés a kibontott lapon
+        struct Cell
+        {
+            std::string key;        /// Kulcs
+            std::string value;      /// Érték (levél) - túlcsordulásnál a lánc első lapja és a hossz
+            bool overflow;          /// Túlcsordulási lapokon van-e az érték
+            unsigned int child;     /// A kulcstól kezdődő részfa lapja (belső lap)
+
+            Cell() :overflow( false ), child( 0 ) {};
+        };
+
+        /// Kibontott lap
+        struct Node
+        {
+            bool leaf;                  /// Levél-e
+            unsigned int link;          /// Levélnél a következő levél, belső lapnál a legkisebb kulcsok részfája
+            std::vector<Cell> cells;    /// Bejegyzések kulcs szerint rendezve
+
+            Node() :leaf( true ), link( 0 ) {};
+        };
+
+        /// Lapvágás eredménye: az új (jobb oldali) lap és az első kulcsa
+        struct Split
+        {
+            std::string key;    /// Elválasztó kulcs
+            unsigned int page;  /// Új lap
+
+            Split() :page( 0 ) {};
+        };
+
+        BufferPool& pool;   /// Lapok
+        int slot;           /// A gyökér és az elemszám helye a fejlécben
+
+        /// Lap kibontása / összeállítása
+        static void decode( const char* page, Node& node );
+        static void encode( const Node& node, char* page );
+
+        /// A lap összeállítva ennyi bájt
+        static size_t encodedSize( const Node& node );
+
+        /// A gyereklap, amelyben a kulcs lehet (belső lapon, kibontás nélkül)
+        static unsigned int childFor( const char* page, const std::string& key );
+
+        /// A levél, amelyben a kulcs lehet
+        BufferPool::Page leafFor( const std::string& key );
+
+        /// Beszúrás a lap részfájába
+        /// @param id - lap
+        /// @param cell - új bejegyzés (levélbe)
+        /// @param split - ha a lap kettévált, az új lap
+        /// @param replaced - meglévő kulcs értéke cserélődött-e
+        /// @return bool - kettévált-e a lap
+        bool insertInto( unsigned int id, const Cell& cell, Split& split, bool& replaced );
+
+        /// Érték felírása túlcsordulási lapokra / a lánc felszabadítása / beolvasása
+        void writeOverflow( const std::string& value, Cell& cell );
+        void freeOverflow( const Cell& cell );
+        std::string readOverflow( const std::string& ref ) const;
+
+        /// Az elemszám módosítása a fejlécben
+        void count( long long delta ) { pool.setCounter( slot, pool.counter( slot ) + delta ); }
+
+    public:
+        /**
+         * Cursor osztály
+         * Rendezett bejárás a levelek láncán. Egyszerre egy kibontott levelet tart a memóriában;
+         * a fa módosítása után érvénytelen.
+         */
+        class Cursor
+        {
+        private:
+            BPlusTree* tree;    /// Bejárt fa
+            Node node;          /// Aktuális levél
+            size_t index;       /// Aktuális bejegyzés
+
+            friend class BPlusTree;
+
+            /// Továbblép a következő nem üres levélre, ha a levél végére értünk
+            void settle();
+
+        public:
+            Cursor() :tree( nullptr ), index( 0 ) {};
+
+            /// Érvényes elemen áll-e
+            bool valid() const { return tree != nullptr && index < node.cells.size(); }
+
+            /// Az aktuális kulcs
+            const std::string& key() const { return node.cells[index].key; }
+
+            /// Az aktuális érték (túlcsordulásnál beolvassa)
+            std::string value() const;
+
+            /// Lépés a következő elemre
+            Cursor& operator++();
+        };
+
+        /// Konstruktor
+        /// @param p - lapok
+        /// @param s - a gyökér és az elemszám helye a fejlécben
+        BPlusTree( BufferPool& p, int s ) :pool( p ), slot( s ) {};
+
+        /// Elemek száma
+        size_t size() const { return (size_t)pool.counter( slot ); }
+
+        /// Érték keresése
+        /// @param key - kulcs
+        /// @param value - ide kerül az érték
+        /// @return bool - van-e ilyen kulcs
+        bool find( const std::string& key, std::string& value );
+
+        /// Beszúrás vagy csere
+        /// length_error hibát dob, ha a kulcs MAX_KEY-nél hosszabb
+        /// @param key - kulcs
+        /// @param value - érték
+        /// @return bool - új kulcs volt-e
+        bool insert( const std::string& key, const std::string& value );
+
+        /// Törlés
+        /// @param key - kulcs
+        /// @return bool - volt-e ilyen kulcs
+        bool erase( const std::string& key );
+
+        /// Bejárás az első, a megadottnál nem kisebb kulcstól
+        /// @param key - kulcs (üres = az elejétől)
+        /// @return Cursor - bejáró
+        Cursor lowerBound( const std::string& key );
+    };
+}
+
+#endif // NHF4_BTREE_H
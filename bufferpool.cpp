@@ -0,0 +1,218 @@
+/**
+ * \file bufferpool.cpp
+ *
+ * Ez a fájl tartalmazza a PageFile és a BufferPool osztály megvalósítását
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "bufferpool.h"
+#include "memtrace.h"
+
+namespace
+{
+    /// A fájlazonosító a fejléc elején
+    const char MAGIC[8] = { 'N', 'H', 'F', 'P', 'A', 'G', 'E', '1' };
+}
+
+File::PageFile::PageFile( const String& path ) :fd( ::open( path.c_str(), O_RDWR | O_CREAT, 0644 ) ), pages( 0 ) {
+    if ( fd < 0 ) throw std::ifstream::failure( "Hiba tortent a(z) \"" + std::string( path.c_str() ) + "\" megnyitasa kozben!" );
+
+    struct stat info;
+    if ( ::fstat( fd, &info ) == 0 ) pages = (unsigned int)( info.st_size / PAGE_SIZE );
+}
+
+File::PageFile::~PageFile() {
+    ::close( fd );
+}
+
+void File::PageFile::read( unsigned int id, char* page ) const {
+    size_t done = 0;
+    while ( done < PAGE_SIZE )
+    {
+        ssize_t n = ::pread( fd, page + done, PAGE_SIZE - done, (off_t)id * PAGE_SIZE + done );
+        if ( n < 0 && errno == EINTR ) continue;
+        if ( n < 0 ) throw std::ifstream::failure( "Hiba tortent a lap olvasasa kozben!" );
+        if ( n == 0 ) break;
+        done += (size_t)n;
+    }
+    // A még ki nem írt lap nullákból áll
+    std::memset( page + done, 0, PAGE_SIZE - done );
+}
+
+void File::PageFile::write( unsigned int id, const char* page ) {
+    size_t done = 0;
+    while ( done < PAGE_SIZE )
+    {
+        ssize_t n = ::pwrite( fd, page + done, PAGE_SIZE - done, (off_t)id * PAGE_SIZE + done );
+        if ( n < 0 && errno == EINTR ) continue;
+        if ( n <= 0 ) throw std::ofstream::failure( "Hiba tortent a lap irasa kozben!" );
+        done += (size_t)n;
+    }
+    if ( id >= pages ) pages = id + 1;
+}
+
+void File::PageFile::sync() {
+    ::fsync( fd );
+}
+
+
+File::BufferPool::BufferPool( const String& path, size_t budget )
+    :file( path ), headerDirty( false ), hitCount( 0 ), missCount( 0 ), writeCount( 0 ) {
+    std::memset( &header, 0, sizeof( header ) );
+
+    if ( file.count() == 0 )
+    {
+        std::memcpy( header.magic, MAGIC, sizeof( MAGIC ) );
+        file.extend();
+        headerDirty = true;
+    }
+    else
+    {
+        char page[PageFile::PAGE_SIZE];
+        file.read( 0, page );
+        std::memcpy( &header, page, sizeof( header ) );
+        if ( std::memcmp( header.magic, MAGIC, sizeof( MAGIC ) ) != 0 )
+            throw std::ifstream::failure( "A(z) \"" + std::string( path.c_str() ) + "\" nem receptkonyv adatfajl!" );
+    }
+
+    size_t count = budget / PageFile::PAGE_SIZE;
+    if ( count < MIN_FRAMES ) count = MIN_FRAMES;
+
+    frames.resize( count );
+    for ( size_t i = 0; i < count; i++ )
+    {
+        frames[i].data = new char[PageFile::PAGE_SIZE];
+        frames[i].position = lru.end();
+        empty.push_back( count - 1 - i );
+    }
+}
+
+File::BufferPool::~BufferPool() {
+    try {
+        flush();
+    } catch ( std::ofstream::failure& ex ) { std::cerr << ex.what() << std::endl; }
+
+    for ( size_t i = 0; i < frames.size(); i++ ) delete[] frames[i].data;
+}
+
+File::BufferPool::Page& File::BufferPool::Page::operator=( const Page& other ) {
+    if ( other.pool ) other.pool->pin( other.frame );
+    if ( pool ) pool->unpin( frame );
+    pool = other.pool;
+    frame = other.frame;
+    return *this;
+}
+
+void File::BufferPool::pin( size_t frame ) {
+    Frame& f = frames[frame];
+    if ( f.pins++ == 0 && f.position != lru.end() )
+    {
+        lru.erase( f.position );
+        f.position = lru.end();
+    }
+}
+
+void File::BufferPool::unpin( size_t frame ) {
+    Frame& f = frames[frame];
+    if ( --f.pins > 0 ) return;
+
+    if ( f.id == 0 ) { empty.push_back( frame ); return; }
+    lru.push_front( frame );
+    f.position = lru.begin();
+}
+
+void File::BufferPool::writeBack( Frame& frame ) {
+    if ( !frame.dirty ) return;
+    file.write( frame.id, frame.data );
+    frame.dirty = false;
+    writeCount++;
+}
+
+size_t File::BufferPool::victim() {
+    if ( !empty.empty() )
+    {
+        size_t frame = empty.back();
+        empty.pop_back();
+        return frame;
+    }
+    if ( lru.empty() ) throw std::runtime_error( "A lapkeret minden lapja foglalt!" );
+
+    size_t frame = lru.back();
+    lru.pop_back();
+
+    Frame& f = frames[frame];
+    f.position = lru.end();
+    writeBack( f );
+    table.erase( f.id );
+    f.id = 0;
+    return frame;
+}
+
+File::BufferPool::Page File::BufferPool::fetch( unsigned int id ) {
+    std::unordered_map<unsigned int, size_t>::iterator it = table.find( id );
+    if ( it != table.end() ) { hitCount++; return Page( this, it->second ); }
+
+    missCount++;
+    size_t frame = victim();
+    Frame& f = frames[frame];
+    try {
+        file.read( id, f.data );
+    } catch ( ... ) { empty.push_back( frame ); throw; }
+
+    f.id = id;
+    f.dirty = false;
+    table[id] = frame;
+    return Page( this, frame );
+}
+
+File::BufferPool::Page File::BufferPool::allocate() {
+    unsigned int id = header.freeHead;
+    if ( id != 0 )
+    {
+        // A szabad lap első 4 bájtja a következő szabad lap száma
+        Page page = fetch( id );
+        std::memcpy( &header.freeHead, page.data(), sizeof( unsigned int ) );
+        headerDirty = true;
+        std::memset( page.edit(), 0, PageFile::PAGE_SIZE );
+        return page;
+    }
+
+    size_t frame = victim();
+    Frame& f = frames[frame];
+    f.id = file.extend();
+    f.dirty = true;
+    std::memset( f.data, 0, PageFile::PAGE_SIZE );
+    table[f.id] = frame;
+    return Page( this, frame );
+}
+
+void File::BufferPool::release( unsigned int id ) {
+    Page page = fetch( id );
+    char* data = page.edit();
+    std::memset( data, 0, PageFile::PAGE_SIZE );
+    std::memcpy( data, &header.freeHead, sizeof( unsigned int ) );
+    header.freeHead = id;
+    headerDirty = true;
+}
+
+void File::BufferPool::flush() {
+    for ( size_t i = 0; i < frames.size(); i++ )
+        if ( frames[i].id != 0 ) writeBack( frames[i] );
+
+    if ( headerDirty )
+    {
+        char page[PageFile::PAGE_SIZE];
+        std::memset( page, 0, sizeof( page ) );
+        std::memcpy( page, &header, sizeof( header ) );
+        file.write( 0, page );
+        headerDirty = false;
+    }
+    file.sync();
+}
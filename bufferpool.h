@@ -0,0 +1,215 @@
+#ifndef NHF4_BUFFERPOOL_H
+#define NHF4_BUFFERPOOL_H
+/**
+ * \file bufferpool.h
+ *
+ * Ez a fájl tartalmazza a lapokra osztott adatfájl kezeléséhez szükséges PageFile és BufferPool osztályokat
+ */
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "memtrace.h"
+#include "string5.h"
+
+namespace File
+{
+    /**
+     * PageFile osztály
+     * Rögzített méretű (PAGE_SIZE bájtos) lapokból álló fájl, lapszám szerinti olvasással és írással (pread/pwrite)
+     * A 0. lap a fejléc; a 0 lapszám ezért a lapok közötti hivatkozásokban "nincs lap" jelentésű
+     */
+    class PageFile
+    {
+    public:
+        enum { PAGE_SIZE = 4096 };  /// Egy lap mérete bájtban
+
+    private:
+        int fd;                 /// Fájlleíró
+        unsigned int pages;     /// A fájl lapjainak száma
+
+        /// Másolás tiltása
+        PageFile( const PageFile& );
+        PageFile& operator=( const PageFile& );
+
+    public:
+        /// Konstruktor - megnyitja (ha nem létezik, létrehozza) a fájlt
+        /// ifstream::failure hibát dob, ha nem sikerült a művelet
+        /// @param path - fájl útvonala
+        explicit PageFile( const String& path );
+
+        /// Destruktor - bezárja a fájlt
+        ~PageFile();
+
+        /// A lapok száma
+        unsigned int count() const { return pages; }
+
+        /// Egy lap beolvasása
+        /// ifstream::failure hibát dob, ha nem sikerült a művelet
+        /// @param id - lapszám
+        /// @param page - PAGE_SIZE bájtos terület
+        void read( unsigned int id, char* page ) const;
+
+        /// Egy lap kiírása (a fájl végén túli lapszámnál a fájl nő)
+        /// ofstream::failure hibát dob, ha nem sikerült a művelet
+        /// @param id - lapszám
+        /// @param page - PAGE_SIZE bájtos terület
+        void write( unsigned int id, const char* page );
+
+        /// Új lap a fájl végén (még nem íródik ki)
+        /// @return unsigned int - az új lap száma
+        unsigned int extend() { return pages++; }
+
+        /// A kiírt lapok lemezre kényszerítése (fsync)
+        void sync();
+    };
+
+    /**
+     * BufferPool osztály
+     * A PageFile lapjainak gyorsítótára rögzített memóriakerettel: a keretben csak a használt ("forró") lapok
+     * vannak a memóriában. A lapot a Page objektum tartja a memóriában (pin); ha nincs szabad keret, a
+     * legrégebben használt, nem tartott lap kerül ki (LRU), módosítás esetén előbb kiíródik.
+     * A fejléc-lap (0. lap) mindig a memóriában van: a fájl gyökérlapjait, szabad lapjait és néhány
+     * számlálót tárol. A felszabadított lapok egy láncolt szabadlistába kerülnek, és újrafelhasználódnak.
+     */
+    class BufferPool
+    {
+    public:
+        enum { SLOTS = 4 };         /// A fejlécben tárolt gyökérlapok és számlálók száma
+        enum { MIN_FRAMES = 16 };   /// A keretek legkisebb száma (egy B+fa művelet ennyi lapot tarthat egyszerre)
+
+    private:
+        /// A fejléc-lap tartalma
+        struct Header
+        {
+            char magic[8];                      /// Fájlazonosító
+            unsigned int freeHead;              /// Az első szabad lap (0 = nincs)
+            unsigned int roots[SLOTS];          /// Gyökérlapok (0 = üres)
+            unsigned long long counters[SLOTS]; /// Számlálók (pl. elemszám, következő azonosító)
+        };
+
+        /// Egy keret: egy lap helye a memóriában
+        struct Frame
+        {
+            unsigned int id;        /// A betöltött lap száma (0 = üres keret)
+            char* data;             /// PAGE_SIZE bájtos terület
+            unsigned int pins;      /// Ennyi Page tartja
+            bool dirty;             /// Módosult-e a betöltés óta
+            std::list<size_t>::iterator position;   /// Helye az LRU listában (end(), ha nincs benne)
+
+            Frame() :id( 0 ), data( nullptr ), pins( 0 ), dirty( false ) {};
+        };
+
+        PageFile file;                                  /// Az adatfájl
+        Header header;                                  /// A fejléc
+        bool headerDirty;                               /// Módosult-e a fejléc
+        std::vector<Frame> frames;                      /// Keretek
+        std::unordered_map<unsigned int, size_t> table; /// Lapszám -> keret
+        std::list<size_t> lru;                          /// A nem tartott, betöltött keretek, elöl a legutóbb használt
+        std::vector<size_t> empty;                      /// Üres keretek
+
+        unsigned long long hitCount;        /// A memóriában talált lapok
+        unsigned long long missCount;       /// A fájlból beolvasott lapok
+        unsigned long long writeCount;      /// A kiírt lapok
+
+        /// Másolás tiltása
+        BufferPool( const BufferPool& );
+        BufferPool& operator=( const BufferPool& );
+
+        /// Keret a megadott laphoz: üres keret, vagy a legrégebben használt nem tartott lap helye
+        /// runtime_error hibát dob, ha minden keretet tartanak
+        /// @return size_t - a keret indexe (a táblából már kivéve)
+        size_t victim();
+
+        /// A keret tartása / elengedése
+        void pin( size_t frame );
+        void unpin( size_t frame );
+
+        /// Kiírja a keret lapját, ha módosult
+        void writeBack( Frame& frame );
+
+    public:
+        /**
+         * Page osztály
+         * Egy memóriában tartott lap: amíg létezik (vagy másolata), a lap nem kerülhet ki a keretből
+         */
+        class Page
+        {
+        private:
+            BufferPool* pool;   /// A tartó keretkészlet
+            size_t frame;       /// Keret indexe
+
+            friend class BufferPool;
+            Page( BufferPool* p, size_t f ) :pool( p ), frame( f ) { if ( pool ) pool->pin( frame ); };
+
+        public:
+            /// Default konstruktor - nem tart lapot
+            Page() :pool( nullptr ), frame( 0 ) {};
+            Page( const Page& other ) :pool( other.pool ), frame( other.frame ) { if ( pool ) pool->pin( frame ); };
+            Page& operator=( const Page& other );
+            ~Page() { if ( pool ) pool->unpin( frame ); }
+
+            /// Tart-e lapot
+            bool valid() const { return pool != nullptr; }
+
+            /// A lap száma
+            unsigned int id() const { return pool->frames[frame].id; }
+
+            /// A lap tartalma olvasásra
+            const char* data() const { return pool->frames[frame].data; }
+
+            /// A lap tartalma írásra - a lap módosítottnak számít
+            char* edit() { pool->frames[frame].dirty = true; return pool->frames[frame].data; }
+        };
+
+        /// Konstruktor - megnyitja a fájlt; új fájlnál létrehozza a fejlécet
+        /// ifstream::failure hibát dob, ha a fájl nem nyitható meg, vagy nem ilyen formátumú
+        /// @param path - fájl útvonala
+        /// @param budget - a keretek összmérete bájtban (legalább MIN_FRAMES lap)
+        BufferPool( const String& path, size_t budget );
+
+        /// Destruktor - kiírja a módosult lapokat, és felszabadítja a kereteket
+        ~BufferPool();
+
+        /// Lap betöltése (ha még nincs a memóriában)
+        /// @param id - lapszám (nem 0)
+        /// @return Page - a tartott lap
+        Page fetch( unsigned int id );
+
+        /// Új (nullázott) lap: a szabadlistáról, vagy a fájl végéről
+        /// @return Page - a tartott lap
+        Page allocate();
+
+        /// Lap felszabadítása - a szabadlistára kerül (senki nem hivatkozhat már rá)
+        /// @param id - lapszám
+        void release( unsigned int id );
+
+        /// Gyökérlap és számláló a fejlécben
+        /// @param slot - sorszám (0 .. SLOTS-1)
+        unsigned int root( int slot ) const { return header.roots[slot]; }
+        void setRoot( int slot, unsigned int id ) { header.roots[slot] = id; headerDirty = true; }
+        unsigned long long counter( int slot ) const { return header.counters[slot]; }
+        void setCounter( int slot, unsigned long long value ) { header.counters[slot] = value; headerDirty = true; }
+
+        /// Minden módosult lap és a fejléc kiírása, majd fsync
+        /// ofstream::failure hibát dob, ha nem sikerült a művelet
+        void flush();
+
+        /// A keretek száma
+        size_t capacity() const { return frames.size(); }
+
+        /// A memóriában lévő lapok száma
+        size_t resident() const { return table.size(); }
+
+        /// A fájl lapjainak száma
+        unsigned int pages() const { return file.count(); }
+
+        /// Találatok (memóriában lévő lap), hiányok (fájlból olvasott lap) és kiírt lapok száma
+        unsigned long long hits() const { return hitCount; }
+        unsigned long long misses() const { return missCount; }
+        unsigned long long writes() const { return writeCount; }
+    };
+}
+
+#endif // NHF4_BUFFERPOOL_H
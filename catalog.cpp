@@ -0,0 +1,61 @@
+/**
+ * \file catalog.cpp
+ *
+ * Ez a fájl tartalmazza a Catalog osztály megvalósítását
+ */
+
+#include <algorithm>
+#include "catalog.h"
+#include "memtrace.h"
+
+void Components::Catalog::push( const Entry& entry ) {
+    positions[entry->getId().key()] = recipes.size();
+    recipes.push_back( entry );
+}
+
+void Components::Catalog::reserve( size_t n ) {
+    recipes.reserve( n );
+    titles.reserve( n );
+    positions.reserve( n );
+}
+
+const Components::Recipe* Components::Catalog::find( const Handle& id ) const {
+    std::unordered_map<unsigned long long, size_t>::const_iterator it = positions.find( id.key() );
+    return it != positions.end() ? recipes[it->second].get() : nullptr;
+}
+
+Components::Catalog::Entry Components::Catalog::entry( const Handle& id ) const {
+    std::unordered_map<unsigned long long, size_t>::const_iterator it = positions.find( id.key() );
+    return it != positions.end() ? recipes[it->second] : Entry();
+}
+
+size_t Components::Catalog::rankOf( const TitleKey& key ) const {
+    return std::lower_bound( titles.begin(), titles.end(), key ) - titles.begin();
+}
+
+std::string Components::Catalog::closestIngredient( const std::string& name, unsigned int k ) const {
+    if ( !fuzzySearch || !ingredientNames || name.empty() || ingredientNames->contains( name ) ) return std::string();
+
+    std::vector<BKTree::Match> matches = ingredientNames->find( name, k );
+    return matches.empty() ? std::string() : matches[0].first;
+}
+
+bool Components::Catalog::instructionsOf( const Recipe& recipe, LinkedList<String>& plain, std::ostream& err ) const {
+    if ( recipe.instructionsLoaded() )
+    {
+        for ( LinkedList<String>::Iterator it( *recipe.getInstructions() ); it != LinkedList<String>::Iterator(); it++ )
+            plain.emplace( codec->decode( it->c_str() ).c_str() );
+        return true;
+    }
+
+    if ( !source ) { err << "Az instrukciok nem erhetok el!" << std::endl; return false; }
+
+    LinkedList<String> encoded;
+    try {
+        source->readRange( recipe.getInstructionRange(), encoded );
+    } catch ( std::ifstream::failure& ex ) { err << ex.what() << std::endl; return false; }
+
+    for ( LinkedList<String>::Iterator it = encoded.begin(); it != encoded.end(); it++ )
+        plain.emplace( codec->decode( it->c_str() ).c_str() );
+    return true;
+}
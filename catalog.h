@@ -0,0 +1,123 @@
+#ifndef NHF4_CATALOG_H
+#define NHF4_CATALOG_H
+/**
+ * \file catalog.h
+ *
+ * Ez a fájl tartalmazza a receptek közzétett, csak olvasható pillanatképét megvalósító Catalog osztályt
+ */
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "components.h"
+#include "list.h"
+#include "file.h"
+#include "slotmap.h"
+#include "similarity.h"
+#include "bktree.h"
+#include "textcodec.h"
+#include "memtrace.h"
+
+namespace Components
+{
+    /**
+     * Catalog osztály
+     * A receptek egy változatának pillanatképe a keresésekhez: a receptek listabeli és abc sorrendje,
+     * azonosító szerinti elérése, a hasonlósági index és az alapanyagnevek.
+     * Közzététel (Rcu) után már nem módosul, így a keresések zár nélkül, párhuzamosan futhatnak rajta.
+     * Az író a következő változatot az előzőből építi: a nem módosult receptek közösek maradnak (shared_ptr).
+     * A hasonlósági indexet és az alapanyagneveket az író kettős pufferből (DoubleBuffer) adja, így
+     * változatlanul közösek, módosítás után pedig sem ezek, sem a receptek nem másolódnak teljesen.
+     */
+    class Catalog
+    {
+    public:
+        /// Egy recept közös, nem módosuló példánya
+        typedef std::shared_ptr<const Recipe> Entry;
+
+    private:
+        std::vector<Entry> recipes;     /// Receptek a lista sorrendjében
+        std::vector<TitleKey> titles;   /// Címek abc sorrendben
+
+        /// Azonosító kulcsa -> index a receptek között
+        std::unordered_map<unsigned long long, size_t> positions;
+
+        std::shared_ptr<const SimilarityIndex> similarIndex;   /// Hasonlósági index
+        std::shared_ptr<const BKTree> ingredientNames;          /// Alapanyagnevek (elgépelés-tűrő kereséshez)
+        std::shared_ptr<const File::Source> source;             /// A be nem töltött instrukciók fájlja
+        const TextCodec* codec;                                 /// Az instrukciók tömörítő szótára
+        bool fuzzySearch;                                       /// Be van-e kapcsolva az elgépelés-tűrő keresés
+
+        /// Másolás tiltása
+        Catalog( const Catalog& );
+        Catalog& operator=( const Catalog& );
+
+    public:
+        /// Konstruktor - üres pillanatkép
+        /// @param c - az instrukciók tömörítő szótára (a közzétett változatok élettartama alatt nem változhat)
+        /// @param fuzzy - be van-e kapcsolva az elgépelés-tűrő keresés
+        Catalog( const TextCodec& c, bool fuzzy ) :codec( &c ), fuzzySearch( fuzzy ) {};
+
+        // Építés - csak közzététel előtt
+
+        /// Recept hozzáfűzése a lista végére
+        /// @param entry - recept
+        void push( const Entry& entry );
+
+        /// Cím hozzáfűzése az abc sorrend végére (a hívó rendezett sorrendben adja)
+        /// @param key - cím
+        void pushTitle( const TitleKey& key ) { titles.push_back( key ); }
+
+        /// Hasonlósági index beállítása
+        void setSimilarIndex( const std::shared_ptr<const SimilarityIndex>& index ) { similarIndex = index; }
+
+        /// Alapanyagnevek beállítása
+        void setIngredientNames( const std::shared_ptr<const BKTree>& names ) { ingredientNames = names; }
+
+        /// A be nem töltött instrukciók fájljának beállítása
+        void setSource( const std::shared_ptr<const File::Source>& file ) { source = file; }
+
+        /// Előre lefoglal n receptnek és címnek helyet
+        void reserve( size_t n );
+
+        // Lekérdezés
+
+        /// Receptek száma
+        size_t size() const { return recipes.size(); }
+
+        /// A lista sorrendjében i. recept (0-tól)
+        const Recipe& at( size_t i ) const { return *recipes[i]; }
+
+        /// Recept azonosító alapján
+        /// @return const Recipe* - a recept, ha nincs ilyen akkor nullptr
+        const Recipe* find( const Handle& id ) const;
+
+        /// Recept közös példánya azonosító alapján (a következő változat építéséhez)
+        /// @return Entry - a recept, ha nincs ilyen akkor üres
+        Entry entry( const Handle& id ) const;
+
+        /// Címek abc sorrendben
+        const std::vector<TitleKey>& sortedTitles() const { return titles; }
+
+        /// A címnél kisebb címek száma (rang az abc sorrendben)
+        size_t rankOf( const TitleKey& key ) const;
+
+        /// Hasonlósági index
+        const SimilarityIndex& similar() const { return *similarIndex; }
+
+        /// Az ismeretlen alapanyagnévhez legközelebbi ismert név (elgépelés-tűrő keresés)
+        /// @param name - alapanyag neve
+        /// @param k - legnagyobb megengedett távolság
+        /// @return std::string - a javított név, üres, ha nincs mit javítani (vagy ki van kapcsolva)
+        std::string closestIngredient( const std::string& name, unsigned int k ) const;
+
+        /// A recept nyers instrukciói - a receptből, vagy ha nincsenek betöltve, a pillanatkép fájljából
+        /// @param recipe - a pillanatkép egy receptje
+        /// @param plain - ide kerülnek a nyers instrukciók
+        /// @param err - hibaüzenetek kimenete
+        /// @return bool - sikeres volt-e
+        bool instructionsOf( const Recipe& recipe, LinkedList<String>& plain, std::ostream& err ) const;
+    };
+}
+
+#endif // NHF4_CATALOG_H
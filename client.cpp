@@ -0,0 +1,108 @@
+/**
+ * \file client.cpp
+ *
+ * Vékony parancssori kliens a daemon módban futó receptkönyvhöz
+ *
+ * Használat: receptkonyv_client [--socket utvonal] PARANCS [parameterek...]
+ * Parancs nélkül a standard inputról soronként olvassa a kéréseket.
+ * A válasz törzsét a standard outputra írja; ha bármelyik kérés sikertelen, a kilépési kód 1.
+ */
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "protocol.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+namespace
+{
+    /// Kapcsolódás a daemonhoz
+    /// @param path - socket útvonala
+    /// @return int - a kapcsolat socketje, hiba esetén -1
+    int connectTo( const std::string& path )
+    {
+        sockaddr_un addr;
+        std::memset( &addr, 0, sizeof( addr ) );
+        addr.sun_family = AF_UNIX;
+        if ( path.size() >= sizeof( addr.sun_path ) ) { cerr << "Tul hosszu socket utvonal: \"" << path << "\"" << endl; return -1; }
+        std::strcpy( addr.sun_path, path.c_str() );
+
+        int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        if ( fd < 0 || connect( fd, (sockaddr*)&addr, sizeof( addr ) ) != 0 )
+        {
+            cerr << "Nem fut daemon ezen a socketen: \"" << path << "\" (inditas: receptkonyv --daemon)" << endl;
+            if ( fd >= 0 ) close( fd );
+            return -1;
+        }
+        return fd;
+    }
+
+    /// Egy kérés elküldése, és a válasz kiírása
+    /// @param fd - kapcsolat
+    /// @param reader - a kapcsolat soronkénti olvasója
+    /// @param request - kérés (egy sor)
+    /// @param ok - ide kerül, hogy sikeres volt-e a kérés
+    /// @return bool - hamis, ha megszakadt a kapcsolat
+    bool exchange( int fd, Protocol::LineReader& reader, const std::string& request, bool& ok )
+    {
+        if ( !Protocol::writeAll( fd, request + "\n" ) ) return false;
+
+        std::string line;
+        if ( !reader.next( line ) ) return false;
+        ok = line == "OK";
+
+        std::ostream& out = ok ? cout : cerr;
+        while ( reader.next( line ) )
+        {
+            if ( line == Protocol::END ) return true;
+            if ( !line.empty() && line[0] == '.' ) line.erase( 0, 1 );
+            out << line << '\n';
+        }
+        return false;
+    }
+}
+
+int main( int argc, char* argv[] )
+{
+    std::string path = Protocol::DEFAULT_SOCKET;
+    std::string request;
+
+    for ( int i = 1; i < argc; i++ )
+    {
+        std::string arg = argv[i];
+        if ( arg == "--socket" && i + 1 < argc ) { path = argv[++i]; continue; }
+        request += ( request.empty() ? "" : " " ) + arg;
+    }
+
+    int fd = connectTo( path );
+    if ( fd < 0 ) return 2;
+
+    Protocol::LineReader reader( fd );
+    bool failed = false, ok = true;
+
+    if ( !request.empty() )
+    {
+        if ( !exchange( fd, reader, request, ok ) ) { cerr << "Megszakadt a kapcsolat!" << endl; failed = true; }
+        failed = failed || !ok;
+    }
+    else
+    {
+        std::string line;
+        while ( std::getline( std::cin, line ) )
+        {
+            if ( line.empty() ) continue;
+            if ( !exchange( fd, reader, line, ok ) ) { cerr << "Megszakadt a kapcsolat!" << endl; failed = true; break; }
+            failed = failed || !ok;
+        }
+    }
+
+    cout.flush();
+    close( fd );
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * \file compact.cpp
+ *
+ * Ez a fájl tartalmazza a NameTable, az IngredientTable és az IngredientPrinter osztály megvalósítását
+ */
+
+#include <cstring>
+#include "compact.h"
+#include "render.h"
+#include "memtrace.h"
+
+unsigned int Components::NameTable::hash( const char* name, size_t length ) {
+    unsigned int h = 2166136261u;
+    for ( size_t i = 0; i < length; i++ ) h = ( h ^ (unsigned char)name[i] ) * 16777619u;
+    return h;
+}
+
+size_t Components::NameTable::slot( const char* name, size_t length, unsigned int h ) const {
+    size_t mask = slots.size() - 1;
+    for ( size_t i = h & mask; ; i = ( i + 1 ) & mask )
+    {
+        unsigned int entry = slots[i];
+        if ( entry == 0 ) return i;
+
+        unsigned int id = entry - 1;
+        if ( this->length( id ) == length && std::memcmp( text.data() + offsets[id], name, length ) == 0 ) return i;
+    }
+}
+
+void Components::NameTable::grow() {
+    std::vector<unsigned int> old;
+    old.swap( slots );
+    slots.assign( old.empty() ? 16 : old.size() * 2, 0 );
+
+    for ( size_t i = 0; i < old.size(); i++ )
+    {
+        if ( old[i] == 0 ) continue;
+        unsigned int id = old[i] - 1;
+        slots[slot( name( id ), length( id ), hash( name( id ), length( id ) ) )] = old[i];
+    }
+}
+
+unsigned int Components::NameTable::intern( const char* name, size_t length ) {
+    // Legfeljebb félig telt tábla
+    if ( 2 * ( offsets.size() + 1 ) > slots.size() ) grow();
+
+    unsigned int h = hash( name, length );
+    size_t i = slot( name, length, h );
+    if ( slots[i] != 0 ) return slots[i] - 1;
+
+    unsigned int id = (unsigned int)offsets.size();
+    offsets.push_back( (unsigned int)text.size() );
+    text.append( name, length );
+    text.push_back( '\0' );
+    slots[i] = id + 1;
+    return id;
+}
+
+unsigned int Components::NameTable::find( const char* name, size_t length ) const {
+    if ( slots.empty() ) return NONE;
+    size_t i = slot( name, length, hash( name, length ) );
+    return slots[i] != 0 ? slots[i] - 1 : NONE;
+}
+
+void Components::NameTable::reserve( size_t n ) {
+    offsets.reserve( n );
+    while ( slots.size() < 2 * n ) grow();
+}
+
+
+size_t Components::IngredientTable::add( const char* name, size_t nameLength, const char* unit, size_t unitLength, int quantity ) {
+    records.push_back( IngredientRecord( names.intern( name, nameLength ), units.intern( unit, unitLength ), quantity ) );
+    return records.size() - 1;
+}
+
+size_t Components::IngredientTable::add( const Ingredient& ingredient ) {
+    return add( ingredient.name, ingredient.unit, 0 );
+}
+
+size_t Components::IngredientTable::add( const IngredientQ& ingredient ) {
+    // Az IngredientQ a beolvasott előjeles számot előjel nélkül tárolja, a rekordban visszakapja az előjelét
+    return add( ingredient.name, ingredient.unit, (int)ingredient.quantity );
+}
+
+Components::IngredientQ Components::IngredientTable::expand( size_t index ) const {
+    const IngredientRecord& record = records[index];
+    return IngredientQ( String( names.name( record.name ) ), String( units.name( record.unit ) ), record.quantity );
+}
+
+
+void Components::IngredientPrinter::print( std::ostream& ostream, const IngredientRecord& record, bool withQuantity ) const {
+    const char* name = table.getNames().name( record.name );
+    const char* unit = table.getUnits().name( record.unit );
+    if ( withQuantity ) ostream << name << " " << record.quantity << unit;
+    else ostream << name << " (" << unit << ")";
+}
+
+void Components::IngredientPrinter::printOrderedList( std::ostream& ostream, bool withQuantity, bool displayEmpty, int from ) const {
+    PageBuffer page( ostream );
+    for ( size_t i = 0; i < table.size(); i++, from++ )
+    {
+        page.row() << from << ". ";
+        print( page.row(), table[i], withQuantity );
+        page.endRow();
+    }
+
+    if ( displayEmpty && table.size() < 1 )
+    {
+        page.row() << "A lista ures.";
+        page.endRow();
+    }
+}
+
+
+Components::MemoryUsage Components::memoryUsageOf( const NameTable& table ) {
+    MemoryUsage usage;
+    usage.objects = table.size();
+    usage.overhead = sizeof( NameTable );
+
+    // Karakterek és a lezáró nullák (legfeljebb 15 karakter az objektumban van)
+    usage.payload += table.text.size() - table.size();
+    usage.overhead += table.size();
+    if ( table.text.capacity() > 15 )
+    {
+        usage.overhead += table.text.capacity() - table.text.size();
+        usage.allocated( table.text.capacity() + 1 );
+    }
+
+    // Kezdőpozíciók és hash tábla
+    usage.overhead += ( table.offsets.capacity() + table.slots.capacity() ) * sizeof( unsigned int );
+    if ( table.offsets.capacity() > 0 ) usage.allocated( table.offsets.capacity() * sizeof( unsigned int ) );
+    if ( table.slots.capacity() > 0 ) usage.allocated( table.slots.capacity() * sizeof( unsigned int ) );
+    return usage;
+}
+
+Components::MemoryUsage Components::memoryUsageOf( const IngredientTable& table ) {
+    MemoryUsage usage = memoryUsageOf( table.names );
+    usage += memoryUsageOf( table.units );
+    usage.objects = table.records.size();
+    usage.overhead += sizeof( IngredientTable ) - 2 * sizeof( NameTable );
+
+    // A rekordban a mennyiség a hasznos adat, a két azonosító és a kihasználatlan kapacitás többlet
+    usage.payload += table.records.size() * sizeof( int );
+    usage.overhead += table.records.capacity() * sizeof( IngredientRecord ) - table.records.size() * sizeof( int );
+    if ( table.records.capacity() > 0 ) usage.allocated( table.records.capacity() * sizeof( IngredientRecord ) );
+    return usage;
+}
@@ -0,0 +1,177 @@
+#ifndef NHF4_COMPACT_H
+#define NHF4_COMPACT_H
+/**
+ * \file compact.h
+ *
+ * Ez a fájl tartalmazza az alapanyagok tömör (nem polimorf) tárolásához szükséges osztályokat
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "memtrace.h"
+#include "string5.h"
+#include "components.h"
+#include "memusage.h"
+
+namespace Components
+{
+    /**
+     * NameTable osztály
+     * Nevek egyszeri tárolása (internálás): minden különböző név egy sorszámot kap, ami alapján visszakapható.
+     * A nevek egy közös karaktertömbben vannak, a keresés nyílt címzésű hash táblával történik, így egy név
+     * keresése nem foglal memóriát. Az azonosítók 0-tól sorban kerülnek kiosztásra, és nem változnak.
+     */
+    class NameTable
+    {
+    public:
+        static const unsigned int NONE = 0xffffffffu;   /// Nem létező név azonosítója
+
+    private:
+        std::string text;                   /// A nevek egymás után, '\0'-val lezárva
+        std::vector<unsigned int> offsets;  /// Azonosító -> a név kezdete a text-ben
+        std::vector<unsigned int> slots;    /// Hash tábla: azonosító + 1 (0 = üres), mérete kettő hatvány
+
+        /// A név hash értéke (FNV-1a)
+        static unsigned int hash( const char* name, size_t length );
+
+        /// A név helye a hash táblában: ha benne van, az ő helye, különben az első üres hely
+        size_t slot( const char* name, size_t length, unsigned int h ) const;
+
+        /// A hash tábla duplázása
+        void grow();
+
+    public:
+        /// Név azonosítója; ha még nincs benne, felveszi
+        /// @param name - név
+        /// @param length - hossz bájtban
+        /// @return unsigned int - azonosító
+        unsigned int intern( const char* name, size_t length );
+        unsigned int intern( const String& name ) { return intern( name.c_str(), name.size() ); }
+
+        /// Név azonosítója felvétel nélkül
+        /// @return unsigned int - azonosító, ha nincs benne, NONE
+        unsigned int find( const char* name, size_t length ) const;
+        unsigned int find( const String& name ) const { return find( name.c_str(), name.size() ); }
+
+        /// Az azonosítóhoz tartozó név
+        const char* name( unsigned int id ) const { return text.c_str() + offsets[id]; }
+
+        /// Az azonosítóhoz tartozó név hossza
+        size_t length( unsigned int id ) const
+        {
+            size_t end = id + 1 < offsets.size() ? offsets[id + 1] : text.size();
+            return end - offsets[id] - 1;
+        }
+
+        /// Különböző nevek száma
+        size_t size() const { return offsets.size(); }
+
+        /// Előre lefoglal n névnek helyet
+        void reserve( size_t n );
+
+        friend MemoryUsage memoryUsageOf( const NameTable& table );
+    };
+
+    /**
+     * IngredientRecord struktúra
+     * Egy alapanyag tömör rekordja: a név és a mértékegység egy-egy NameTable azonosítója, és a mennyiség.
+     * Nincs virtuális függvénye és nem birtokol dinamikus területet, így 12 bájt, és tömbben tárolható.
+     * A mennyiség előjeles, mint a beolvasáskor (stoi): a hibás negatív érték negatív marad, nem fordul át ~4 milliárdra.
+     * A kiírását az IngredientPrinter végzi, ami a neveket a táblákból oldja fel.
+     */
+    struct IngredientRecord
+    {
+        unsigned int name;      /// Név azonosítója
+        unsigned int unit;      /// Mértékegység azonosítója
+        int quantity;           /// Mennyiség (Ingredient esetén 0)
+
+        /// Default konstruktor
+        IngredientRecord() :name( 0 ), unit( 0 ), quantity( 0 ) {};
+
+        /// Konstruktor
+        IngredientRecord( unsigned int n, unsigned int u, int q ) :name( n ), unit( u ), quantity( q ) {};
+    };
+
+    /**
+     * IngredientTable osztály
+     * Alapanyagok tömör tárolása: IngredientRecord-ok tömbje és a nevek, mértékegységek táblái.
+     * Egy alapanyag az Ingredient/IngredientQ ~100 bájtja (vptr, két String, két külön foglalt karaktertömb,
+     * listaelem) helyett 12 bájt; a nevek és mértékegységek csak egyszer tárolódnak.
+     */
+    class IngredientTable
+    {
+    private:
+        NameTable names;                        /// Alapanyagnevek
+        NameTable units;                        /// Mértékegységek
+        std::vector<IngredientRecord> records;  /// Rekordok felvételi sorrendben
+
+    public:
+        /// Alapanyag felvétele
+        /// @return size_t - a rekord indexe
+        size_t add( const char* name, size_t nameLength, const char* unit, size_t unitLength, int quantity );
+        size_t add( const String& name, const String& unit, int quantity ) { return add( name.c_str(), name.size(), unit.c_str(), unit.size(), quantity ); }
+        size_t add( const Ingredient& ingredient );
+        size_t add( const IngredientQ& ingredient );
+
+        /// Egy lista összes elemének felvétele
+        /// @param list - Ingredient vagy IngredientQ lista
+        template<typename T>
+        void addAll( const LinkedList<T>& list )
+        {
+            for ( typename LinkedList<T>::Iterator it( list ); it != typename LinkedList<T>::Iterator(); it++ ) add( *it );
+        }
+
+        /// Előre lefoglal n rekordnak helyet
+        void reserve( size_t n ) { records.reserve( n ); }
+
+        /// Rekordok száma
+        size_t size() const { return records.size(); }
+
+        /// Rekord elérése
+        const IngredientRecord& operator[]( size_t index ) const { return records[index]; }
+        IngredientRecord& operator[]( size_t index ) { return records[index]; }
+
+        /// Név- és mértékegységtábla
+        const NameTable& getNames() const { return names; }
+        const NameTable& getUnits() const { return units; }
+
+        /// Rekord visszaalakítása IngredientQ-vá
+        /// @param index - a rekord indexe
+        IngredientQ expand( size_t index ) const;
+
+        friend MemoryUsage memoryUsageOf( const IngredientTable& table );
+    };
+
+    /**
+     * IngredientPrinter osztály
+     * A tömör rekordok kiírása az Ingredient/IngredientQ::printDetails formátumában
+     */
+    class IngredientPrinter
+    {
+    private:
+        const IngredientTable& table;   /// A rekordok táblája
+
+    public:
+        /// Konstruktor
+        /// @param t - a kiírandó rekordok táblája
+        explicit IngredientPrinter( const IngredientTable& t ) :table( t ) {};
+
+        /// Egy rekord kiírása
+        /// @param ostream - kimenet
+        /// @param record - rekord
+        /// @param withQuantity - IngredientQ (név mennyiség+egység) vagy Ingredient (név (egység)) formátum
+        void print( std::ostream& ostream, const IngredientRecord& record, bool withQuantity = true ) const;
+
+        /// Az összes rekord kiírása számozott listaként (mint LinkedList::printOrderedList)
+        void printOrderedList( std::ostream& ostream, bool withQuantity = true, bool displayEmpty = false, int from = 1 ) const;
+    };
+
+    /// Névtábla memóriahasználata
+    MemoryUsage memoryUsageOf( const NameTable& table );
+
+    /// Alapanyagtábla memóriahasználata
+    MemoryUsage memoryUsageOf( const IngredientTable& table );
+}
+
+#endif // NHF4_COMPACT_H
@@ -4,6 +4,7 @@
  * Ez a fájl tartalmazza az adatszerkezetet megvalósító osztályok tagfüggvényeinek megvalósítását
  */
 
+#include <cstring>
 #include "components.h"
 
 void Components::Ingredient::printDetails( std::ostream& ostream ) const {
@@ -14,11 +15,11 @@ bool Components::Ingredient::operator==(const Ingredient &other) const {
     return getName() == other.getName();
 }
 
-String Components::Ingredient::getName() const {
+const String& Components::Ingredient::getName() const {
     return this->name;
 }
 
-String Components::Ingredient::getUnit() const {
+const String& Components::Ingredient::getUnit() const {
     return this->unit;
 }
 
@@ -44,37 +45,73 @@ void Components::IngredientQ::setQuantity(unsigned int _quantity) {
 
 void Components::Recipe::printDetails(std::ostream& ostream) const {
     ostream << title;
+    if ( id.valid() ) ostream << " (" << id << ")";
 }
 
 bool Components::Recipe::operator==(const Components::Recipe &other) const {
-    return getTitle() == other.getTitle();
+    return title == other.title;
 }
 
-String Components::Recipe::getTitle() const {
-    return this->title;
+void Components::Recipe::setTitle(const String &_title) {
+    this->title = _title;
 }
 
-Components::LinkedList<Components::IngredientQ> *Components::Recipe::getIngredients() const {
-    return this->ingredients;
+
+Components::MemoryUsage Components::memoryUsageOf( const Ingredient& ingredient ) {
+    MemoryUsage usage = memoryUsageOf( ingredient.name );
+    usage += memoryUsageOf( ingredient.unit );
+    usage.objects = 1;
+    usage.overhead += sizeof( Ingredient ) - 2 * sizeof( String );
+    return usage;
 }
 
-Components::LinkedList<String> *Components::Recipe::getInstructions() const {
-    return this->instructions;
+Components::MemoryUsage Components::memoryUsageOf( const IngredientQ& ingredient ) {
+    MemoryUsage usage = memoryUsageOf( static_cast<const Ingredient&>( ingredient ) );
+    usage.payload += sizeof( ingredient.quantity );
+    usage.overhead += sizeof( IngredientQ ) - sizeof( Ingredient ) - sizeof( ingredient.quantity );
+    return usage;
 }
 
-void Components::Recipe::setTitle(const String &_title) {
-    this->title = _title;
+Components::MemoryUsage Components::memoryUsageOf( const Recipe& recipe ) {
+    MemoryUsage usage = memoryUsageOf( recipe.getTitle() );
+    usage += recipe.getIngredients()->memoryUsage();
+    usage += recipe.getInstructions()->memoryUsage();
+    usage.objects = 1;
+    usage.overhead += sizeof( Recipe ) - sizeof( String ) - sizeof( LinkedList<IngredientQ> ) - sizeof( LinkedList<String> );
+    return usage;
 }
 
-void Components::Recipe::setIngredients(Components::LinkedList<Components::IngredientQ> *_in) {
-    this->ingredients = _in;
+bool Components::TitleKey::operator<(const Components::TitleKey &other) const {
+    int cmp = strcmp( title.c_str(), other.title.c_str() );
+    if ( cmp != 0 ) return cmp < 0;
+    return id < other.id;
 }
 
-void Components::Recipe::setInstructions(Components::LinkedList<String> *_ins) {
-    this->instructions = _ins;
+bool Components::Handle::looksLike(const std::string &text) {
+    std::string tmp = text;
+    trim( tmp );
+    return !tmp.empty() && ( tmp[0] == '#' || tmp.find( '.' ) != std::string::npos );
+}
+
+bool Components::Handle::parse(const std::string &text, Components::Handle &out) {
+    std::string tmp = text;
+    trim( tmp );
+    if ( !tmp.empty() && tmp[0] == '#' ) tmp.erase( 0, 1 );
+
+    size_t dot = tmp.find( '.' );
+    if ( dot == std::string::npos || dot == 0 || dot + 1 >= tmp.size() ) return false;
+    if ( tmp.find_first_not_of( "0123456789." ) != std::string::npos || tmp.find( '.', dot + 1 ) != std::string::npos ) return false;
+
+    try {
+        unsigned long index = std::stoul( tmp.substr( 0, dot ) );
+        unsigned long generation = std::stoul( tmp.substr( dot + 1 ) );
+        if ( index >= Handle::INVALID || generation > 0xffffffffUL ) return false;
+        out = Handle( (unsigned int)index, (unsigned int)generation );
+    } catch ( std::exception& ex ) { return false; }
+
+    return true;
 }
 
-Components::Recipe::~Recipe() {
-    if ( ingredients != nullptr ) delete ingredients;
-    if ( instructions != nullptr ) delete instructions;
+std::ostream& Components::operator<<(std::ostream &os, const Components::Handle &h) {
+    return os << "#" << h.index << "." << h.generation;
 }
@@ -6,9 +6,17 @@
  * Ez a fájl tartalmazza az adatszerkezetet megvalósító osztályokat
  */
 
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <string>
+#include <utility>
 #include "./memtrace.h"
 #include "./string5.h"
 #include "./list.h"
+#include "./memusage.h"
+#include "./slotmap.h"
+#include "./skiplist.h"
 
 
 /// Inline függvény, a paraméterként adott szting elejéről eltávolítja az összes space-t
@@ -37,6 +45,8 @@ inline std::string &trim(std::string &s) {
 
 namespace Components
 {
+    class IngredientTable;
+
     /**
      * Ingredient osztály
      * Alapanyagokat tároló osztály
@@ -52,18 +62,25 @@ namespace Components
         /// Inicializálja az alapanyag nevét és mértékegységét
         /// @param _name - alapanyag neve
         /// @param _unit - alapanyag mértékegysége
-        Ingredient( String _name, String _unit ) :name(_name), unit(_unit) {};
+        Ingredient( String _name, String _unit ) :name( std::move(_name) ), unit( std::move(_unit) ) {};
 
         /// Default konstruktor
         Ingredient() {};
 
+        /// Másoló és mozgató műveletek
+        /// A virtuális destruktor miatt a mozgatást explicit kérni kell, különben mindig másolna
+        Ingredient( const Ingredient& ) = default;
+        Ingredient( Ingredient&& ) = default;
+        Ingredient& operator=( const Ingredient& ) = default;
+        Ingredient& operator=( Ingredient&& ) = default;
+
         /// Alapanyag neve getter
-        /// @return String - alapayag neve
-        String getName() const;
+        /// @return const String& - alapayag neve
+        const String& getName() const;
 
         /// Alapanyag mértékegysége getter
-        /// @return String - alapanyag mértékegysége
-        String getUnit() const;
+        /// @return const String& - alapanyag mértékegysége
+        const String& getUnit() const;
 
         /// Alapanyag neve setter
         /// @param _name - név
@@ -85,6 +102,9 @@ namespace Components
 
         /// Virtuális destruktor
         virtual ~Ingredient() {};
+
+        friend MemoryUsage memoryUsageOf( const Ingredient& ingredient );
+        friend class IngredientTable;
     };
 
     /**
@@ -102,7 +122,7 @@ namespace Components
         /// @param _name - alapanyag neve
         /// @param _unit - alapanyag mennyisége
         /// @param _quantity - alapanyag mennyisége
-        IngredientQ( String _name, String _unit, unsigned int _quantity ) :Ingredient(_name, _unit), quantity(_quantity) {};
+        IngredientQ( String _name, String _unit, unsigned int _quantity ) :Ingredient( std::move(_name), std::move(_unit) ), quantity(_quantity) {};
 
         /// Default konstruktor
         IngredientQ() {};
@@ -119,58 +139,104 @@ namespace Components
         /// @param ostream - standard output
         void printDetails( std::ostream& ostream ) const;
 
-        /// Destruktor
-        ~IngredientQ() {};
+        friend MemoryUsage memoryUsageOf( const IngredientQ& ingredient );
+        friend class IngredientTable;
+    };
+
+    /**
+     * TextRange osztály
+     * Egy fájlrészlet helye (bájt eltolás és hossz) - a lusta betöltéshez
+     */
+    struct TextRange
+    {
+        long long offset;   /// Az első bájt eltolása a fájl elejéhez képest (-1, ha érvénytelen)
+        long long length;   /// Hossz bájtban
+
+        /// Default konstruktor - érvénytelen tartomány
+        TextRange() :offset( -1 ), length( 0 ) {};
+
+        /// Konstruktor
+        /// @param o - eltolás
+        /// @param l - hossz
+        TextRange( long long o, long long l ) :offset( o ), length( l ) {};
+
+        /// Érvényes-e a tartomány
+        bool valid() const { return offset >= 0; }
     };
 
     /**
      * Recipe osztály
      * Recepteket tároló osztály
+     * A listákat érték szerint birtokolja, így a másolás mély, a mozgatás pedig O(1)
+     * (a fordító által generált másoló/mozgató műveletek a tagok műveleteit hívják)
      */
     class Recipe
     {
     private:
         String title;   /// Recept neve
-        LinkedList<IngredientQ>* ingredients;   /// Alapanyaglista
-        LinkedList<String>* instructions;       /// Instrukció-lista
+        LinkedList<IngredientQ> ingredients;    /// Alapanyaglista
+        LinkedList<String> instructions;        /// Instrukció-lista
+        Handle id;                              /// Stabil azonosító (a vezérlő osztja ki)
+        TextRange instructionRange;             /// Ha érvényes, az instrukciók még nincsenek betöltve, a fájlban itt vannak
 
     public:
-        /// Explicit Konstruktor
-        /// null-lal inicializálja a listákat
-        explicit Recipe() :title(), ingredients( nullptr ), instructions( nullptr ) {};
+        /// Default konstruktor
+        /// Üres listákkal inicializál
+        Recipe() :title(), ingredients(), instructions(), id(), instructionRange() {};
+
+        /// Konstruktor
+        /// Csak a nevet inicializálja (pl. név szerinti kereséshez)
+        /// @param tit - recept neve
+        explicit Recipe( const String& tit ) :title( tit ), ingredients(), instructions(), id(), instructionRange() {};
 
         /// Konstruktor
-        /// Inicializálja a recept nevét, és a listákat
+        /// Inicializálja a recept nevét, és átveszi a listákat (nincs másolás)
         /// @param tit - recept neve
-        /// @param inst - instrukciólista pointere
-        /// @param ing - alapanyaglista pointere
-        Recipe( const String& tit, LinkedList<IngredientQ>* ing, LinkedList<String>* inst )
-            :title( tit ), ingredients( ing ), instructions( inst ) {};
+        /// @param ing - alapanyaglista
+        /// @param inst - instrukciólista
+        Recipe( String&& tit, LinkedList<IngredientQ>&& ing, LinkedList<String>&& inst )
+            :title( std::move( tit ) ), ingredients( std::move( ing ) ), instructions( std::move( inst ) ), id(), instructionRange() {};
 
         /// Recept név getter
         /// @return String - recept neve
-        String getTitle() const;
+        const String& getTitle() const { return title; }
 
         /// Alapanyaglista getter
         /// @return alapanyaglistára mutató pointer
-        LinkedList<IngredientQ>* getIngredients() const;
+        LinkedList<IngredientQ>* getIngredients() { return &ingredients; }
+        const LinkedList<IngredientQ>* getIngredients() const { return &ingredients; }
 
         /// Instrukciólista getter
         /// @return instrukciólistára mutató pointer
-        LinkedList<String>* getInstructions() const;
+        LinkedList<String>* getInstructions() { return &instructions; }
+        const LinkedList<String>* getInstructions() const { return &instructions; }
+
+        /// Be vannak-e töltve az instrukciók
+        /// Lusta betöltésnél csak a megjelenítéskor, illetve módosításkor olvassuk be őket
+        /// @return bool - igaz, ha az instrukciólista érvényes
+        bool instructionsLoaded() const { return !instructionRange.valid(); }
+
+        /// Az instrukciók helye a fájlban (érvénytelen, ha már be vannak töltve)
+        /// @return TextRange - fájlrészlet
+        const TextRange& getInstructionRange() const { return instructionRange; }
+
+        /// Az instrukciók helyének beállítása
+        /// Érvénytelen tartomány esetén az instrukciólista betöltöttnek számít
+        /// @param range - fájlrészlet
+        void setInstructionRange( const TextRange& range ) { instructionRange = range; }
+
+        /// Azonosító getter
+        /// @return Handle - a recept stabil azonosítója (érvénytelen, ha még nincs kiosztva)
+        Handle getId() const { return id; }
+
+        /// Azonosító setter
+        /// @param _id - azonosító
+        void setId( const Handle& _id ) { id = _id; }
 
         /// Recept név setter
         /// @param _title - név
         void setTitle( const String& _title );
 
-        /// Alapanyaglista setter
-        /// @param _in - listára mutató pointer
-        void setIngredients( LinkedList<IngredientQ>* _in );
-
-        /// Instrukciólista setter
-        /// @param _ins - listára mutató pointer
-        void setInstructions( LinkedList<String>* _ins );
-
         /// Kiírja a recept adatait a megadott standard outputra
         /// @param ostream - standard output
         void printDetails( std::ostream& ostream ) const;
@@ -180,10 +246,37 @@ namespace Components
         /// @param other - kif. jobb oldalán lévő recept
         /// @return bool - egyeznek-e
         bool operator==( const Recipe& other ) const;
+    };
 
-        /// Destruktor
-        /// Felszabadítja a listákat
-        ~Recipe();
+    /// Memóriahasználat kimutatása (lásd memusage.h) - az objektum saját mérete is benne van,
+    /// a szerkezeti többletben a vptr és az igazítás is
+    /// @return MemoryUsage - kimutatás
+    MemoryUsage memoryUsageOf( const Ingredient& ingredient );
+    MemoryUsage memoryUsageOf( const IngredientQ& ingredient );
+    MemoryUsage memoryUsageOf( const Recipe& recipe );
+
+    /**
+     * TitleKey osztály
+     * A receptek rendezett címindexének kulcsa
+     * Kisbetűs cím szerint rendez, azonos cím esetén az azonosító dönt
+     */
+    struct TitleKey
+    {
+        String title;   /// Kisbetűs cím
+        Handle id;      /// A recept azonosítója
+
+        /// Default konstruktor
+        TitleKey() {};
+
+        /// Konstruktor
+        /// @param t - recept címe (kisbetűsítjük)
+        /// @param h - recept azonosítója
+        TitleKey( const String& t, const Handle& h ) :title( t ), id( h ) { title.toLower(); };
+
+        /// operator<
+        /// @param other - kif. jobb oldala
+        /// @return bool - előrébb van-e a rendezésben
+        bool operator<( const TitleKey& other ) const;
     };
 }
 
@@ -7,10 +7,18 @@
 #include "controller.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include "file.h"
 #include "memtrace.h"
 #include "components.h"
+#include "search.h"
+#include "shopping.h"
+#include "stats.h"
 
 using namespace File;
 using namespace Components;
@@ -19,251 +27,460 @@ using std::endl;
 using std::cerr;
 using std::stringstream;
 
+namespace
+{
+    /// Vesszővel felsorolt hozzávalók ("nev mertekegyseg mennyiseg") feldolgozása
+    /// A hibás elemeket kihagyja, és a hibaüzenetet a megadott kimenetre írja
+    /// @param buffer - input
+    /// @param ingredients - ide kerülnek a hozzávalók
+    /// @param err - hibaüzenetek kimenete
+    void parseIngredients( const std::string& buffer, LinkedList<IngredientQ>& ingredients, std::ostream& err )
+    {
+        stringstream line( buffer );
+        std::string segment;
 
-// Keresést megvalósító funktorok
+        while ( std::getline( line, segment, ',' ) )
+        {
+            stringstream element( segment );
+            std::vector<std::string> list;
+            std::string piece;
+
+            while ( std::getline( element, piece, ' ' ) )
+            {
+                list.push_back( piece );
+            }
+
+            if ( list.size() != 3 ) { err << "Nem megfelelo hozzavalo! Kapott input: \"" + element.str() + "\"" << endl; continue; }
+
+            int number;
+            try {
+                number = std::stoi( list[2] );
+            }
+            catch ( std::invalid_argument& e ) { err << "Hibas szam! Kapott input: \"" + list[2] + "\"" << endl; continue; }
+            catch ( std::out_of_range& e ) { err << "Hibas szam! Kapott input: \"" + list[2] + "\"" << endl; continue; }
+
+            IngredientQ c_ing = IngredientQ( String(list[0].c_str()), String(list[1].c_str()), number );
+            if ( ingredients.indexOf( c_ing ) != -1 ) { err << "A megadott elem mar szerepel a listaban! Kapott input: \"" + list[0] + "\"" << endl; continue; }
+            ingredients.push( std::move( c_ing ) );
+        }
+    }
 
-/**
- * title_contains funktor
- * generikus kereséshez szükséges
- * a recept címében keresi meg a megadott szövegrészletet
- */
-class title_contains
-{
-    String compare; /// Megadott szövegrészlet
-public:
-    /// Konstruktor
-    /// Inicializálja a keresett szöveget
-    title_contains(String const &cmp): compare(cmp) {};
+    /// A feltételnek megfelelő receptek kiírása (sorszám, név, azonosító) a pillanatképből
+    /// @param catalog - a receptek pillanatképe
+    /// @param match - keresési feltétel (funktor)
+    /// @param out - kimenet
+    /// @return size_t - találatok száma
+    template<class Func>
+    size_t writeMatching( const Catalog& catalog, const Func& match, std::ostream& out )
+    {
+        size_t hits = 0;
+        for ( size_t i = 0; i < catalog.size(); i++ )
+        {
+            const Recipe& recipe = catalog.at( i );
+            if ( match( recipe ) ) { out << ( i + 1 ) << ". " << recipe.getTitle() << " (" << recipe.getId() << ")" << '\n'; hits++; }
+        }
+
+        STATS_COUNT( NODES_VISITED, catalog.size() );
+        STATS_COUNT( COMPARISONS, catalog.size() );
+        return hits;
+    }
 
-    /// operator()
-    /// szerepel-e a címben a keresett szöveg
-    /// @param item - aktuális recept
-    /// @return bool - sikeres találat esetén igaz
-    bool operator()(Recipe const &item) const
+    /// Recept kiválasztása a pillanatképből sorszám (1-től) vagy azonosító (#index.generacio) alapján
+    /// Hiba esetén a hibaüzenetet a megadott kimenetre írja
+    /// @param catalog - a receptek pillanatképe
+    /// @param buffer - input
+    /// @param err - hibaüzenetek kimenete
+    /// @return const Recipe* - a kiválasztott recept, hiba esetén nullptr
+    const Recipe* lookupEntry( const Catalog& catalog, const std::string& buffer, std::ostream& err )
     {
-        String title( item.getTitle() );
-        title.toLower();
-        String comp( compare );
-        comp.toLower();
+        if ( Handle::looksLike( buffer ) )
+        {
+            Handle id;
+            if ( !Handle::parse( buffer, id ) ) { err << "Hibas azonosito! Kapott input: \"" + buffer + "\"" << endl; return nullptr; }
+
+            const Recipe* recipe = catalog.find( id );
+            if ( recipe == nullptr ) err << "Nem talalhato a megadott azonositoju recept! Kapott input: \"" + buffer + "\"" << endl;
+            return recipe;
+        }
 
-        return title.find(comp);
+        int item;
+        try {
+            item = (std::stoi( buffer ))-1;
+            if ( item < 0 || (size_t)item >= catalog.size() ) throw std::out_of_range( "hibas elem" );
+        }
+        catch ( std::invalid_argument& ex ) { err << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return nullptr; }
+        catch ( std::out_of_range& ex ) { err << "Nem talalhato a megadott elem! Kapott input: \"" + buffer + "\"" << endl; return nullptr; }
+
+        return &catalog.at( item );
     }
-};
 
-/**
- * ingredient_contains funktor
- * generikus kereséshez szükséges
- * a recept hozzávalólistájában keresi meg a megadott alapanyagokat
- */
-class ingredient_contains
-{
-    LinkedList<Ingredient>& ingredients; /// Keresett alapanyagok
-public:
-    /// Konstruktor
-    /// Inicializáljuk a keresett alapanyagokat
-    ingredient_contains( LinkedList<Ingredient>& list ) :ingredients( list ) {};
-
-    /// operator()
-    /// a megadott alapanyaglista összes elemét megkeresi az aktuális recept hozzávalói között
-    /// @param item - aktuális recept
-    /// @return bool - sikeres találat esetén igaz
-    bool operator()(Recipe const &item) const
-    {
-        LinkedList<Ingredient>::Iterator start = ingredients.begin();
-        for ( ; start != ingredients.end(); start++ )
+    /// Vesszővel felsorolt instrukciók feldolgozása kódolás nélkül (lemezes receptkönyvhöz)
+    /// @param buffer - input
+    /// @param instructions - ide kerülnek az instrukciók
+    void splitInstructions( const std::string& buffer, LinkedList<String>& instructions )
+    {
+        stringstream line( buffer );
+        std::string segment;
+
+        while ( std::getline( line, segment, ',' ) )
         {
-            IngredientQ* element = (IngredientQ*)(&*start);
-            if ( !item.getIngredients()->contains( element ) ) return false;
+            instructions.emplace( segment.c_str() );
         }
-        return true;
     }
-};
 
+    /// Kisbetűs másolat
+    std::string lowerText( const std::string& text )
+    {
+        std::string result( text );
+        for ( size_t i = 0; i < result.size(); i++ ) result[i] = (char)tolower( (unsigned char)result[i] );
+        return result;
+    }
+
+    /// A címben keresés gyorsítótár-kulcsa
+    /// A title_contains kisbetűsítve hasonlít, így a kisbetűs kérdés azonos feltételt jelent
+    /// @param query - a keresett szövegrészlet
+    /// @return std::string - kulcs
+    std::string titleQueryKey( const std::string& query )
+    {
+        std::string key = "T:" + query;
+        for ( size_t i = 2; i < key.size(); i++ ) key[i] = (char)tolower( key[i] );
+        return key;
+    }
 
-Controller::Controller()
+    /// A hozzávalók alapján keresés gyorsítótár-kulcsa
+    /// Az ingredient_contains az összes alapanyagot keresi (ÉS), így a sorrend és az ismétlés nem számít
+    /// @param ingredients - a keresett alapanyagok
+    /// @return std::string - kulcs
+    std::string ingredientQueryKey( LinkedList<Ingredient>& ingredients )
+    {
+        std::vector<std::string> names;
+        for ( LinkedList<Ingredient>::Iterator it = ingredients.begin(); it != ingredients.end(); it++ )
+            names.push_back( it->getName().c_str() );
+        std::sort( names.begin(), names.end() );
+        names.erase( std::unique( names.begin(), names.end() ), names.end() );
+
+        std::string key = "I:";
+        for ( size_t i = 0; i < names.size(); i++ ) key += ( i ? "," : "" ) + names[i];
+        return key;
+    }
+
+    /**
+     * resolve_recipe funktor
+     * összetett kereséshez szükséges: azonosító alapján adja vissza a receptet
+     */
+    class resolve_recipe
+    {
+        const Controller& controller; /// A receptek tulajdonosa
+    public:
+        explicit resolve_recipe( const Controller& c ) :controller( c ) {};
+
+        const Recipe* operator()( const Handle& id ) const { return controller.findRecipe( id ); }
+    };
+
+    /**
+     * count_steps funktor
+     * összetett kereséshez szükséges: a recept lépéseinek (instrukcióinak) száma
+     * Lusta módban a be nem töltött instrukciókat a közös, már megnyitott forrásfájlból (pread) számolja meg,
+     * de nem tölti be őket - jelöltenként nem nyit új fájlt
+     */
+    class count_steps
+    {
+        const Source* source; /// A be nem töltött instrukciók fájlja (lehet nullptr)
+    public:
+        explicit count_steps( const Source* file ) :source( file ) {};
+
+        int operator()( const Recipe& recipe ) const
+        {
+            if ( recipe.instructionsLoaded() ) return recipe.getInstructions()->size();
+            if ( source == nullptr ) { cerr << "Az instrukciok nem erhetok el!" << endl; return -1; }
+
+            LinkedList<String> lines;
+            try {
+                source->readRange( recipe.getInstructionRange(), lines );
+            } catch ( std::ifstream::failure& ex ) { cerr << ex.what() << endl; return -1; }
+            return lines.size();
+        }
+    };
+
+    /// Alapanyag- vagy kamrafájl betöltése (külön szálon is futtatható)
+    /// Hiba esetén a hibaüzenetet a hibakimenetre írja
+    /// @param path - fájl útvonala
+    /// @param list - ide kerülnek az elemek
+    /// @param parse - a Reader megfelelő parse függvénye
+    template<class T>
+    void loadList( const char* path, LinkedList<T>& list, void (Reader::*parse)( LinkedList<T>& ) )
+    {
+        Reader reader( path );
+        try {
+            reader.read();
+            (reader.*parse)( list );
+        } catch ( std::ifstream::failure& ex ) { cerr << ex.what() << endl; }
+    }
+
+    /// Alapanyag- vagy kamralista mentése (külön szálon is futtatható)
+    /// Hiba esetén a hibaüzenetet a hibakimenetre írja
+    /// @param path - fájl útvonala
+    /// @param list - mentendő lista
+    /// @param success - sikeres mentéskor nő
+    template<class T>
+    void saveList( const char* path, LinkedList<T>& list, std::atomic<int>& success )
+    {
+        Writer writer( path );
+        try {
+            writer.parse( list );
+            writer.write();
+            success++;
+        } catch ( std::ofstream::failure& ex ) { cerr << ex.what() << endl; }
+    }
+
+    /// Vesszővel felsorolt instrukciók feldolgozása és kódolása
+    /// @param buffer - input
+    /// @param codec - tömörítő szótár
+    /// @param instructions - ide kerülnek a kódolt instrukciók
+    void parseInstructions( const std::string& buffer, const TextCodec& codec, LinkedList<String>& instructions )
+    {
+        stringstream line( buffer );
+        std::string segment;
+
+        while ( std::getline( line, segment, ',' ) )
+        {
+            instructions.emplace( codec.encode( segment ).c_str() );
+        }
+    }
+}
+
+
+Controller::Controller( bool lazy, const std::string& storePath, size_t storeBudget )
     :ingredientList( LinkedList<Ingredient>() ),
      pantryList( LinkedList<IngredientQ>() ),
-     recipeList( LinkedList<Recipe>() )
+     recipeList( LinkedList<Recipe>() ),
+     lazyInstructions( lazy ),
+     fuzzySearch( true ),
+     paging( false ),
+     publishing( false ),
+     searchCache( CACHE_ENTRIES, CACHE_HITS )
 {
-    Reader recipeReader = Reader( "recipes.dat" );
-    try {
-        recipeReader.read();
-        recipeReader.parseRecipe( recipeList );
-    } catch ( std::ifstream::failure& ex ) { cerr << ex.what() << endl; }
+    STATS_TIMER( OP_LOAD );
 
-    Reader ingredientReader = Reader( "ingredients.dat" );
-    try {
-        ingredientReader.read();
-        ingredientReader.parseIngredient( ingredientList );
-    } catch ( std::ifstream::failure& ex ) { cerr << ex.what() << endl; }
+    if ( !storePath.empty() )
+    {
+        try {
+            store.reset( new RecipeStore( String( storePath.c_str() ), storeBudget ) );
+        } catch ( std::ifstream::failure& ex ) { cerr << ex.what() << endl; }
+    }
 
-    Reader pantryReader = Reader( "pantry.dat" );
-    try {
-        pantryReader.read();
-        pantryReader.parseIngredientQ( pantryList );
-    } catch ( std::ifstream::failure& ex ) { cerr << ex.what() << endl; }
-}
+    // A három fájl egyszerre töltődik: az alapanyagok és a kamra külön szálon
+    std::thread ingredientLoader( loadList<Ingredient>, "ingredients.dat", std::ref( ingredientList ), &Reader::parseIngredient );
+    std::thread pantryLoader( loadList<IngredientQ>, "pantry.dat", std::ref( pantryList ), &Reader::parseIngredientQ );
 
-Controller::~Controller() {
-    int success = 0;
+    // Lemezes receptkönyvnél a recipes.dat csak az első indításkor töltődik be, teljesen
+    if ( !store || !store->imported() )
+    {
+        Reader recipeReader = Reader( "recipes.dat", lazy && !store );
+        try {
+            recipeReader.read();
+            recipeReader.parseRecipe( recipeList, instructionCodec );
+        } catch ( std::ifstream::failure& ex ) { cerr << ex.what() << endl; }
+    }
 
-    Writer recipeWriter = Writer( "recipes.dat" );
-    try {
-        recipeWriter.parse( recipeList );
-        recipeWriter.write();
-        success++;
-    } catch ( std::ofstream::failure& ex ) { cerr << ex.what() << endl; }
+    ingredientLoader.join();
+    pantryLoader.join();
 
-    Writer ingredientWriter = Writer( "ingredients.dat" );
-    try {
-        ingredientWriter.parse( ingredientList );
-        ingredientWriter.write();
-        success++;
-    } catch ( std::ofstream::failure& ex ) { cerr << ex.what() << endl; }
+    if ( store ) importToStore();
 
-    Writer pantryWriter = Writer( "pantry.dat" );
-    try {
-        pantryWriter.parse( pantryList );
-        pantryWriter.write();
-        success++;
-    } catch ( std::ofstream::failure& ex ) { cerr << ex.what() << endl; }
+    for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+        registerRecipe( it );
+
+    // Lusta módban a be nem töltött instrukciók egy közös, nyitva tartott fájlból olvashatók
+    openInstructionSource();
+
+    indexNames( ingredientList, true );
+    indexNames( pantryList, true );
+}
+
+Controller::~Controller() {
+    bool saved = save();
+
+    // Ha meg van adva, kilépéskor kiírjuk a statisztikát a megadott fájlba
+    const char* statsPath = std::getenv( "NHF_STATS_DUMP" );
+    if ( statsPath != nullptr && Stats::enabled() )
+    {
+        std::ofstream statsFile( statsPath );
+        if ( statsFile.is_open() ) Stats::dumpJson( statsFile );
+        else cerr << "Hiba tortent a(z) \"" << statsPath << "\" megnyitasa kozben!" << endl;
+    }
 
-    success == 3 ? cout << endl << "[Az adatok mentesre kerultek a fajlokba]" : cout << endl << "[Hiba tortent az adatok mentese soran]";
+    saved ? cout << endl << "[Az adatok mentesre kerultek a fajlokba]" : cout << endl << "[Hiba tortent az adatok mentese soran]";
 }
 
 // Publikus metódusok
+bool Controller::save() {
+    STATS_TIMER( OP_SAVE );
+    std::atomic<int> success( 0 );
+
+    // A három fájl egyszerre íródik: az alapanyagok és a kamra külön szálon
+    std::thread ingredientSaver( saveList<Ingredient>, "ingredients.dat", std::ref( ingredientList ), std::ref( success ) );
+    std::thread pantrySaver( saveList<IngredientQ>, "pantry.dat", std::ref( pantryList ), std::ref( success ) );
+
+    // A lemezes receptkönyv nem íródik újra, csak a módosult lapjai
+    if ( store )
+    {
+        try {
+            store->flush();
+            success++;
+        } catch ( std::ofstream::failure& ex ) { cerr << ex.what() << endl; }
+    }
+    else
+    {
+        // A közzétett pillanatképek a szótárt közösen használják, ezért közben nem tanítható
+        if ( instructionCodec.size() == 0 && !publishing ) trainCodec();
+
+        Writer recipeWriter = Writer( "recipes.dat" );
+        try {
+            recipeWriter.parse( recipeList, instructionCodec );
+            recipeWriter.write();
+            success++;
+
+            // A be nem töltött instrukciók az új fájlban máshol vannak
+            const std::vector<TextRange>& ranges = recipeWriter.instructionRanges();
+            size_t i = 0;
+            for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++, i++ )
+                if ( !it->instructionsLoaded() ) it->setInstructionRange( ranges[i] );
+
+            // Az új helyek az új fájlra vonatkoznak; a pillanatképek is ezt használják (a régiek a régi fájlt látják)
+            openInstructionSource();
+            if ( publishing ) publish( Handle() );
+        } catch ( std::ofstream::failure& ex ) { cerr << ex.what() << endl; }
+    }
+
+    ingredientSaver.join();
+    pantrySaver.join();
+    return success == 3;
+}
 void Controller::listRecipes() {
     cout << "[Receptek listazasa]" << endl;
-    recipeList.printOrderedList( cout, true );
+    if ( store ) { listRecipesSorted(); return; }
+    printPaged( recipeList );
+}
+void Controller::listRecipesSorted() {
+    cout << "[Receptek listazasa abc sorrendben]" << endl;
+    if ( recipeCount() == 0 ) { cout << "A lista ures." << endl; return; }
+    if ( store ) { printStoredTitles( std::string(), std::string() ); return; }
+
+    printTitleRange( 0, titleIndex.size() );
 }
 void Controller::displayRecipe() {
     cout << "[Recept megtekintese]" << endl;
-    if ( recipeList.size() < 1 ) { cout << "A  receptes lista ures!" << endl; return; }
+    if ( recipeCount() < 1 ) { cout << "A  receptes lista ures!" << endl; return; }
 
     std::string buffer;
-    cout << "Hanyadik receptet akarod megtekinteni? ";
+    cout << "Hanyadik receptet akarod megtekinteni? (sorszam vagy #azonosito) ";
     std::getline( std::cin, buffer );
 
-    int item;
-    try {
-        item = (std::stoi( buffer ))-1;
-        if ( recipeList.size() < 1 || ( item < 0 || item >= recipeList.size() ) ) throw std::out_of_range( "hibas elem" );
+    if ( store )
+    {
+        Recipe stored;
+        if ( !selectStored( buffer, stored ) ) return;
+
+        cout << String("[") + stored.getTitle() + "]\nHozzavalok: " << endl;
+        stored.getIngredients()->printOrderedList( cout, true );
+        cout << "Instrukciok: " << endl;
+        stored.getInstructions()->printOrderedList( cout, true );
+        return;
     }
-    catch ( std::invalid_argument& ex ) { cerr << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return; }
-    catch ( std::out_of_range& ex ) { cerr << "Nem talalhato a megadott elem! Kapott input: \"" + buffer + "\"" << endl; return; };
 
-    Recipe* recipe;
-    try {
-        recipe = recipeList.get( item );
-    } catch( std::exception& ex ) { cerr << "A megadott elem nem szerepel a listaban! Kapott input: \"" << item << "\""; return; }
+    Recipe* recipe = selectRecipe( buffer );
+    if ( recipe == nullptr ) return;
 
     cout << String("[") + recipe->getTitle() + "]\nHozzavalok: " << endl;
     recipe->getIngredients()->printOrderedList( cout, true );
 
     cout << "Instrukciok: " << endl;
-    recipe->getInstructions()->printOrderedList( cout, true );
+    if ( loadInstructions( *recipe ) ) decodeInstructions( *recipe ).printOrderedList( cout, true );
 }
 void Controller::addRecipe() {
     cout << "[Recept hozzadasa]" << endl;
 
-    Recipe* current = new Recipe();
     std::string buffer;
 
     cout << "Recept neve: ";
     std::getline( std::cin, buffer );
-    if ( trim( buffer ).size() < 1 ) { cerr << "Hibas recept nev!" << endl; delete current; return; }
+    if ( trim( buffer ).size() < 1 ) { cerr << "Hibas recept nev!" << endl; return; }
 
-    current->setTitle( buffer.c_str() );
-    if ( recipeList.indexOf( current ) != -1 ) { cout << "A recept mar szerepel a listaban!" << endl; delete current; return; }
+    String title( buffer.c_str() );
+    bool exists = store ? store->findTitle( title ).valid() : recipeList.contains( Recipe( title ) );
+    if ( exists ) { cout << "A recept mar szerepel a listaban!" << endl; return; }
 
     cout << "Hozzavalok (formatum: (nev mertekegyseg mennyiseg), vesszovel felsorolva): ";
     std::getline( std::cin, buffer );
 
-    LinkedList<IngredientQ>* ingredients = new LinkedList<IngredientQ>();
-    stringstream line( buffer );
-    std::string segment;
-
-    while ( std::getline( line, segment, ',' ) )
-    {
-        stringstream element( segment );
-        std::vector<std::string> list;
-        std::string piece;
-
-        while ( std::getline( element, piece, ' ' ) )
-        {
-            list.push_back( piece );
-        }
-
-        if ( list.size() != 3 ) { cerr << "Nem megfelelo hozzavalo! Kapott input: \"" + element.str() + "\"" << endl; continue; }
-
-        int number;
-        try {
-            number = std::stoi( list[2] );
-        } catch ( std::invalid_argument& e ) { cerr << "Hibas szam! Kapott input: \"" + list[2] + "\"" << endl; continue; }
-
-        IngredientQ c_ing = IngredientQ( String(list[0].c_str()), String(list[1].c_str()), number );
-        if ( ingredients->indexOf( c_ing ) != -1 ) { cerr << "A megadott elem mar szerepel a listaban! Kapott input: \"" + list[0] + "\""; continue; }
-        ingredients->push( c_ing );
-    }
-    current->setIngredients( ingredients );
+    LinkedList<IngredientQ> ingredients;
+    parseIngredients( buffer, ingredients, cerr );
 
     cout << "Instrukciok (vesszovel felsorolva): ";
     std::getline( std::cin, buffer );
 
-    LinkedList<String>* instructions = new LinkedList<String>();
-    stringstream i_line( buffer );
-    std::string i_seg;
+    LinkedList<String> instructions;
+    if ( store ) splitInstructions( buffer, instructions );
+    else parseInstructions( buffer, instructionCodec, instructions );
 
-    while ( std::getline( i_line, i_seg, ',' ) )
+    Handle id;
     {
-        instructions->push( String( i_seg.c_str() ) );
+        STATS_TIMER( OP_ADD_RECIPE );
+        if ( store ) id = store->insert( Recipe( std::move( title ), std::move( ingredients ), std::move( instructions ) ) );
+        else id = registerRecipe( recipeList.emplace( std::move( title ), std::move( ingredients ), std::move( instructions ) ) );
     }
-    current->setInstructions( instructions );
-
-    recipeList.push( *current );
-    cout << "[Recepet sikeresen hozzaadva]" << endl;
-
-    current->setIngredients( nullptr );
-    current->setInstructions( nullptr );
-    delete current;
+    cout << "[Recepet sikeresen hozzaadva]" << endl << "Azonosito: " << id << endl;
 }
 void Controller::removeRecipe() {
     cout << "[Recept torlese]" << endl;
-    if ( recipeList.size() < 1 ) { cout << "A receptes lista ures!" << endl; return; }
-    cout << "Add meg hanyadik elemet szeretned torolni: ";
+    if ( recipeCount() < 1 ) { cout << "A receptes lista ures!" << endl; return; }
+    cout << "Add meg hanyadik elemet szeretned torolni (sorszam vagy #azonosito): ";
 
     std::string buffer;
     std::getline( std::cin, buffer );
 
-    int number;
-    try {
-        number = std::stoi( buffer );
-    } catch ( std::invalid_argument& ex ) { cerr << "Hibas szam!" << endl; return; };
-    number--;
+    if ( store )
+    {
+        Recipe stored;
+        if ( !selectStored( buffer, stored ) ) return;
+        {
+            STATS_TIMER( OP_REMOVE_RECIPE );
+            store->erase( stored.getId() );
+        }
+        cout << "[Recept sikeresen torolve]" << endl;
+        return;
+    }
 
-    try {
-        recipeList.pop( number );
-    } catch ( std::out_of_range& ex ) { cerr << "Nem talalhato a megadott elem! Kapott input: \"" + buffer + "\"" << endl; return; }
+    Recipe* recipe = selectRecipe( buffer );
+    if ( recipe == nullptr ) return;
+
+    {
+        STATS_TIMER( OP_REMOVE_RECIPE );
+        eraseRecipe( recipe->getId() );
+    }
 
     cout << "[Recept sikeresen torolve]" << endl;
 }
 void Controller::modifyRecipe() {
     cout << "[Recept modositasa]" << endl;
-    if ( recipeList.size() < 1 ) { cout << "A  receptes lista ures!" << endl; return; }
+    if ( recipeCount() < 1 ) { cout << "A  receptes lista ures!" << endl; return; }
 
     std::string buffer;
-    cout << "Hanyadik receptet akarod modositani? ";
+    cout << "Hanyadik receptet akarod modositani? (sorszam vagy #azonosito) ";
     std::getline( std::cin, buffer );
 
-    int item;
-    try {
-        item = (std::stoi( buffer ))-1;
-        if ( recipeList.size() < 1 || ( item < 0 || item >= recipeList.size() ) ) throw std::out_of_range( "hibas elem" );
+    if ( store )
+    {
+        Recipe stored;
+        if ( selectStored( buffer, stored ) ) modifyStored( stored );
+        return;
     }
-    catch ( std::invalid_argument& ex ) { cerr << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return; }
-    catch ( std::out_of_range& ex ) { cerr << "Nem talalhato a megadott elem! Kapott input: \"" + buffer + "\"" << endl; return; };
 
-    Recipe* selected = recipeList.get( item );
+    Recipe* selected = selectRecipe( buffer );
+    if ( selected == nullptr ) return;
+
+    int item;
 
     cout << "1. Cim modositasa | 2. Hozzavalok modositasa | 3. Instrukciok modositasa | 4. Megse\nValassz muveletet: ";
     std::getline( std::cin, buffer );
@@ -284,18 +501,48 @@ void Controller::modifyRecipe() {
             tmp.erase(end_pos, tmp.end());
 
             if ( tmp.size() < 1 ) { cerr << "Hibas nev! Kapott input: \"" + buffer + "\"" << endl; return; }
-            if ( recipeList.contains( Recipe(String(tmp.c_str()), nullptr, nullptr) ) ) { cerr << "A megadott nev foglalt!" << endl; cout << "[Recept modositasa sikertelen]" << endl; return; }
-            selected->setTitle( String( buffer.c_str() ) );
+
+            bool taken;
+            {
+                STATS_TIMER( OP_MODIFY_RECIPE );
+                taken = recipeList.contains( Recipe( String( tmp.c_str() ) ) );
+                if ( !taken )
+                {
+                    titleIndex.erase( TitleKey( selected->getTitle(), selected->getId() ) );
+                    selected->setTitle( String( buffer.c_str() ) );
+                    titleIndex.insert( TitleKey( selected->getTitle(), selected->getId() ) );
+                    recipeList.touch();
+                }
+            }
+            if ( taken ) { cerr << "A megadott nev foglalt!" << endl; cout << "[Recept modositasa sikertelen]" << endl; return; }
 
         break;
         }
         case 2: {
-            modifyIngredientQ( selected->getIngredients() ) ?
+            indexNames( *selected->getIngredients(), false );
+            bool success = modifyIngredientQ( selected->getIngredients() );
+            {
+                STATS_TIMER( OP_MODIFY_RECIPE );
+                indexNames( *selected->getIngredients(), true );
+                if ( success ) refreshSimilar( selected->getId() );
+                if ( success ) ingredientIndex.update( selected->getId(), *selected );
+                recipeList.touch();
+            }
+            success ?
                 cout << "[Recept sikeresen modositva]" << endl : cout << "[Recept modositasa sikertelen]" << endl;
         return;
         }
         case 3: {
-            modifyStringList(selected->getInstructions()) ?
+            if ( !loadInstructions( *selected ) ) { cout << "[Recept modositasa sikertelen]" << endl; return; }
+            LinkedList<String> plain = decodeInstructions( *selected );
+            bool success = modifyStringList( &plain );
+            if ( success )
+            {
+                STATS_TIMER( OP_MODIFY_RECIPE );
+                encodeInstructions( *selected, plain );
+                recipeList.touch();
+            }
+            success ?
                 cout << "[Recept sikeresen modositva]" << endl : cout << "[Recept modositasa sikertelen]" << endl;
         break;
         }
@@ -308,7 +555,7 @@ void Controller::modifyRecipe() {
 
 void Controller::listIngredients() {
     cout << "[Alapanyagok listazasa]" << endl;
-    ingredientList.printOrderedList( std::cout, true );
+    printPaged( ingredientList );
 }
 void Controller::addIngredient() {
     cout << "[Alapanyag hozzaadasa]\nAdd meg az uj alapanyagot (nev mertekegyseg): ";
@@ -326,16 +573,24 @@ void Controller::addIngredient() {
     }
 
     if ( trim( buffer ).empty() || tmp.size() != 2 || tmp[0].empty() || tmp[1].empty() ) { cerr << "Hibas formatum! Kapott input: \"" + buffer + "\"" << endl; return; }
-    int selected = ingredientList.indexOf( Ingredient( String(tmp[0].c_str()), "" ) );
+
+    int selected;
+    {
+        STATS_TIMER( OP_ADD_INGREDIENT );
+        selected = ingredientList.indexOf( Ingredient( String(tmp[0].c_str()), "" ) );
+        if ( selected != -1 ) ingredientList.get( selected )->setUnit( String(tmp[1].c_str()) );
+        else
+        {
+            ingredientList.push( Ingredient(String(tmp[0].c_str()), String(tmp[1].c_str())) );
+            addName( tmp[0] );
+        }
+    }
 
     if ( selected != -1 )
     {
         cout << "A megadott alapanyag mar szerepel a listaban. A mertekegyseg opcionalisan felulirva!" << endl;
-        ingredientList.get( selected )->setUnit( String(tmp[1].c_str()) );
         return;
     }
-
-    ingredientList.push( Ingredient(String(tmp[0].c_str()), String(tmp[1].c_str())) );
     cout << "[Alapanyag sikeresen hozzaadva!]" << endl;
 }
 void Controller::removeIngredient() {
@@ -354,7 +609,11 @@ void Controller::removeIngredient() {
     catch( std::invalid_argument& ex ) { cerr << "Hibas formatum! Kapott input: \"" + buffer + "\"" << endl; return; }
     catch( std::out_of_range& ex ) { cerr << "A megadott elem nem szerepel a listaban! Kapott input: \"" + buffer + "\"" << endl; return; }
 
-    ingredientList.pop( selected );
+    {
+        STATS_TIMER( OP_REMOVE_INGREDIENT );
+        removeName( ingredientList.get( selected )->getName().c_str() );
+        ingredientList.pop( selected );
+    }
     cout << "[Alapanyag sikeresen eltavolitva]" << endl;
 }
 void Controller::modifyIngredient() {
@@ -381,7 +640,11 @@ void Controller::modifyIngredient() {
         if ( ingredientList.indexOf( Ingredient(String(buffer.c_str()), "") ) != -1 )
             cout << "A megadott alapanyag mar szerepel a listaban!" << endl;
         else
+        {
+            removeName( ingredientList.get( selected )->getName().c_str() );
             ingredientList.get( selected )->setName( String(buffer.c_str()) );
+            addName( buffer );
+        }
     }
 
     cout << "Alapanyag uj m.egysege (elozo eretek megtartasa eseten ures): ";
@@ -394,7 +657,7 @@ void Controller::modifyIngredient() {
 
 void Controller::listPantry() {
     cout << "[Kamra listazasa]" << endl;
-    pantryList.printOrderedList( cout, true );
+    printPaged( pantryList );
 }
 void Controller::addPantry() {
     cout << "[Kamra alapanyag hozzaadasa]\nAdd meg az uj alapanyagot (nev mertekegyseg mennyiseg): ";
@@ -417,17 +680,29 @@ void Controller::addPantry() {
         number = std::stoi( tmp[2] );
     } catch( std::invalid_argument& ex ) { cerr << "Hibas formatum! Kapott input: \"" + buffer + "\"" << endl; return; }
 
-    int selected = pantryList.indexOf( IngredientQ( String(tmp[0].c_str()), "", 0 ) );
+    correctIngredient( tmp[0], true );
+
+    int selected;
+    {
+        STATS_TIMER( OP_ADD_PANTRY );
+        selected = pantryList.indexOf( IngredientQ( String(tmp[0].c_str()), "", 0 ) );
+        if ( selected != -1 )
+        {
+            pantryList.get( selected )->setUnit( String( tmp[1].c_str() ) );
+            pantryList.get( selected )->setQuantity( number );
+        }
+        else
+        {
+            pantryList.push( IngredientQ( String(tmp[0].c_str()), String(tmp[1].c_str()), number ) );
+            addName( tmp[0] );
+        }
+    }
 
     if ( selected != -1 )
     {
         cout << "A megadott alapanyag mar szerepel a listaban. A mertekegyseg es mennyiseg opcionalisan felulirva!" << endl;
-        pantryList.get( selected )->setUnit( String( tmp[1].c_str() ) );
-        pantryList.get( selected )->setQuantity( number );
         return;
     }
-
-    pantryList.push( IngredientQ( String(tmp[0].c_str()), String(tmp[1].c_str()), number ) );
     cout << "[Kamra alapanyag sikeresen hozzaadva]" << endl;
 }
 void Controller::removePantry() {
@@ -446,7 +721,11 @@ void Controller::removePantry() {
     catch( std::invalid_argument& ex ) { cerr << "Hibas formatum! Kapott input: \"" + buffer + "\"" << endl; return; }
     catch( std::out_of_range& ex ) { cerr << "A megadott elem nem szerepel a listaban! Kapott input: \"" + buffer + "\"" << endl; return; }
 
-    pantryList.pop( selected );
+    {
+        STATS_TIMER( OP_REMOVE_PANTRY );
+        removeName( pantryList.get( selected )->getName().c_str() );
+        pantryList.pop( selected );
+    }
     cout << "[Kamra alapanyag sikeresen eltavolitva]" << endl;
 }
 void Controller::modifyPantry() {
@@ -473,7 +752,11 @@ void Controller::modifyPantry() {
         if ( pantryList.indexOf( IngredientQ(String(buffer.c_str()), "", 0) ) != -1 )
             cout << "A megadott alapanyag mar szerepel a listaban!" << endl;
         else
+        {
+            removeName( pantryList.get( selected )->getName().c_str() );
             pantryList.get( selected )->setName( String(buffer.c_str()) );
+            addName( buffer );
+        }
     }
 
     cout << "Alapanyag uj mertekegysege (elozo eretek megtartasa eseten ures): ";
@@ -495,42 +778,172 @@ void Controller::modifyPantry() {
 
     cout << "[Kamra alapanyag sikeresen modositva]" << endl;
 }
+void Controller::shoppingList() {
+    cout << "[Bevasarlolista]" << endl;
+    if ( storeUnsupported() ) return;
+    if ( recipeList.empty() ) { cout << "A receptlista ures!" << endl; return; }
+
+    cout << "Melyik recepteket szeretned elkesziteni? (sorszam vagy #azonosito, vesszovel elvalasztva; ismetles = tobb adag) ";
+    std::string buffer;
+    std::getline( std::cin, buffer );
+
+    std::vector<const Recipe*> selected;
+    std::stringstream ss( buffer );
+    std::string item;
+    while ( std::getline( ss, item, ',' ) )
+    {
+        if ( trim( item ).empty() ) continue;
+        const Recipe* recipe = selectRecipe( item );
+        if ( recipe == nullptr ) return;
+        selected.push_back( recipe );
+    }
+    if ( selected.empty() ) { cerr << "Hibas formatum! Kapott input: \"" + buffer + "\"" << endl; return; }
+
+    ShoppingList missing;
+    {
+        STATS_TIMER( OP_SHOPPING_LIST );
+        missing.build( selected, pantryList );
+    }
+
+    cout << "[Hianyzo alapanyagok]" << endl;
+    if ( missing.size() == 0 ) { cout << "Minden megvan a kamraban." << endl; return; }
+
+    // A tétel a kamra listájához hasonlóan (név hiányzó mennyiség+egység), utána az összegek
+    PageBuffer out( cout );
+    IngredientPrinter printer( missing.getItems() );
+    for ( size_t i = 0; i < missing.size(); i++ )
+    {
+        out.row() << ( i + 1 ) << ". ";
+        printer.print( out.row(), missing.getItems()[i] );
+        out.row() << " (kell: " << missing.needed( i ) << ", van: " << missing.stock( i ) << ")";
+        out.endRow();
+    }
+}
 
 
 void Controller::searchByRecipeName() {
     cout << "[Kereses az etel neve alapjan]" << endl;
-    if ( recipeList.empty() ) { cout << "A receptlista ures!" << endl; return; }
+    if ( recipeCount() == 0 ) { cout << "A receptlista ures!" << endl; return; }
 
     cout << "Add meg a keresendo elemet: ";
     std::string buffer;
     std::getline( std::cin, buffer );
 
-    LinkedList< Result<Recipe>* > results = recipeList.search( title_contains( String(buffer.c_str()) ) );
-    displaySearchResult( results );
+    if ( store )
+    {
+        cout << "[Talalatok]" << endl;
+        printStoredTitles( std::string(), lowerText( buffer ), Stats::OP_SEARCH_TITLE );
+        return;
+    }
+
+    SearchHits hits;
+    {
+        STATS_TIMER( OP_SEARCH_TITLE );
+        hits = cachedSearch( titleQueryKey( buffer ), title_contains( String(buffer.c_str()) ) );
+    }
+    displaySearchResult( *hits, Relevance( buffer, std::vector<std::string>(), pantryList ) );
 }
 void Controller::searchRandom() {
     cout << "[Nincs otletem - veletlenszeru recept]" << endl;
+    if ( storeUnsupported() ) return;
     if ( recipeList.empty() ) { cout << "A receptlista ures!" << endl; return; }
 
-    int selected = 0 + (rand() % static_cast<int>((recipeList.size()-1) - 0 + 1));
-    cout << "[Talalat]" << endl << (selected+1) << ". " << recipeList.get(selected)->getTitle() << endl;
+    Recipe* recipe;
+    {
+        STATS_TIMER( OP_SEARCH_RANDOM );
+        // A slot map tömör tömbjéből O(1) időben választunk
+        recipe = &*recipeIds.valueAt( rand() % recipeIds.size() );
+    }
+    cout << "[Talalat]" << endl << recipe->getTitle() << " (" << recipe->getId() << ")" << endl;
+}
+void Controller::searchSimilar() {
+    cout << "[Hasonlo receptek keresese]" << endl;
+    if ( storeUnsupported() ) return;
+    if ( recipeList.empty() ) { cout << "A receptlista ures!" << endl; return; }
+
+    std::string buffer;
+    cout << "Melyik recepthez keresel hasonlot? (sorszam vagy #azonosito) ";
+    std::getline( std::cin, buffer );
+
+    Recipe* recipe = selectRecipe( buffer );
+    if ( recipe == nullptr ) return;
+    if ( recipe->getIngredients()->empty() ) { cout << "A receptnek nincsenek hozzavaloi!" << endl; return; }
+
+    std::vector<SimilarityIndex::Match> matches;
+    {
+        STATS_TIMER( OP_SEARCH_SIMILAR );
+        matches = similarIndex.get().similar( recipe->getId(), SIMILAR_COUNT );
+    }
+
+    cout << "[Talalatok]" << endl;
+    if ( matches.empty() ) { cout << "Nincs hasonlo recept." << endl; return; }
+
+    for ( size_t i = 0; i < matches.size(); i++ )
+    {
+        Recipe* match = findRecipe( matches[i].first );
+        if ( match == nullptr ) continue;
+        cout << ( i + 1 ) << ". " << match->getTitle() << " (" << matches[i].first << ") - "
+             << (int)( matches[i].second * 100 + 0.5 ) << "% egyezes\n";
+    }
+    cout.flush();
+}
+void Controller::searchByPrefix() {
+    cout << "[Kereses a nev eleje alapjan]" << endl;
+    if ( recipeCount() == 0 ) { cout << "A receptlista ures!" << endl; return; }
+
+    cout << "Add meg a nev elejet: ";
+    std::string buffer;
+    std::getline( std::cin, buffer );
+    if ( trim( buffer ).empty() ) { cerr << "Hibas formatum! Kapott input: \"" + buffer + "\"" << endl; return; }
+
+    if ( store )
+    {
+        cout << "[Talalatok]" << endl;
+        printStoredTitles( lowerText( buffer ), std::string(), Stats::OP_SEARCH_PREFIX );
+        return;
+    }
+
+    size_t from, to;
+    {
+        STATS_TIMER( OP_SEARCH_PREFIX );
+        // [prefix, prefix + 0xff) tartomány - a 0xff bájt minden (UTF-8) karakternél nagyobb
+        TitleKey lower( String( buffer.c_str() ), Handle( 0, 0 ) );
+        TitleKey upper( lower );
+        upper.title = upper.title + (char)0xff;
+
+        from = titleIndex.rankOf( lower );
+        to = titleIndex.rankOf( upper );
+    }
+
+    cout << "[Talalatok]" << endl;
+    if ( from == to ) { cout << "Nincs talalat." << endl; return; }
+    printTitleRange( from, to );
 }
 void Controller::searchByOneIngredient() {
     cout << "[Kereses egy hozzavalo alapjan]" << endl;
+    if ( storeUnsupported() ) return;
     if ( recipeList.empty() ) { cout << "A receptlista ures!" << endl; return; }
 
     cout << "Add meg a keresendo elemet: ";
     std::string buffer;
     std::getline( std::cin, buffer );
 
+    std::string name = buffer;
+    if ( correctIngredient( trim( name ), false ) ) buffer = name;
+
     LinkedList<Ingredient> list = LinkedList<Ingredient>();
     list.push(Ingredient(String(buffer.c_str()), String()));
 
-    LinkedList< Result<Recipe>* > results = recipeList.search( ingredient_contains( list ) );
-    displaySearchResult( results );
+    SearchHits hits;
+    {
+        STATS_TIMER( OP_SEARCH_ONE_INGREDIENT );
+        hits = cachedSearch( ingredientQueryKey( list ), ingredient_contains( list ) );
+    }
+    displaySearchResult( *hits, Relevance( std::string(), std::vector<std::string>( 1, buffer ), pantryList ) );
 }
 void Controller::serachByMoreIngredient() {
     cout << "[Kereses tobb hozzavalo alapjan]" << endl;
+    if ( storeUnsupported() ) return;
     if ( recipeList.empty() ) { cout << "A receptlista ures!" << endl; return; }
 
     cout << "Add meg a keresendo elemeket vesszovel elvalasztva: ";
@@ -540,33 +953,800 @@ void Controller::serachByMoreIngredient() {
     stringstream ln( buffer );
 
     LinkedList<Ingredient> list = LinkedList<Ingredient>();
+    std::vector<std::string> names;
     while ( std::getline( ln, segment, ',' ) )
     {
         std::string tmp = segment;
-        if ( !trim( tmp ).empty() ) list.push( Ingredient(String(segment.c_str()), String()) );
+        if ( trim( tmp ).empty() ) continue;
+
+        if ( correctIngredient( tmp, false ) ) segment = tmp;
+        list.push( Ingredient(String(segment.c_str()), String()) );
+        names.push_back( segment );
     }
 
-    LinkedList< Result<Recipe>* > results = recipeList.search( ingredient_contains( list ) );
-    displaySearchResult( results );
+    SearchHits hits;
+    {
+        STATS_TIMER( OP_SEARCH_MORE_INGREDIENT );
+        hits = cachedSearch( ingredientQueryKey( list ), ingredient_contains( list ) );
+    }
+    displaySearchResult( *hits, Relevance( std::string(), names, pantryList ) );
 }
 
-void Controller::displaySearchResult( LinkedList<Result<Recipe>* >& results ) {
+void Controller::searchCombined() {
+    cout << "[Osszetett kereses]" << endl;
+    if ( storeUnsupported() ) return;
+    if ( recipeList.empty() ) { cout << "A receptlista ures!" << endl; return; }
+
+    Query query;
+    std::string buffer;
+
+    cout << "A nev tartalmazza (ures = mindegy): ";
+    std::getline( std::cin, query.title );
+
+    cout << "Hozzavalok vesszovel elvalasztva (ures = mindegy): ";
+    std::getline( std::cin, buffer );
+    stringstream ln( buffer );
+    std::string segment;
+    while ( std::getline( ln, segment, ',' ) )
+    {
+        if ( trim( segment ).empty() ) continue;
+        correctIngredient( segment, false );
+        query.ingredients.push_back( segment );
+    }
+
+    cout << "Csak a kamrabol elkeszitheto receptek? (i/n) ";
+    std::getline( std::cin, buffer );
+    query.cookable = trim( buffer ) == "i" || buffer == "I";
+
+    cout << "Legfeljebb hany lepes? (ures = mindegy) ";
+    std::getline( std::cin, buffer );
+    if ( !trim( buffer ).empty() )
+    {
+        try {
+            query.maxSteps = std::stoi( buffer );
+            if ( query.maxSteps < 0 ) throw std::out_of_range( "negativ" );
+        }
+        catch ( std::invalid_argument& ex ) { cerr << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return; }
+        catch ( std::out_of_range& ex ) { cerr << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return; }
+    }
+
+    if ( query.empty() ) { cout << "Nem adtal meg feltetelt!" << endl; return; }
+
+    QueryPlanner::Plan plan = planner.plan( query, recipeList.size(), ingredientIndex, lazyInstructions );
+    plan.print( cout );
+
+    QueryPlanner::Outcome outcome;
+    {
+        STATS_TIMER( OP_SEARCH_COMBINED );
+        outcome = planner.execute( plan, recipeList, ingredientIndex, pantryList, resolve_recipe( *this ), count_steps( instructionSource.get() ) );
+    }
+
+    cout << "(megvizsgalt receptek: " << outcome.examined << " / " << recipeList.size() << ")" << endl;
+
+    // A jelöltek sorrendje (pl. az index sorrendje) a rangsorban csak egyenlő pontszámnál dönt
+    std::vector<SearchHit> hits;
+    hits.reserve( outcome.matches.size() );
+    for ( size_t i = 0; i < outcome.matches.size(); i++ )
+        hits.push_back( SearchHit( (int)( i + 1 ), outcome.matches[i]->getId() ) );
+    displaySearchResult( hits, Relevance( query.title, query.ingredients, pantryList ) );
+}
+
+void Controller::displaySearchResult( const std::vector<SearchHit>& hits, const Relevance& relevance ) {
     cout << "[Talalatok]" << endl;
-    if ( results.size() < 1 ) { cout << "Nincs talalat." << endl; return; }
+    if ( hits.empty() ) { cout << "Nincs talalat." << endl; return; }
+
+    size_t pages = ( hits.size() + PAGE_SIZE - 1 ) / PAGE_SIZE;
+    size_t shown = 0, page = 1;
+    Ranked last;
+    do {
+        std::vector<Ranked> best;
+        {
+            STATS_TIMER( OP_RANK_RESULTS );
+            // Csak az előző oldal utolsó eleménél rosszabbak versenyeznek, így oldalanként O(n log PAGE_SIZE)
+            TopK<Ranked, more_relevant> top( PAGE_SIZE );
+            for ( size_t i = 0; i < hits.size(); i++ )
+            {
+                const Recipe* recipe = findRecipe( hits[i].second );
+                if ( recipe == nullptr ) continue;
+
+                Ranked item( relevance.score( *recipe ), hits[i].first, hits[i].second );
+                if ( shown == 0 || more_relevant()( last, item ) ) top.push( item );
+            }
+            best = top.take();
+        }
+        if ( best.empty() ) break;
+
+        PageBuffer out( cout );
+        if ( pages > 1 ) out.row() << "[" << page << ". oldal / " << pages << " - " << hits.size() << " talalat relevancia szerint]\n";
+        for ( size_t i = 0; i < best.size(); i++ )
+        {
+            const Recipe* recipe = findRecipe( best[i].id );
+            out.row() << ( shown + i + 1 ) << ". " << recipe->getTitle() << " (" << best[i].id << ") - "
+                      << (int)( best[i].score * 100 + 0.5 ) << "%";
+            out.endRow();
+        }
+
+        shown += best.size();
+        last = best.back();
+        page++;
+    } while ( shown < hits.size() && askNextPage() );
+}
+
+
+void Controller::printStats() {
+    cout << "[Statisztika]" << endl;
+    Stats::dump( cout );
+}
+void Controller::printStatsJson() {
+    cout << "[Statisztika - JSON]" << endl;
+    Stats::dumpJson( cout );
+}
+void Controller::printMemory() {
+    cout << "[Memoriahasznalat]" << endl;
+    writeMemory( cout );
+}
+void Controller::toggleFuzzySearch() {
+    fuzzySearch = !fuzzySearch;
+    cout << "[Elgepeles-turo kereses " << ( fuzzySearch ? "bekapcsolva" : "kikapcsolva" ) << "]" << endl;
+}
+void Controller::togglePaging() {
+    paging = !paging;
+    cout << "[Lapozas " << ( paging ? "bekapcsolva" : "kikapcsolva" ) << "]" << endl;
+}
+
+
+// Kérés alapú interfész
+void Controller::startPublishing() {
+    if ( publishing ) return;
+
+    publishing = true;
+    openInstructionSource();
+    publish( Handle() );
+}
+bool Controller::requestList( const std::string& arg, std::ostream& out ) const {
+    Rcu<Catalog>::Reader view( catalog );
+    if ( view.get() == nullptr ) { out << "Nincs kozzetett receptlista!" << endl; return false; }
+
+    const std::vector<TitleKey>& titles = view->sortedTitles();
+    size_t from = 0, to = titles.size();
+    if ( to == 0 ) { out << "A lista ures." << endl; return true; }
+
+    std::string buffer = arg;
+    if ( !trim( buffer ).empty() )
+    {
+        size_t pages = ( to + PAGE_SIZE - 1 ) / PAGE_SIZE;
+        int selected;
+        try {
+            selected = std::stoi( buffer );
+            if ( selected < 1 || (size_t)selected > pages ) throw std::out_of_range( "hibas oldal" );
+        }
+        catch ( std::invalid_argument& ex ) { out << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return false; }
+        catch ( std::out_of_range& ex ) { out << "Nincs ilyen oldal! Kapott input: \"" + buffer + "\"" << endl; return false; }
+
+        from = ( selected - 1 ) * PAGE_SIZE;
+        to = std::min( to, from + PAGE_SIZE );
+        out << "[" << selected << ". oldal / " << pages << "]" << '\n';
+    }
+
+    for ( size_t rank = from; rank < to; rank++ )
+    {
+        const Recipe* recipe = view->find( titles[rank].id );
+        if ( recipe != nullptr ) out << ( rank + 1 ) << ". " << recipe->getTitle() << " (" << titles[rank].id << ")" << '\n';
+    }
+    return true;
+}
+bool Controller::requestShow( const std::string& arg, std::ostream& out ) const {
+    Rcu<Catalog>::Reader view( catalog );
+    if ( view.get() == nullptr ) { out << "Nincs kozzetett receptlista!" << endl; return false; }
+
+    const Recipe* recipe = lookupEntry( *view, arg, out );
+    if ( recipe == nullptr ) return false;
+
+    LinkedList<String> plain;
+    if ( !view->instructionsOf( *recipe, plain, out ) ) return false;
+
+    out << "[" << recipe->getTitle() << "] (" << recipe->getId() << ")" << '\n' << "Hozzavalok:" << '\n';
+    int i = 1;
+    for ( LinkedList<IngredientQ>::Iterator it( *recipe->getIngredients() ); it != LinkedList<IngredientQ>::Iterator(); it++, i++ )
+    {
+        out << i << ". ";
+        it->printDetails( out );
+        out << '\n';
+    }
+
+    out << "Instrukciok:" << '\n';
+    i = 1;
+    for ( LinkedList<String>::Iterator it = plain.begin(); it != plain.end(); it++, i++ )
+        out << i << ". " << *it << '\n';
+    return true;
+}
+bool Controller::requestTitle( const std::string& arg, std::ostream& out ) const {
+    Rcu<Catalog>::Reader view( catalog );
+    if ( view.get() == nullptr ) { out << "Nincs kozzetett receptlista!" << endl; return false; }
+
+    size_t hits;
+    {
+        STATS_TIMER( OP_SEARCH_TITLE );
+        hits = writeMatching( *view, title_contains( String( arg.c_str() ) ), out );
+    }
+
+    if ( hits == 0 ) out << "Nincs talalat." << endl;
+    return true;
+}
+bool Controller::requestPrefix( const std::string& arg, std::ostream& out ) const {
+    std::string buffer = arg;
+    if ( trim( buffer ).empty() ) { out << "Hibas formatum! Kapott input: \"" + arg + "\"" << endl; return false; }
+
+    Rcu<Catalog>::Reader view( catalog );
+    if ( view.get() == nullptr ) { out << "Nincs kozzetett receptlista!" << endl; return false; }
+
+    size_t from, to;
+    {
+        STATS_TIMER( OP_SEARCH_PREFIX );
+        TitleKey lower( String( buffer.c_str() ), Handle( 0, 0 ) );
+        TitleKey upper( lower );
+        upper.title = upper.title + (char)0xff;
+
+        from = view->rankOf( lower );
+        to = view->rankOf( upper );
+    }
+
+    if ( from == to ) { out << "Nincs talalat." << endl; return true; }
+
+    const std::vector<TitleKey>& titles = view->sortedTitles();
+    for ( size_t rank = from; rank < to; rank++ )
+    {
+        const Recipe* recipe = view->find( titles[rank].id );
+        if ( recipe != nullptr ) out << ( rank - from + 1 ) << ". " << recipe->getTitle() << " (" << titles[rank].id << ")" << '\n';
+    }
+    return true;
+}
+bool Controller::requestIngredients( const std::string& arg, std::ostream& out ) const {
+    Rcu<Catalog>::Reader view( catalog );
+    if ( view.get() == nullptr ) { out << "Nincs kozzetett receptlista!" << endl; return false; }
+
+    stringstream ln( arg );
+    std::string segment;
+
+    LinkedList<Ingredient> list;
+    while ( std::getline( ln, segment, ',' ) )
+    {
+        if ( trim( segment ).empty() ) continue;
+
+        std::string closest = view->closestIngredient( segment, segment.size() < 4 ? 1 : FUZZY_DISTANCE );
+        if ( !closest.empty() )
+        {
+            out << "Nincs \"" << segment << "\" nevu alapanyag, helyette: \"" << closest << "\"" << '\n';
+            segment = closest;
+        }
+        list.push( Ingredient( String( segment.c_str() ), String() ) );
+    }
+    if ( list.empty() ) { out << "Hibas formatum! Kapott input: \"" + arg + "\"" << endl; return false; }
+
+    size_t hits;
+    if ( list.size() == 1 )
+    {
+        STATS_TIMER( OP_SEARCH_ONE_INGREDIENT );
+        hits = writeMatching( *view, ingredient_contains( list ), out );
+    }
+    else
+    {
+        STATS_TIMER( OP_SEARCH_MORE_INGREDIENT );
+        hits = writeMatching( *view, ingredient_contains( list ), out );
+    }
+
+    if ( hits == 0 ) out << "Nincs talalat." << endl;
+    return true;
+}
+bool Controller::requestSimilar( const std::string& arg, std::ostream& out ) const {
+    Rcu<Catalog>::Reader view( catalog );
+    if ( view.get() == nullptr ) { out << "Nincs kozzetett receptlista!" << endl; return false; }
+
+    const Recipe* recipe = lookupEntry( *view, arg, out );
+    if ( recipe == nullptr ) return false;
+    if ( recipe->getIngredients()->empty() ) { out << "A receptnek nincsenek hozzavaloi!" << endl; return false; }
+
+    std::vector<SimilarityIndex::Match> matches;
+    {
+        STATS_TIMER( OP_SEARCH_SIMILAR );
+        matches = view->similar().similar( recipe->getId(), SIMILAR_COUNT );
+    }
+
+    if ( matches.empty() ) { out << "Nincs hasonlo recept." << endl; return true; }
+    for ( size_t i = 0; i < matches.size(); i++ )
+    {
+        const Recipe* match = view->find( matches[i].first );
+        if ( match == nullptr ) continue;
+        out << ( i + 1 ) << ". " << match->getTitle() << " (" << matches[i].first << ") - "
+            << (int)( matches[i].second * 100 + 0.5 ) << "% egyezes" << '\n';
+    }
+    return true;
+}
+bool Controller::requestAdd( const std::string& arg, std::ostream& out ) {
+    // nev | hozzavalok | instrukciok
+    std::vector<std::string> parts;
+    stringstream ln( arg );
+    std::string segment;
+    while ( std::getline( ln, segment, '|' ) ) parts.push_back( trim( segment ) );
+    if ( parts.size() != 3 || parts[0].empty() ) { out << "Hibas formatum! Kapott input: \"" + arg + "\"" << endl; return false; }
+
+    String title( parts[0].c_str() );
+    if ( recipeList.contains( Recipe( title ) ) ) { out << "A recept mar szerepel a listaban!" << endl; return false; }
 
-    LinkedList< Result<Recipe>* >::Iterator start = results.begin();
-    while(start != results.end())
+    LinkedList<IngredientQ> ingredients;
+    parseIngredients( parts[1], ingredients, out );
+
+    LinkedList<String> instructions;
+    parseInstructions( parts[2], instructionCodec, instructions );
+
+    Handle id;
     {
-        Result<Recipe>* tmp = *start;
-        cout << tmp->getOrder() << ". " << tmp->getPtr()->getTitle() << endl;
+        STATS_TIMER( OP_ADD_RECIPE );
+        id = registerRecipe( recipeList.emplace( std::move( title ), std::move( ingredients ), std::move( instructions ) ) );
+    }
+    if ( publishing ) publish( id );
+
+    out << "Azonosito: " << id << endl;
+    return true;
+}
+bool Controller::requestRemove( const std::string& arg, std::ostream& out ) {
+    const Recipe* recipe = lookupRecipe( arg, out );
+    if ( recipe == nullptr ) return false;
 
-        start++;
-        delete tmp;
+    Handle id = recipe->getId();
+    out << recipe->getTitle() << " (" << id << ") torolve" << endl;
+    {
+        STATS_TIMER( OP_REMOVE_RECIPE );
+        if ( !eraseRecipe( id ) ) return false;
     }
+    if ( publishing ) publish( id );
+    return true;
+}
+bool Controller::requestRename( const std::string& arg, std::ostream& out ) {
+    // recept | uj nev
+    std::vector<std::string> parts;
+    stringstream ln( arg );
+    std::string segment;
+    while ( std::getline( ln, segment, '|' ) ) parts.push_back( trim( segment ) );
+    if ( parts.size() != 2 || parts[1].empty() ) { out << "Hibas formatum! Kapott input: \"" + arg + "\"" << endl; return false; }
+
+    Recipe* selected = const_cast<Recipe*>( lookupRecipe( parts[0], out ) );
+    if ( selected == nullptr ) return false;
+
+    {
+        STATS_TIMER( OP_MODIFY_RECIPE );
+        if ( recipeList.contains( Recipe( String( parts[1].c_str() ) ) ) ) { out << "A megadott nev foglalt!" << endl; return false; }
+
+        titleIndex.erase( TitleKey( selected->getTitle(), selected->getId() ) );
+        selected->setTitle( String( parts[1].c_str() ) );
+        titleIndex.insert( TitleKey( selected->getTitle(), selected->getId() ) );
+        recipeList.touch();
+    }
+    if ( publishing ) publish( selected->getId() );
+
+    out << selected->getTitle() << " (" << selected->getId() << ")" << endl;
+    return true;
+}
+
+bool Controller::requestMemory( const std::string&, std::ostream& out ) {
+    writeMemory( out );
+    return true;
 }
 
 
 // Privát metódusok
+void Controller::writeMemory( std::ostream& out ) const {
+    Components::MemoryUsage recipes = recipeList.memoryUsage();
+    Components::MemoryUsage ingredients = ingredientList.memoryUsage();
+    Components::MemoryUsage pantry = pantryList.memoryUsage();
+
+    Components::MemoryUsage total;
+    total += recipes;
+    total += ingredients;
+    total += pantry;
+
+    Components::MemoryUsage::printHeader( out );
+    recipes.printRow( out, "receptek" );
+    ingredients.printRow( out, "alapanyagok" );
+    pantry.printRow( out, "kamra" );
+    total.printRow( out, "osszesen" );
+    out << "(bajtban; a heap oszlop a malloc fejlec es kerekites becslese, az indexek nelkul)" << endl;
+
+    if ( store )
+    {
+        const File::BufferPool& pool = store->buffers();
+        out << "lemezes receptkonyv: " << store->size() << " recept, " << pool.pages() << " lap a fajlban, "
+            << pool.resident() << "/" << pool.capacity() << " lap a memoriaban (talalat: " << pool.hits()
+            << ", hiany: " << pool.misses() << ", kiiras: " << pool.writes() << ")" << endl;
+    }
+}
+
+bool Controller::correctIngredient( std::string& name, bool ask ) {
+    std::string closest = closestIngredient( name );
+    if ( closest.empty() ) return false;
+
+    if ( ask )
+    {
+        cout << "Erre gondoltal: \"" << closest << "\"? (i/n) ";
+        std::string buffer;
+        std::getline( std::cin, buffer );
+        trim( buffer );
+        if ( buffer != "i" && buffer != "I" ) return false;
+    }
+    else
+    {
+        cout << "Nincs \"" << name << "\" nevu alapanyag, helyette: \"" << closest << "\"" << endl;
+    }
+
+    name = closest;
+    return true;
+}
+std::string Controller::closestIngredient( const std::string& name ) const {
+    if ( !fuzzySearch || name.empty() || ingredientNames.get().contains( name ) ) return std::string();
+
+    unsigned int k = name.size() < 4 ? 1 : FUZZY_DISTANCE;
+    std::vector<BKTree::Match> matches = ingredientNames.get().find( name, k );
+    return matches.empty() ? std::string() : matches[0].first;
+}
+Handle Controller::registerRecipe( LinkedList<Recipe>::Iterator it ) {
+    Handle id = recipeIds.insert( it );
+    it->setId( id );
+    titleIndex.insert( TitleKey( it->getTitle(), id ) );
+    refreshSimilar( id );
+    ingredientIndex.update( id, *it );
+    indexNames( *it->getIngredients(), true );
+    return id;
+}
+Recipe* Controller::findRecipe( const Handle& id ) {
+    LinkedList<Recipe>::Iterator* it = recipeIds.get( id );
+    return it != nullptr ? &**it : nullptr;
+}
+const Recipe* Controller::findRecipe( const Handle& id ) const {
+    const LinkedList<Recipe>::Iterator* it = recipeIds.get( id );
+    return it != nullptr ? &*LinkedList<Recipe>::Iterator( *it ) : nullptr;
+}
+bool Controller::eraseRecipe( const Handle& id ) {
+    LinkedList<Recipe>::Iterator* it = recipeIds.get( id );
+    if ( it == nullptr ) return false;
+
+    LinkedList<Recipe>::Iterator node = *it;
+    titleIndex.erase( TitleKey( node->getTitle(), id ) );
+    ingredientIndex.remove( id );
+    indexNames( *node->getIngredients(), false );
+    recipeIds.erase( id );
+    recipeList.erase( node );
+    refreshSimilar( id );
+    return true;
+}
+void Controller::addName( const std::string& name ) {
+    ingredientNames.apply( [name]( BKTree& names ) { names.insert( name ); } );
+}
+void Controller::removeName( const std::string& name ) {
+    ingredientNames.apply( [name]( BKTree& names ) { names.remove( name ); } );
+}
+void Controller::refreshSimilar( const Handle& id ) {
+    // Csak az azonosítót naplózzuk: lejátszáskor is a recept aktuális állapota számít
+    similarIndex.apply( [this, id]( SimilarityIndex& index ) {
+        const Recipe* recipe = static_cast<const Controller*>( this )->findRecipe( id );
+        if ( recipe != nullptr ) index.update( id, *recipe );
+        else index.remove( id );
+    } );
+}
+void Controller::publish( const Handle& changed ) {
+    STATS_TIMER( OP_PUBLISH );
+    const Catalog* previous = catalog.latest();
+    Catalog* next = new Catalog( instructionCodec, fuzzySearch );
+    next->reserve( recipeList.size() );
+
+    // A többi recept közös példánya újrahasznosítható, ha az instrukcióinak helye sem változott (mentés)
+    for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+    {
+        Catalog::Entry entry;
+        if ( previous != nullptr && it->getId() != changed ) entry = previous->entry( it->getId() );
+        if ( !entry || entry->getInstructionRange().offset != it->getInstructionRange().offset )
+            entry = std::make_shared<Recipe>( *it );
+        next->push( entry );
+    }
+
+    for ( SkipList<TitleKey>::Cursor cursor = titleIndex.at( 0 ); cursor.valid(); ++cursor )
+        next->pushTitle( *cursor );
+
+    // Változatlan indexnél az előző pillanatkép példánya, változásnál a két példány szerepet cserél
+    next->setSimilarIndex( similarIndex.share() );
+    next->setIngredientNames( ingredientNames.share() );
+    next->setSource( instructionSource );
+
+    catalog.publish( next );
+}
+void Controller::openInstructionSource() {
+    instructionSource.reset();
+    for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+    {
+        if ( it->instructionsLoaded() ) continue;
+
+        try {
+            instructionSource = std::make_shared<Source>( String( "recipes.dat" ) );
+        } catch ( std::ifstream::failure& ex ) { cerr << ex.what() << endl; }
+        return;
+    }
+}
+bool Controller::askPage( size_t total, size_t& page ) {
+    if ( !paging ) { page = 0; return true; }
+
+    size_t pages = ( total + PAGE_SIZE - 1 ) / PAGE_SIZE;
+    page = 1;
+    if ( pages <= 1 ) return true;
+
+    cout << total << " elem, " << pages << " oldal. Hanyadik oldalt kered? (ures = 1., 0 = mind) ";
+    std::string buffer;
+    std::getline( std::cin, buffer );
+    if ( trim( buffer ).empty() ) return true;
+
+    try {
+        int selected = std::stoi( buffer );
+        if ( selected < 0 || (size_t)selected > pages ) throw std::out_of_range( "hibas oldal" );
+        page = selected;
+    }
+    catch ( std::invalid_argument& ex ) { cerr << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return false; }
+    catch ( std::out_of_range& ex ) { cerr << "Nincs ilyen oldal! Kapott input: \"" + buffer + "\"" << endl; return false; }
+
+    return true;
+}
+bool Controller::askNextPage() {
+    if ( !paging ) return true;
+
+    cout << "Kovetkezo oldal? (i/n) ";
+    std::string buffer;
+    if ( !std::getline( std::cin, buffer ) ) return false;
+    trim( buffer );
+    return buffer == "i" || buffer == "I";
+}
+void Controller::printTitleRange( size_t from, size_t to ) {
+    size_t page = 1;
+    if ( !askPage( to - from, page ) ) return;
+
+    size_t pages = ( to - from + PAGE_SIZE - 1 ) / PAGE_SIZE;
+    size_t limit = page == 0 ? to - from : PAGE_SIZE;
+    size_t first = page == 0 ? from : from + ( page - 1 ) * PAGE_SIZE;
+
+    SkipList<TitleKey>::Cursor cursor = titleIndex.at( first );
+    do {
+        PageBuffer out( cout );
+        if ( page != 0 && pages > 1 ) out.row() << "[" << page << ". oldal / " << pages << "]\n";
+
+        size_t last = first + limit < to ? first + limit : to;
+        for ( ; first < last && cursor.valid(); first++, ++cursor )
+        {
+            Recipe* recipe = findRecipe( cursor->id );
+            if ( recipe == nullptr ) continue;
+            out.row() << ( first - from + 1 ) << ". " << recipe->getTitle() << " (" << cursor->id << ")";
+            out.endRow();
+        }
+        page++;
+    } while ( first < to && askNextPage() );
+}
+Recipe* Controller::selectRecipe( const std::string& buffer ) {
+    // A recept a vezérlőé, csak a keresés const
+    return const_cast<Recipe*>( lookupRecipe( buffer, cerr ) );
+}
+const Recipe* Controller::lookupRecipe( const std::string& buffer, std::ostream& err ) const {
+    if ( Handle::looksLike( buffer ) )
+    {
+        Handle id;
+        if ( !Handle::parse( buffer, id ) ) { err << "Hibas azonosito! Kapott input: \"" + buffer + "\"" << endl; return nullptr; }
+
+        const Recipe* recipe = findRecipe( id );
+        if ( recipe == nullptr ) err << "Nem talalhato a megadott azonositoju recept! Kapott input: \"" + buffer + "\"" << endl;
+        return recipe;
+    }
+
+    int item;
+    try {
+        item = (std::stoi( buffer ))-1;
+        if ( item < 0 || item >= recipeList.size() ) throw std::out_of_range( "hibas elem" );
+    }
+    catch ( std::invalid_argument& ex ) { err << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return nullptr; }
+    catch ( std::out_of_range& ex ) { err << "Nem talalhato a megadott elem! Kapott input: \"" + buffer + "\"" << endl; return nullptr; }
+
+    LinkedList<Recipe>::Iterator it( recipeList );
+    for ( ; item > 0; item-- ) it++;
+    return &*it;
+}
+size_t Controller::recipeCount() const {
+    return store ? store->size() : recipeList.size();
+}
+bool Controller::storeUnsupported() const {
+    if ( store ) cout << "A muvelet a lemezes receptkonyvvel nem erheto el." << endl;
+    return (bool)store;
+}
+void Controller::importToStore() {
+    if ( store->imported() ) return;
+
+    // A lemezen kódolatlan instrukciók vannak
+    size_t count = 0;
+    for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++, count++ )
+    {
+        Recipe plain( *it );
+        *plain.getInstructions() = decodeInstructions( *it );
+        store->insert( plain );
+    }
+    recipeList.clear();
+
+    // Akkor is rögzítjük, ha nem volt mit áttölteni - a recipes.dat-ot többé nem olvassuk be
+    store->markImported();
+    try {
+        store->flush();
+    } catch ( std::ofstream::failure& ex ) { cerr << ex.what() << endl; }
+    if ( count > 0 ) cout << "[" << count << " recept atkerult a lemezes receptkonyvbe]" << endl;
+}
+bool Controller::selectStored( const std::string& buffer, Recipe& recipe ) {
+    if ( Handle::looksLike( buffer ) )
+    {
+        Handle id;
+        if ( !Handle::parse( buffer, id ) ) { cerr << "Hibas azonosito! Kapott input: \"" + buffer + "\"" << endl; return false; }
+        if ( !store->find( id, recipe ) ) { cerr << "Nem talalhato a megadott azonositoju recept! Kapott input: \"" + buffer + "\"" << endl; return false; }
+        return true;
+    }
+
+    int item;
+    try {
+        item = (std::stoi( buffer ))-1;
+        if ( item < 0 || (size_t)item >= store->size() ) throw std::out_of_range( "hibas elem" );
+    }
+    catch ( std::invalid_argument& ex ) { cerr << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return false; }
+    catch ( std::out_of_range& ex ) { cerr << "Nem talalhato a megadott elem! Kapott input: \"" + buffer + "\"" << endl; return false; }
+
+    // A sorszám a cím szerinti sorrendben értendő
+    RecipeStore::TitleCursor it = store->titles();
+    for ( ; item > 0 && it.valid(); item-- ) ++it;
+    if ( !it.valid() || !store->find( it.id(), recipe ) )
+    {
+        cerr << "Nem talalhato a megadott elem! Kapott input: \"" + buffer + "\"" << endl;
+        return false;
+    }
+    return true;
+}
+void Controller::printStoredTitles( const std::string& prefix, const std::string& part ) {
+    RecipeStore::TitleCursor it = store->titles( prefix );
+    size_t shown = 0;
+    std::vector<std::pair<std::string, Handle> > rows;
+    do {
+        readStoredPage( it, part, rows );
+        printStoredPage( rows, shown );
+    } while ( it.valid() && askNextPage() );
+
+    if ( shown == 0 ) cout << "Nincs talalat." << endl;
+}
+void Controller::printStoredTitles( const std::string& prefix, const std::string& part, Stats::Operation op ) {
+    RecipeStore::TitleCursor it = store->titles( prefix );
+    size_t shown = 0;
+    std::vector<std::pair<std::string, Handle> > rows;
+    do {
+        {
+            STATS_TIMER_OP( op );
+            readStoredPage( it, part, rows );
+        }
+        printStoredPage( rows, shown );
+    } while ( it.valid() && askNextPage() );
+
+    if ( shown == 0 ) cout << "Nincs talalat." << endl;
+}
+void Controller::readStoredPage( RecipeStore::TitleCursor& it, const std::string& part, std::vector<std::pair<std::string, Handle> >& rows ) const {
+    // A címindex lapjait sorban olvassa, egyszerre egy oldalnyit
+    rows.clear();
+    for ( ; it.valid() && rows.size() < PAGE_SIZE; ++it )
+    {
+        std::string title = it.title();
+        if ( !part.empty() && lowerText( title ).find( part ) == std::string::npos ) continue;
+        rows.push_back( std::make_pair( title, it.id() ) );
+    }
+
+    // A következő oldal létezik-e
+    while ( !part.empty() && it.valid() && lowerText( it.title() ).find( part ) == std::string::npos ) ++it;
+}
+void Controller::printStoredPage( const std::vector<std::pair<std::string, Handle> >& rows, size_t& shown ) const {
+    PageBuffer out( cout );
+    for ( size_t i = 0; i < rows.size(); i++ )
+    {
+        out.row() << ( shown + i + 1 ) << ". " << rows[i].first << " (" << rows[i].second << ")";
+        out.endRow();
+    }
+    shown += rows.size();
+}
+void Controller::modifyStored( Recipe& recipe ) {
+    std::string buffer;
+    int item;
+
+    cout << "1. Cim modositasa | 2. Hozzavalok modositasa | 3. Instrukciok modositasa | 4. Megse\nValassz muveletet: ";
+    std::getline( std::cin, buffer );
+    try {
+        item = (std::stoi( buffer ));
+        if ( item < 1 || item > 4 ) throw std::out_of_range( "hibas elem" );
+    }
+    catch ( std::invalid_argument& ex ) { cerr << "Hibas szam! Kapott input: \"" + buffer + "\"" << endl; return; }
+    catch ( std::out_of_range& ex ) { cerr << "Nem talalhato a megadott elem! Kapott input: \"" + buffer + "\"" << endl; return; };
+
+    bool success = false;
+    switch ( item )
+    {
+        case 1: {
+            cout << "Add meg a recept uj nevet: ";
+            std::getline( std::cin, buffer );
+            std::string tmp = buffer;
+            std::string::iterator end_pos = std::remove(tmp.begin(), tmp.end(), ' ');
+            tmp.erase(end_pos, tmp.end());
+
+            if ( tmp.size() < 1 ) { cerr << "Hibas nev! Kapott input: \"" + buffer + "\"" << endl; return; }
+            if ( store->findTitle( String( buffer.c_str() ) ).valid() ) { cerr << "A megadott nev foglalt!" << endl; cout << "[Recept modositasa sikertelen]" << endl; return; }
+
+            recipe.setTitle( String( buffer.c_str() ) );
+            success = true;
+        break;
+        }
+        case 2: success = modifyIngredientQ( recipe.getIngredients() ); break;
+        case 3: success = modifyStringList( recipe.getInstructions() ); break;
+        case 4: {
+            cout << "[Recept modositas visszavonva]" << endl;
+        return;
+        }
+    }
+
+    if ( success )
+    {
+        STATS_TIMER( OP_MODIFY_RECIPE );
+        store->update( recipe.getId(), recipe );
+    }
+    success ?
+        cout << "[Recept sikeresen modositva]" << endl : cout << "[Recept modositasa sikertelen]" << endl;
+}
+bool Controller::loadInstructions( Recipe& recipe ) {
+    if ( recipe.instructionsLoaded() ) return true;
+
+    STATS_TIMER( OP_LOAD_INSTRUCTIONS );
+    LinkedList<String> instructions;
+    try {
+        if ( instructionSource ) instructionSource->readRange( recipe.getInstructionRange(), instructions );
+        else Reader::readRange( "recipes.dat", recipe.getInstructionRange(), instructions );
+    } catch ( std::ifstream::failure& ex ) { cerr << ex.what() << endl; return false; }
+
+    *recipe.getInstructions() = std::move( instructions );
+    recipe.setInstructionRange( TextRange() );
+    return true;
+}
+LinkedList<String> Controller::decodeInstructions( const Recipe& recipe ) const {
+    LinkedList<String> plain;
+    for ( LinkedList<String>::Iterator it( *recipe.getInstructions() ); it != LinkedList<String>::Iterator(); it++ )
+        plain.emplace( instructionCodec.decode( it->c_str() ).c_str() );
+    return plain;
+}
+void Controller::encodeInstructions( Recipe& recipe, const LinkedList<String>& plain ) const {
+    LinkedList<String>* instructions = recipe.getInstructions();
+    instructions->clear();
+    for ( LinkedList<String>::Iterator it( plain ); it != LinkedList<String>::Iterator(); it++ )
+        instructions->emplace( instructionCodec.encode( it->c_str() ).c_str() );
+}
+void Controller::trainCodec() {
+    // A be nem töltött instrukciók (lusta mód) a fájlban maradnak: az üres szótárral kódolt szöveg
+    // csak ASCII karaktereket és escape-elt bájtokat tartalmaz, így bármely szótárral visszafejthető
+    std::vector<std::string> samples;
+    for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+    {
+        if ( !it->instructionsLoaded() ) continue;
+        for ( LinkedList<String>::Iterator line = it->getInstructions()->begin(); line != it->getInstructions()->end(); line++ )
+            samples.push_back( instructionCodec.decode( line->c_str() ) );
+    }
+
+    instructionCodec.train( samples );
+    if ( instructionCodec.size() == 0 ) return;
+
+    size_t i = 0;
+    for ( LinkedList<Recipe>::Iterator it = recipeList.begin(); it != recipeList.end(); it++ )
+    {
+        if ( !it->instructionsLoaded() ) continue;
+        for ( LinkedList<String>::Iterator line = it->getInstructions()->begin(); line != it->getInstructions()->end(); line++ )
+            *line = String( instructionCodec.encode( samples[i++] ).c_str() );
+    }
+}
 bool Controller::modifyIngredientQ(LinkedList<IngredientQ>* list) {
     cout << "1. Uj elem hozzaadasa | 2. Elem torlese | 3. Elem modositasa | 4. Megse\nValassz muveletet: ";
     std::string buffer;
@@ -6,11 +6,27 @@
  * Ez a fájl tartalmazza a konzolos felhasználói felületet működtető osztályt
  */
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 #include "components.h"
 #include "list.h"
 #include "file.h"
 #include "memtrace.h"
 #include "string5.h"
+#include "slotmap.h"
+#include "similarity.h"
+#include "bktree.h"
+#include "textcodec.h"
+#include "catalog.h"
+#include "rcu.h"
+#include "doublebuffer.h"
+#include "lrucache.h"
+#include "query.h"
+#include "rank.h"
+#include "recipestore.h"
+#include "stats.h"
 
 /**
  * Controller osztály
@@ -24,6 +40,191 @@ private:
     Components::LinkedList<Components::Ingredient> ingredientList;  /// Alapanyaglista
     Components::LinkedList<Components::IngredientQ> pantryList;     /// Kamra lista
 
+    /// Recept azonosító -> listaelem leképezés (O(1) keresés és törlés azonosító alapján)
+    Components::SlotMap<Components::LinkedList<Components::Recipe>::Iterator> recipeIds;
+
+    /// Rendezett címindex (abc sorrend, kezdőbetűk szerinti keresés, lapozás O(log n + k) időben)
+    Components::SkipList<Components::TitleKey> titleIndex;
+
+    /// Hozzávalók alapján hasonló receptek indexe (MinHash + LSH)
+    /// Kettős pufferelt: a pillanatképek másolat nélkül kapják, módosítani a refreshSimilar-ral kell
+    Components::DoubleBuffer<Components::SimilarityIndex> similarIndex;
+
+    /// Az összes ismert alapanyagnév (alapanyaglista, kamra, receptek) elgépelés-tűrő kereséshez
+    /// Kettős pufferelt, módosítani az addName / removeName függvényekkel kell
+    Components::DoubleBuffer<Components::BKTree> ingredientNames;
+
+    /// Alapanyag -> receptek fordított index (összetett keresésnél a jelöltek előállításához)
+    Components::IngredientIndex ingredientIndex;
+
+    /// Az összetett keresések tervezője (a szűrők mért szelektivitását is ő tárolja)
+    Components::QueryPlanner planner;
+
+    /// Lusta módban fut-e (az instrukciók csak igény szerint töltődnek be)
+    bool lazyInstructions;
+
+    /// Lemezes receptkönyv (--store): ha meg van nyitva, a receptek nem a memóriában (recipeList), hanem a
+    /// fájl B+fáiban vannak, és a receptkönyv műveletei közvetlenül azon dolgoznak
+    std::unique_ptr<File::RecipeStore> store;
+
+    /// Az instrukciók tömörítő szótára - az instrukciók a memóriában és a fájlban is kódolva vannak
+    Components::TextCodec instructionCodec;
+
+    /// Be van-e kapcsolva az elgépelés-tűrő keresés
+    bool fuzzySearch;
+
+    /// Be van-e kapcsolva a lapozás (kikapcsolva a listák egyben íródnak ki, bemenet olvasása nélkül)
+    bool paging;
+
+    /// A kérés alapú keresések (daemon mód) közzétett pillanatképe - a keresések zár nélkül ezt olvassák,
+    /// a módosító kérések után új változat kerül közzétételre
+    Components::Rcu<Components::Catalog> catalog;
+
+    /// Közzétesszük-e a módosításokat (startPublishing után)
+    bool publishing;
+
+    /// A be nem töltött instrukciók fájlja (betöltéskor és mentésenként újra megnyitva, a pillanatképek is ezt kapják)
+    std::shared_ptr<const File::Source> instructionSource;
+
+    /// Egy keresési találat: a recept sorszáma a listában (1-től) és az azonosítója
+    typedef std::pair<int, Components::Handle> SearchHit;
+
+    /// Egy keresés találatai (közös, nem módosuló példány - a gyorsítótárból kiesve is érvényes marad)
+    typedef std::shared_ptr<const std::vector<SearchHit> > SearchHits;
+
+    /// A keresések gyorsítótára: a keresés típusa és a normalizált kérdés -> találatok
+    /// A receptlista változatszámához kötött, így bármely hozzáadás, törlés vagy módosítás után elavul
+    Components::LruCache<std::string, SearchHits> searchCache;
+
+    /// A gyorsítótárban tárolt keresések legnagyobb száma
+    enum { CACHE_ENTRIES = 256 };
+
+    /// A gyorsítótárban tárolt találatok legnagyobb összesített száma
+    enum { CACHE_HITS = 1 << 16 };
+
+    /// Elgépelés-tűrő keresésnél a legnagyobb megengedett távolság (4 betűnél rövidebb névnél 1)
+    enum { FUZZY_DISTANCE = 2 };
+
+    /// Hasonló receptek kereséskor kiírt találatok száma
+    enum { SIMILAR_COUNT = 5 };
+
+    /// Lapozáskor egy oldalon megjelenő elemek száma
+    enum { PAGE_SIZE = 20 };
+
+    /// Azonosítót oszt ki a listában már szereplő receptnek
+    /// @param it - a receptre mutató iterátor
+    /// @return Handle - a kiosztott azonosító
+    Components::Handle registerRecipe( Components::LinkedList<Components::Recipe>::Iterator it );
+
+    /// Recept kiválasztása felhasználói input alapján
+    /// Az input lehet sorszám (1-től számozva, O(n)) vagy azonosító (#index.generacio, O(1))
+    /// Hiba esetén kiírja a hibaüzenetet
+    /// @param buffer - felhasználói input
+    /// @return Recipe* - a kiválasztott recept, hiba esetén nullptr
+    Components::Recipe* selectRecipe( const std::string& buffer );
+
+    /// Keresés a receptlistában a gyorsítótáron keresztül
+    /// Ha a kérdés szerepel a gyorsítótárban (és azóta a lista nem változott), nem járja be a listát
+    /// @param key - a keresés típusa és a normalizált kérdés (azonos kulcshoz azonos feltétel tartozzon)
+    /// @param match - keresési feltétel (funktor)
+    /// @return SearchHits - a találatok a lista sorrendjében
+    template<class Func>
+    SearchHits cachedSearch( const std::string& key, const Func& match );
+
+    /// A lista elemeinek nevét felveszi / törli az alapanyagnevek indexéből
+    /// @param list - lista (Ingredient vagy leszármazott elemekkel)
+    /// @param add - felvétel (igaz) vagy törlés (hamis)
+    template<class T>
+    void indexNames( Components::LinkedList<T>& list, bool add );
+
+    /// Alapanyagnév felvétele az alapanyagnevek indexébe
+    /// @param name - alapanyag neve
+    void addName( const std::string& name );
+
+    /// Alapanyagnév egy előfordulásának törlése az alapanyagnevek indexéből
+    /// @param name - alapanyag neve
+    void removeName( const std::string& name );
+
+    /// A recept frissítése a hasonlósági indexben a jelenlegi állapota szerint (ha már nincs meg, törlés)
+    /// @param id - recept azonosítója
+    void refreshSimilar( const Components::Handle& id );
+
+    /// Elgépelés-tűrő keresés esetén az ismeretlen alapanyagnevet a legközelebbi ismert névre cseréli
+    /// @param name - alapanyag neve, csere esetén felülíródik
+    /// @param ask - rákérdezzen-e a cserére
+    /// @return bool - megtörtént-e a csere
+    bool correctIngredient( std::string& name, bool ask );
+
+    /// Az ismeretlen alapanyagnévhez legközelebbi ismert név (elgépelés-tűrő keresés)
+    /// @param name - alapanyag neve
+    /// @return std::string - a javított név, üres, ha nincs mit javítani (vagy ki van kapcsolva)
+    std::string closestIngredient( const std::string& name ) const;
+
+    /// Recept kiválasztása sorszám (1-től) vagy azonosító (#index.generacio) alapján
+    /// Hiba esetén a hibaüzenetet a megadott kimenetre írja
+    /// @param buffer - input
+    /// @param err - hibaüzenetek kimenete
+    /// @return const Recipe* - a kiválasztott recept, hiba esetén nullptr
+    const Components::Recipe* lookupRecipe( const std::string& buffer, std::ostream& err ) const;
+
+    /// Új pillanatkép közzététele a jelenlegi adatszerkezetből
+    /// A nem módosult receptek az előző változattal közösek, az indexek kettős pufferből, másolás nélkül jönnek
+    /// @param changed - a módosult recept azonosítója (ha van)
+    void publish( const Components::Handle& changed );
+
+    /// Megnyitja a receptfájlt, ha van be nem töltött instrukciójú recept
+    void openInstructionSource();
+
+    /// A listák memóriahasználatának táblázata
+    /// @param out - kimenet
+    void writeMemory( std::ostream& out ) const;
+
+    /// Megkérdezi, hogy hányadik oldalt írja ki (csak ha több oldal van)
+    /// Kikapcsolt lapozásnál nem kérdez, minden elemet választ
+    /// Hiba esetén kiírja a hibaüzenetet
+    /// @param total - elemek száma
+    /// @param page - ide kerül a választott oldal (1-től számozva, 0 = minden elem)
+    /// @return bool - sikeres volt-e a választás
+    bool askPage( size_t total, size_t& page );
+
+    /// Megkérdezi, hogy kiírja-e a következő oldalt
+    /// Kikapcsolt lapozásnál nem kérdez, a válasz mindig igen
+    /// @return bool - igen-e a válasz
+    bool askNextPage();
+
+    /// Lista lapozható kiírása
+    /// Bekapcsolt lapozásnál, ha több oldal van, megkérdezi, hogy melyik oldaltól írja ki, majd oldalanként továbblapozhat
+    /// Minden oldal egyetlen írással kerül a kimenetre
+    /// @param list - kiírandó lista
+    template<class T>
+    void printPaged( Components::LinkedList<T>& list );
+
+    /// A címindex [from, to) rangú elemeinek lapozható kiírása
+    /// Bekapcsolt lapozásnál, ha több oldal van, megkérdezi, hogy melyik oldaltól írja ki, majd oldalanként továbblapozhat
+    /// @param from - első elem rangja
+    /// @param to - utolsó utáni elem rangja
+    void printTitleRange( size_t from, size_t to );
+
+    /// Betölti a recept instrukcióit a receptfájlból, ha még nincsenek betöltve (lusta mód)
+    /// Hiba esetén kiírja a hibaüzenetet
+    /// @param recipe - recept
+    /// @return bool - elérhetők-e az instrukciók
+    bool loadInstructions( Components::Recipe& recipe );
+
+    /// A recept (betöltött) instrukcióinak visszafejtése megjelenítéshez, szerkesztéshez
+    /// @param recipe - recept
+    /// @return LinkedList<String> - nyers instrukciók
+    Components::LinkedList<String> decodeInstructions( const Components::Recipe& recipe ) const;
+
+    /// A nyers instrukciók kódolása és eltárolása a receptben
+    /// @param recipe - recept
+    /// @param plain - nyers instrukciók
+    void encodeInstructions( Components::Recipe& recipe, const Components::LinkedList<String>& plain ) const;
+
+    /// Üres szótár esetén (üresen indított receptkönyv) a szótár tanítása a betöltött instrukciókon,
+    /// és az instrukciók újrakódolása - mentés előtt, hogy a fájlba már a tanított szótár kerüljön
+    void trainCodec();
+
     /// Hozzávalólista módosítása - fő metódus (művelet kiválasztása)
     /// @param list - lista amiben módosítani szeretnénk
     /// @return bool - módosítás sikeressége
@@ -67,17 +268,82 @@ private:
     bool removeIngredientQList( Components::LinkedList<Components::IngredientQ>* list );
 
 
+    /// A receptek száma (a memóriában, vagy a lemezes receptkönyvben)
+    size_t recipeCount() const;
+
+    /// Ha lemezes receptkönyv van megnyitva, kiírja, hogy a művelet nem érhető el
+    /// @return bool - lemezes receptkönyv van-e megnyitva
+    bool storeUnsupported() const;
+
+    /// A beolvasott receptlista áttöltése a lemezes receptkönyvbe (csak egyszer), majd a lista ürítése
+    void importToStore();
+
+    /// Lemezes receptkönyv: recept kiválasztása sorszám (cím szerinti sorrendben) vagy azonosító alapján
+    /// Hiba esetén kiírja a hibaüzenetet
+    /// @param buffer - felhasználói input
+    /// @param recipe - ide töltődik a recept
+    /// @return bool - sikeres-e
+    bool selectStored( const std::string& buffer, Components::Recipe& recipe );
+
+    /// Lemezes receptkönyv: a címek oldalankénti kiírása cím szerinti sorrendben (csak a címindex lapjait olvassa)
+    /// @param prefix - kisbetűs cím-előtag (üres = az összes)
+    /// @param part - a címben keresett kisbetűs részlet (üres = nincs szűrés)
+    void printStoredTitles( const std::string& prefix, const std::string& part );
+
+    /// Mint az előző, de a címindex olvasását a megadott műveletként méri (a kiírás nem számít bele)
+    /// @param op - mért művelet
+    void printStoredTitles( const std::string& prefix, const std::string& part, Stats::Operation op );
+
+    /// Lemezes receptkönyv: a címindex következő oldalnyi illeszkedő címe
+    /// A kurzort a következő illeszkedő címre (vagy a végére) állítja, így a valid() jelzi, van-e még oldal
+    /// @param it - kurzor
+    /// @param part - a címben keresett kisbetűs részlet (üres = nincs szűrés)
+    /// @param rows - ide kerülnek a (cím, azonosító) párok
+    void readStoredPage( File::RecipeStore::TitleCursor& it, const std::string& part,
+                         std::vector<std::pair<std::string, Components::Handle> >& rows ) const;
+
+    /// Lemezes receptkönyv: egy oldalnyi cím kiírása
+    /// @param rows - (cím, azonosító) párok
+    /// @param shown - az eddig kiírt címek száma, növeli
+    void printStoredPage( const std::vector<std::pair<std::string, Components::Handle> >& rows, size_t& shown ) const;
+
+    /// Lemezes receptkönyv: a betöltött recept módosítása és visszaírása
+    /// @param recipe - recept
+    void modifyStored( Components::Recipe& recipe );
+
     /// Keresés eredményét megjelenítő függvény
-    /// @param list - Result lista
-    void displaySearchResult( Components::LinkedList<Components::Result<Components::Recipe>* >& list );
+    /// A találatokat relevancia szerint rangsorolja, és oldalanként csak a következő PAGE_SIZE legjobbat
+    /// választja ki (korlátos kupaccal, az előző oldal utolsó eleme alatt) - a további oldalakat kérésre
+    /// @param hits - találatok
+    /// @param relevance - a keresés relevancia-számítása
+    void displaySearchResult( const std::vector<SearchHit>& hits, const Components::Relevance& relevance );
 public:
+    /// Recept keresése azonosító alapján - O(1)
+    /// @param id - recept azonosítója
+    /// @return Recipe* - a recept, ha nem létezik (vagy már törölték) nullptr
+    Components::Recipe* findRecipe( const Components::Handle& id );
+    const Components::Recipe* findRecipe( const Components::Handle& id ) const;
+
+    /// Recept törlése azonosító alapján - O(1)
+    /// @param id - recept azonosítója
+    /// @return bool - létezett-e a recept
+    bool eraseRecipe( const Components::Handle& id );
+
     /// Default konstruktor
     /// Létrehozza az adatszerkezetet, beolvassa az előzőleg mentett adatokat a fájlokból
-    Controller();
+    /// @param lazy - lusta mód: a receptek instrukcióit csak megtekintéskor / módosításkor tölti be
+    /// @param storePath - lemezes receptkönyv fájlja (üres = a receptek a memóriában vannak); ha a fájl
+    ///                    új, a recipes.dat tartalma áttöltődik bele
+    /// @param storeBudget - a lemezes receptkönyv memóriában tartott lapjainak összmérete bájtban
+    explicit Controller( bool lazy = false, const std::string& storePath = std::string(),
+                         size_t storeBudget = File::RecipeStore::DEFAULT_BUDGET );
 
     /// Receptek kilistázása
     void listRecipes();
 
+    /// Receptek kilistázása abc sorrendben, oldalanként
+    void listRecipesSorted();
+
     /// Kiválasztott recept megtekintése
     void displayRecipe();
 
@@ -116,22 +382,145 @@ public:
     /// Kiválasztott kamra-elem módosítása
     void modifyPantry();
 
+    /// Bevásárlólista a kiválasztott receptekhez
+    /// Összesíti a hozzávalókat, levonja a kamrában lévő mennyiséget, és kiírja a hiányzó tételeket
+    void shoppingList();
+
     /// Keresés a recept neve alapján
     void searchByRecipeName();
 
     /// Random recept keresése
     void searchRandom();
 
+    /// Keresés a recept nevének eleje alapján
+    void searchByPrefix();
+
+    /// A kiválasztott recepthez hasonló (közös hozzávalókat tartalmazó) receptek keresése
+    void searchSimilar();
+
     /// Keresés egy hozzávaló alapján
     void searchByOneIngredient();
 
     /// Keresés több hozzávaló alapján
     void serachByMoreIngredient();
 
+    /// Összetett keresés: cím-részlet, hozzávalók, kamrából elkészíthető, lépések száma (bármely kombináció)
+    /// Kiírja a végrehajtási tervet is
+    void searchCombined();
+
+
+    /// Futásidejű statisztikák kiírása szöveges formában
+    void printStats();
+
+    /// Futásidejű statisztikák kiírása JSON formátumban
+    void printStatsJson();
+
+    /// A listák memóriahasználatának kiírása (hasznos adat, szerkezeti és láncolási többlet, heap becslés)
+    void printMemory();
+
+    /// Elgépelés-tűrő keresés be- és kikapcsolása
+    void toggleFuzzySearch();
+
+    /// Lapozás be- és kikapcsolása
+    void togglePaging();
+
+    /// Menti az adatszerkezetet a fájlokba
+    /// @return bool - mindhárom fájl mentése sikerült-e
+    bool save();
+
+
+    // Kérés alapú (nem interaktív) interfész - a daemon mód használja
+    // Nem olvasnak a standard inputról: arg a kérés paramétere, az eredményt (hiba esetén a hibaüzenetet)
+    // az out kimenetre írják, és a visszatérési érték jelzi, hogy sikeres volt-e a kérés.
+    // A const kérések a közzétett pillanatképen futnak zár nélkül, így egymással és a módosító
+    // kérésekkel is párhuzamosan futhatnak; a módosító kéréseket a hívónak sorosítania kell.
+
+    /// Elindítja a pillanatképek közzétételét - a kérés alapú interfész használata előtt kell hívni
+    void startPublishing();
+
+    /// Receptek abc sorrendben; arg: üres (mind) vagy oldalszám
+    bool requestList( const std::string& arg, std::ostream& out ) const;
+
+    /// Recept megtekintése; arg: sorszám vagy #azonosito
+    bool requestShow( const std::string& arg, std::ostream& out ) const;
+
+    /// Keresés a recept nevében; arg: szövegrészlet
+    bool requestTitle( const std::string& arg, std::ostream& out ) const;
+
+    /// Keresés a név eleje alapján; arg: a név eleje
+    bool requestPrefix( const std::string& arg, std::ostream& out ) const;
+
+    /// Keresés hozzávalók alapján; arg: alapanyagnevek vesszővel elválasztva
+    bool requestIngredients( const std::string& arg, std::ostream& out ) const;
+
+    /// Hasonló receptek; arg: sorszám vagy #azonosito
+    bool requestSimilar( const std::string& arg, std::ostream& out ) const;
+
+    /// Új recept; arg: "nev | hozzavalo mertekegyseg mennyiseg, ... | instrukcio, ..."
+    bool requestAdd( const std::string& arg, std::ostream& out );
+
+    /// Recept törlése; arg: sorszám vagy #azonosito
+    bool requestRemove( const std::string& arg, std::ostream& out );
+
+    /// Recept átnevezése; arg: "sorszam vagy #azonosito | uj nev"
+    bool requestRename( const std::string& arg, std::ostream& out );
+
+    /// A listák memóriahasználata; arg: üres
+    /// A mesterlistákat olvassa, ezért a módosító kérésekkel együtt kell sorosítani
+    bool requestMemory( const std::string& arg, std::ostream& out );
+
     /// Destruktor
     /// Menti az adatszerkezetet a fájlokba
     ~Controller();
 };
 
+template<class Func>
+Controller::SearchHits Controller::cachedSearch( const std::string& key, const Func& match ) {
+    const SearchHits* cached = searchCache.find( key, recipeList.version() );
+    if ( cached != nullptr ) return *cached;
+
+    std::shared_ptr<std::vector<SearchHit> > hits = std::make_shared<std::vector<SearchHit> >();
+    Components::LinkedList<Components::Result<Components::Recipe>* > results = recipeList.search( match );
+    hits->reserve( results.size() );
+
+    typename Components::LinkedList<Components::Result<Components::Recipe>* >::Iterator it = results.begin();
+    for ( ; it != results.end(); it++ )
+    {
+        hits->push_back( SearchHit( (*it)->getOrder(), (*it)->getPtr()->getId() ) );
+        delete *it;
+    }
+
+    searchCache.insert( key, recipeList.version(), hits, hits->size() + 1 );
+    return hits;
+}
+
+template<class T>
+void Controller::indexNames( Components::LinkedList<T>& list, bool add ) {
+    typename Components::LinkedList<T>::Iterator it = list.begin();
+    for ( ; it != list.end(); it++ )
+    {
+        if ( add ) addName( it->getName().c_str() );
+        else removeName( it->getName().c_str() );
+    }
+}
+
+template<class T>
+void Controller::printPaged( Components::LinkedList<T>& list ) {
+    if ( list.empty() ) { std::cout << "A lista ures." << std::endl; return; }
+
+    size_t page = 1;
+    if ( !askPage( list.size(), page ) ) return;
+
+    size_t pages = ( list.size() + PAGE_SIZE - 1 ) / PAGE_SIZE;
+    if ( page == 0 ) { Components::Pager<T>( list, list.size() ).next( std::cout ); return; }
+
+    Components::Pager<T> pager( list, PAGE_SIZE, ( page - 1 ) * PAGE_SIZE );
+    do {
+        if ( pages > 1 ) std::cout << "[" << page << ". oldal / " << pages << "]\n";
+        pager.next( std::cout );
+        page++;
+    } while ( pager.hasNext() && askNextPage() );
+}
+
 
 #endif //NHF4_CONTROLLER_H
@@ -0,0 +1,132 @@
+/**
+ * \file crc32c.cpp
+ *
+ * Ez a fájl tartalmazza a Crc32c osztály megvalósítását
+ */
+
+#include <cstring>
+#include "crc32c.h"
+#include "memtrace.h"
+
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#include <nmmintrin.h>
+#define NHF_CRC32C_SSE42
+#endif
+
+namespace
+{
+    /// A Castagnoli polinom fordított bitsorrendben
+    const unsigned int POLYNOMIAL = 0x82f63b78u;
+
+    /**
+     * Tables struktúra
+     * A szoftveres számolás táblái: table[0] a szokásos bájtonkénti tábla, table[k] pedig k további
+     * nulla bájt hatását is tartalmazza, így 8 bájt 8 táblakereséssel dolgozható fel
+     */
+    struct Tables
+    {
+        unsigned int table[8][256];
+
+        Tables()
+        {
+            for ( unsigned int i = 0; i < 256; i++ )
+            {
+                unsigned int crc = i;
+                for ( int bit = 0; bit < 8; bit++ ) crc = ( crc >> 1 ) ^ ( ( crc & 1 ) ? POLYNOMIAL : 0 );
+                table[0][i] = crc;
+            }
+            for ( int k = 1; k < 8; k++ )
+                for ( unsigned int i = 0; i < 256; i++ )
+                    table[k][i] = ( table[k - 1][i] >> 8 ) ^ table[0][table[k - 1][i] & 0xff];
+        }
+    };
+
+    const Tables& tables()
+    {
+        static const Tables instance;
+        return instance;
+    }
+
+    /// 4 bájt kis helyiértékkel kezdve (a gép bájtsorrendjétől függetlenül)
+    unsigned int littleEndian( const unsigned char* p )
+    {
+        return (unsigned int)p[0] | ( (unsigned int)p[1] << 8 ) | ( (unsigned int)p[2] << 16 ) | ( (unsigned int)p[3] << 24 );
+    }
+
+#ifdef NHF_CRC32C_SSE42
+    __attribute__(( target( "sse4.2" ) ))
+    unsigned int extendHardware( unsigned int state, const char* data, size_t length )
+    {
+        // Igazításig bájtonként, utána 8 bájtonként
+        for ( ; length > 0 && ( reinterpret_cast<size_t>( data ) & 7 ) != 0; data++, length-- )
+            state = _mm_crc32_u8( state, (unsigned char)*data );
+
+        unsigned long long crc = state;
+        for ( ; length >= 8; data += 8, length -= 8 )
+        {
+            unsigned long long word;
+            std::memcpy( &word, data, sizeof( word ) );
+            crc = _mm_crc32_u64( crc, word );
+        }
+        state = (unsigned int)crc;
+
+        for ( ; length > 0; data++, length-- ) state = _mm_crc32_u8( state, (unsigned char)*data );
+        return state;
+    }
+#endif
+}
+
+unsigned int File::Crc32c::extend( unsigned int state, const char* data, size_t length ) {
+#ifdef NHF_CRC32C_SSE42
+    if ( hardware() ) return extendHardware( state, data, length );
+#endif
+    return extendTable( state, data, length );
+}
+
+unsigned int File::Crc32c::extendTable( unsigned int state, const char* data, size_t length ) {
+    const unsigned int (*table)[256] = tables().table;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>( data );
+
+    for ( ; length >= 8; p += 8, length -= 8 )
+    {
+        unsigned int low = littleEndian( p ) ^ state;
+        unsigned int high = littleEndian( p + 4 );
+        state = table[7][low & 0xff] ^ table[6][( low >> 8 ) & 0xff] ^ table[5][( low >> 16 ) & 0xff] ^ table[4][low >> 24]
+              ^ table[3][high & 0xff] ^ table[2][( high >> 8 ) & 0xff] ^ table[1][( high >> 16 ) & 0xff] ^ table[0][high >> 24];
+    }
+    for ( ; length > 0; p++, length-- ) state = ( state >> 8 ) ^ table[0][( state ^ *p ) & 0xff];
+    return state;
+}
+
+bool File::Crc32c::hardware() {
+#ifdef NHF_CRC32C_SSE42
+    static const bool available = ( __builtin_cpu_init(), __builtin_cpu_supports( "sse4.2" ) != 0 );
+    return available;
+#else
+    return false;
+#endif
+}
+
+std::string File::Crc32c::toHex( unsigned int value ) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text( 8, '0' );
+    for ( int i = 7; i >= 0; i--, value >>= 4 ) text[i] = digits[value & 0xf];
+    return text;
+}
+
+bool File::Crc32c::fromHex( const std::string& text, unsigned int& value ) {
+    if ( text.size() != 8 ) return false;
+
+    value = 0;
+    for ( size_t i = 0; i < text.size(); i++ )
+    {
+        char c = text[i];
+        unsigned int digit;
+        if ( c >= '0' && c <= '9' ) digit = c - '0';
+        else if ( c >= 'a' && c <= 'f' ) digit = c - 'a' + 10;
+        else if ( c >= 'A' && c <= 'F' ) digit = c - 'A' + 10;
+        else return false;
+        value = ( value << 4 ) | digit;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef NHF4_CRC32C_H
+#define NHF4_CRC32C_H
+/**
+ * \file crc32c.h
+ *
+ * Ez a fájl tartalmazza az adatfájlok blokkjainak ellenőrzéséhez szükséges Crc32c osztályt
+ */
+
+#include <string>
+#include "memtrace.h"
+
+namespace File
+{
+    /**
+     * Crc32c osztály
+     * CRC-32C (Castagnoli polinom) ellenőrzőösszeg, darabokban számolható. Ahol a processzor támogatja
+     * (x86-64, SSE4.2), a crc32 utasítással számol, 8 bájtot egyszerre; máshol 8 táblás (slicing-by-8)
+     * szoftveres módszerrel. A kettő eredménye azonos, a választás futásidőben, egyszer történik.
+     */
+    class Crc32c
+    {
+    private:
+        unsigned int state;     /// Részeredmény (invertálva)
+
+    public:
+        /// Default konstruktor - üres adat összege
+        Crc32c() :state( 0xffffffffu ) {};
+
+        /// Újrakezdés
+        void reset() { state = 0xffffffffu; }
+
+        /// Adat hozzáadása
+        /// @param data - adat
+        /// @param length - hossz bájtban
+        void update( const char* data, size_t length ) { state = extend( state, data, length ); }
+
+        /// Az eddig hozzáadott adat ellenőrzőösszege
+        /// @return unsigned int - CRC-32C
+        unsigned int value() const { return ~state; }
+
+        /// Részeredmény továbbszámolása a gyorsabb elérhető módszerrel
+        /// @param state - részeredmény
+        /// @param data - adat
+        /// @param length - hossz bájtban
+        /// @return unsigned int - új részeredmény
+        static unsigned int extend( unsigned int state, const char* data, size_t length );
+
+        /// Részeredmény továbbszámolása táblákkal (összehasonlításhoz, illetve ha nincs SSE4.2)
+        static unsigned int extendTable( unsigned int state, const char* data, size_t length );
+
+        /// A crc32 utasítás elérhető-e
+        static bool hardware();
+
+        /// Átalakítás 8 hexadecimális jegyre és vissza
+        /// @return bool - fromHex: helyes formátumú volt-e
+        static std::string toHex( unsigned int value );
+        static bool fromHex( const std::string& text, unsigned int& value );
+    };
+}
+
+#endif // NHF4_CRC32C_H
@@ -0,0 +1,216 @@
+/**
+ * \file daemon.cpp
+ *
+ * Ez a fájl tartalmazza a Daemon osztály megvalósítását
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "daemon.h"
+#include "protocol.h"
+#include "stats.h"
+#include "memtrace.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+std::atomic<bool> Daemon::stopRequested( false );
+
+namespace
+{
+    /// A daemon által ismert parancsok
+    const char* const HELP =
+            "LIST [oldal]          - receptek abc sorrendben\n"
+            "SHOW <sorszam|#id>    - recept megtekintese\n"
+            "TITLE <szoveg>        - kereses a nevben\n"
+            "PREFIX <szoveg>       - kereses a nev eleje alapjan\n"
+            "INGREDIENT <a, b, ..> - kereses hozzavalok alapjan\n"
+            "SIMILAR <sorszam|#id> - hasonlo receptek\n"
+            "ADD <nev> | <hozzavalo mertekegyseg mennyiseg,...> | <instrukcio,...>\n"
+            "REMOVE <sorszam|#id>  - recept torlese\n"
+            "RENAME <sorszam|#id> | <uj nev> - recept atnevezese\n"
+            "SAVE                  - mentes a fajlokba\n"
+            "STATS                 - statisztika (JSON)\n"
+            "MEMORY                - a listak memoriahasznalata\n"
+            "PING, HELP, SHUTDOWN\n";
+}
+
+Daemon::Daemon( Controller& c, const std::string& path )
+    :controller( c ), socketPath( path ), listener( -1 )
+{
+    // A keresések innentől a közzétett pillanatképen futnak
+    controller.startPublishing();
+}
+
+Daemon::~Daemon() {
+    if ( listener >= 0 ) close( listener );
+}
+
+void Daemon::onSignal( int ) {
+    stopRequested = true;
+}
+
+bool Daemon::listen() {
+    sockaddr_un addr;
+    std::memset( &addr, 0, sizeof( addr ) );
+    addr.sun_family = AF_UNIX;
+    if ( socketPath.size() >= sizeof( addr.sun_path ) ) { cerr << "Tul hosszu socket utvonal: \"" << socketPath << "\"" << endl; return false; }
+    std::strcpy( addr.sun_path, socketPath.c_str() );
+
+    listener = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( listener < 0 ) { cerr << "Nem sikerult socketet nyitni: " << std::strerror( errno ) << endl; return false; }
+
+    if ( access( socketPath.c_str(), F_OK ) == 0 )
+    {
+        // Ha valaki válaszol rajta, már fut egy daemon; különben egy korábbi futás maradványa
+        int probe = socket( AF_UNIX, SOCK_STREAM, 0 );
+        bool alive = probe >= 0 && connect( probe, (sockaddr*)&addr, sizeof( addr ) ) == 0;
+        if ( probe >= 0 ) close( probe );
+        if ( alive ) { cerr << "Mar fut egy daemon ezen a socketen: \"" << socketPath << "\"" << endl; return false; }
+        unlink( socketPath.c_str() );
+    }
+
+    if ( bind( listener, (sockaddr*)&addr, sizeof( addr ) ) != 0 || ::listen( listener, MAX_CLIENTS ) != 0 )
+    {
+        cerr << "Nem sikerult a socketet megnyitni: \"" << socketPath << "\": " << std::strerror( errno ) << endl;
+        return false;
+    }
+    return true;
+}
+
+int Daemon::run() {
+    struct sigaction action;
+    std::memset( &action, 0, sizeof( action ) );
+    action.sa_handler = onSignal;
+    sigemptyset( &action.sa_mask );
+    sigaction( SIGINT, &action, nullptr );
+    sigaction( SIGTERM, &action, nullptr );
+    signal( SIGPIPE, SIG_IGN );
+
+    if ( !listen() ) return 1;
+    cout << "[Daemon fut: " << socketPath << "]" << endl;
+
+    while ( !stopRequested )
+    {
+        pollfd waiting;
+        waiting.fd = listener;
+        waiting.events = POLLIN;
+        if ( poll( &waiting, 1, POLL_INTERVAL ) <= 0 ) continue;
+
+        int fd = accept( listener, nullptr, nullptr );
+        if ( fd < 0 ) continue;
+
+        std::lock_guard<std::mutex> guard( clientsMutex );
+        if ( clients.size() >= MAX_CLIENTS )
+        {
+            Protocol::writeAll( fd, Protocol::response( false, "Tul sok kapcsolat, probald ujra kesobb!" ) );
+            close( fd );
+            continue;
+        }
+        clients.push_back( fd );
+        std::thread( &Daemon::serve, this, fd ).detach();
+    }
+
+    close( listener );
+    listener = -1;
+    unlink( socketPath.c_str() );
+
+    // A várakozó kapcsolatokat felébresztjük, majd megvárjuk, hogy lezáruljanak
+    std::unique_lock<std::mutex> guard( clientsMutex );
+    for ( size_t i = 0; i < clients.size(); i++ ) shutdown( clients[i], SHUT_RDWR );
+    while ( !clients.empty() ) clientsDone.wait( guard );
+
+    cout << "[Daemon leallt]" << endl;
+    return 0;
+}
+
+void Daemon::serve( int fd ) {
+    // A jeleket a fő szál kezeli
+    sigset_t signals;
+    sigemptyset( &signals );
+    sigaddset( &signals, SIGINT );
+    sigaddset( &signals, SIGTERM );
+    pthread_sigmask( SIG_BLOCK, &signals, nullptr );
+
+    Protocol::LineReader reader( fd );
+    std::string line;
+    while ( !stopRequested && reader.next( line ) )
+    {
+        std::ostringstream body;
+        bool ok;
+        try {
+            ok = dispatch( line, body );
+        } catch ( std::exception& ex ) {
+            // Egy hibás kérés nem állíthatja le a daemont - a kapcsolat megmarad
+            body.str( std::string() );
+            body << "Hiba a keres feldolgozasa kozben: " << ex.what() << endl;
+            ok = false;
+        }
+        if ( !Protocol::writeAll( fd, Protocol::response( ok, body.str() ) ) ) break;
+    }
+
+    // A listából a lezárással együtt vesszük ki, így leállításkor nem kaphat shutdown()-t egy újrahasznosított leíró
+    std::lock_guard<std::mutex> guard( clientsMutex );
+    clients.erase( std::remove( clients.begin(), clients.end(), fd ), clients.end() );
+    close( fd );
+    clientsDone.notify_all();
+}
+
+bool Daemon::dispatch( const std::string& line, std::ostream& out ) {
+    static const struct { const char* name; Query query; } queries[] = {
+            { "LIST", &Controller::requestList },
+            { "SHOW", &Controller::requestShow },
+            { "TITLE", &Controller::requestTitle },
+            { "PREFIX", &Controller::requestPrefix },
+            { "INGREDIENT", &Controller::requestIngredients },
+            { "SIMILAR", &Controller::requestSimilar }
+    };
+    static const struct { const char* name; Command command; } commands[] = {
+            { "ADD", &Controller::requestAdd },
+            { "REMOVE", &Controller::requestRemove },
+            { "RENAME", &Controller::requestRename },
+            { "MEMORY", &Controller::requestMemory }
+    };
+
+    // PARANCS parameter - a parancs kis- és nagybetűvel is jó
+    size_t space = line.find( ' ' );
+    std::string name = line.substr( 0, space );
+    std::string arg = space == std::string::npos ? std::string() : line.substr( space + 1 );
+    for ( size_t i = 0; i < name.size(); i++ ) name[i] = (char)std::toupper( (unsigned char)name[i] );
+
+    for ( size_t i = 0; i < sizeof( queries ) / sizeof( queries[0] ); i++ )
+        if ( name == queries[i].name ) return (controller.*(queries[i].query))( arg, out );
+
+    for ( size_t i = 0; i < sizeof( commands ) / sizeof( commands[0] ); i++ )
+        if ( name == commands[i].name )
+        {
+            std::lock_guard<std::mutex> guard( writer );
+            return (controller.*(commands[i].command))( arg, out );
+        }
+
+    if ( name == "SAVE" )
+    {
+        std::lock_guard<std::mutex> guard( writer );
+        bool saved = controller.save();
+        out << ( saved ? "Az adatok mentesre kerultek a fajlokba" : "Hiba tortent az adatok mentese soran" ) << endl;
+        return saved;
+    }
+    if ( name == "STATS" ) { Stats::dumpJson( out ); return true; }
+    if ( name == "PING" ) { out << "PONG" << endl; return true; }
+    if ( name == "HELP" ) { out << HELP; return true; }
+    if ( name == "SHUTDOWN" ) { stopRequested = true; out << "A daemon leall" << endl; return true; }
+
+    out << "Ismeretlen parancs: \"" << name << "\" (HELP: parancsok listaja)" << endl;
+    return false;
+}
@@ -0,0 +1,86 @@
+#ifndef NHF4_DAEMON_H
+#define NHF4_DAEMON_H
+/**
+ * \file daemon.h
+ *
+ * Ez a fájl tartalmazza a daemon módot megvalósító Daemon osztályt
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "memtrace.h"
+#include "controller.h"
+
+
+/**
+ * Daemon osztály
+ * A betöltött adatszerkezetet a memóriában tartja, és Unix domain socketen szolgálja ki a kéréseket
+ * (a protokoll leírása a protocol.h-ban), így a lekérdezéseknek nem kell újra beolvasniuk a fájlokat.
+ * Minden kapcsolatot külön szál szolgál ki. Az olvasó kérések zár nélkül, a Controller közzétett
+ * pillanatképén futnak, így egymással és a módosításokkal is párhuzamosak; a módosító kérések
+ * (ADD, REMOVE, RENAME, SAVE) egymás után, és mindegyik után új pillanatkép kerül közzétételre.
+ * Leállításkor (SHUTDOWN kérés, SIGINT, SIGTERM) megvárja a futó kapcsolatokat; a mentést a
+ * Controller destruktora végzi.
+ */
+class Daemon
+{
+private:
+    /// Olvasó kérés: a Controller const kérés-metódusa
+    typedef bool (Controller::*Query)( const std::string&, std::ostream& ) const;
+
+    /// Módosító kérés: a Controller nem const kérés-metódusa
+    typedef bool (Controller::*Command)( const std::string&, std::ostream& );
+
+    enum { MAX_CLIENTS = 64 };      /// Egyszerre kiszolgált kapcsolatok
+    enum { POLL_INTERVAL = 500 };   /// A leállítási kérés ellenőrzésének gyakorisága (ms)
+
+    Controller& controller;         /// A kiszolgált adatszerkezet
+    std::string socketPath;         /// A socket fájl útvonala
+    int listener;                   /// Figyelő socket
+    std::mutex writer;              /// A módosító kéréseket sorosítja
+
+    std::mutex clientsMutex;                /// A kapcsolatok listáját védi
+    std::condition_variable clientsDone;    /// Jelez, ha egy kapcsolat lezárult
+    std::vector<int> clients;               /// Nyitott kapcsolatok
+
+    static std::atomic<bool> stopRequested; /// Leállítás kérve (a jelkezelő is állítja)
+
+    /// Másolás tiltása
+    Daemon( const Daemon& );
+    Daemon& operator=( const Daemon& );
+
+    /// A jelkezelő - csak a leállítást kéri
+    static void onSignal( int );
+
+    /// Egy kapcsolat kiszolgálása (külön szálon)
+    /// @param fd - a kapcsolat socketje
+    void serve( int fd );
+
+    /// Egy kérés végrehajtása
+    /// @param line - a kérés sora
+    /// @param out - a válasz törzse
+    /// @return bool - sikeres volt-e
+    bool dispatch( const std::string& line, std::ostream& out );
+
+    /// Figyelő socket létrehozása (a régi, elárvult socket fájlt törli)
+    /// @return bool - sikerült-e
+    bool listen();
+
+public:
+    /// Konstruktor
+    /// @param c - a kiszolgált adatszerkezet
+    /// @param path - a socket fájl útvonala
+    Daemon( Controller& c, const std::string& path );
+
+    /// Kéréseket fogad a leállításig
+    /// @return int - a program kilépési kódja
+    int run();
+
+    /// Destruktor
+    ~Daemon();
+};
+
+#endif // NHF4_DAEMON_H
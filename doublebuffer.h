@@ -0,0 +1,100 @@
+#ifndef NHF4_DOUBLEBUFFER_H
+#define NHF4_DOUBLEBUFFER_H
+/**
+ * \file doublebuffer.h
+ *
+ * Ez a fájl tartalmazza a közzétett indexek másolás nélküli frissítését megvalósító DoubleBuffer osztályt
+ */
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "memtrace.h"
+
+namespace Components
+{
+    /**
+     * DoubleBuffer osztály
+     * Egy nagy, drágán másolható index (hasonlósági index, BK-fa) két példánya a pillanatképekhez.
+     * Az író a munkapéldányt módosítja, a pillanatképek a közzétett példányt kapják (shared_ptr), ami már
+     * nem módosul. Közzétételkor a két példány szerepet cserél: a munkapéldány lesz a közzétett, a korábban
+     * közzétett pedig az új munkapéldány, amin az író a következő módosítás előtt lejátssza az azóta
+     * elmaradt műveleteket (napló). Így egy módosítás költsége a műveletek számával arányos, nem az index
+     * méretével. Másolás csak az első közzétételkor történik, és ha a régi példányt egy még élő (olvasó
+     * által tartott) pillanatkép használja.
+     * A műveleteknek lejátszáskor ugyanazt az eredményt kell adniuk, mint először (pl. a recept aktuális
+     * állapotából frissítenek, vagy a szót érték szerint tárolják).
+     * Közzététel előtt nem naplóz, így közzététel nélkül nincs többletköltség.
+     */
+    template<class T>
+    class DoubleBuffer
+    {
+    public:
+        /// Egy módosító művelet
+        typedef std::function<void( T& )> Operation;
+
+    private:
+        std::shared_ptr<T> working;     /// Munkapéldány (az író ezt módosítja)
+        std::shared_ptr<T> published;   /// Legutóbb közzétett példány (nullptr, ha még nem volt közzététel)
+        std::vector<Operation> log;     /// Elmaradt műveletek: stale esetén a munkapéldányé, egyébként a közzétetté
+        bool stale;                     /// A munkapéldányon még le kell játszani a naplót
+
+        /// Másolás tiltása
+        DoubleBuffer( const DoubleBuffer& );
+        DoubleBuffer& operator=( const DoubleBuffer& );
+
+        /// A munkapéldány naprakésszé tétele: a napló lejátszása, vagy ha még pillanatkép használja, másolás
+        void sync();
+
+    public:
+        /// Default konstruktor - üres index
+        DoubleBuffer() :working( std::make_shared<T>() ), stale( false ) {};
+
+        /// Az index aktuális állapota (az író olvasásaihoz)
+        const T& get() const { return stale ? *published : *working; }
+
+        /// Módosítás végrehajtása a munkapéldányon (közzététel után a naplóba is bekerül)
+        /// @param operation - művelet
+        void apply( const Operation& operation );
+
+        /// A közzéteendő példány: ha az utolsó közzététel óta nem változott, ugyanaz, mint legutóbb
+        /// @return std::shared_ptr<const T> - a pillanatképnek átadható példány
+        std::shared_ptr<const T> share();
+    };
+
+    template<class T>
+    void DoubleBuffer<T>::sync() {
+        if ( !stale ) return;
+
+        // A pillanatképeket az író (Rcu::publish) szabadítja fel, így ha csak mi tartjuk, már olvasó sem látja
+        if ( working.use_count() == 1 )
+        {
+            for ( size_t i = 0; i < log.size(); i++ ) log[i]( *working );
+        }
+        else working = std::make_shared<T>( *published );
+
+        log.clear();
+        stale = false;
+    }
+
+    template<class T>
+    void DoubleBuffer<T>::apply( const Operation& operation ) {
+        sync();
+        operation( *working );
+        if ( published ) log.push_back( operation );
+    }
+
+    template<class T>
+    std::shared_ptr<const T> DoubleBuffer<T>::share() {
+        if ( !published ) published = std::make_shared<T>( *working );
+        else if ( !stale && !log.empty() )
+        {
+            // A napló innentől a régi közzétett példány (az új munkapéldány) lemaradását jelenti
+            working.swap( published );
+            stale = true;
+        }
+        return published;
+    }
+}
+
+#endif // NHF4_DOUBLEBUFFER_H
@@ -1 +1 @@
-#include "file.h"#include "components.h"#include "memtrace.h"/** * \file file.cpp * * Ez a fájl tartalmazza a fájlból olvasáshoz, és fájlba íráshoz szükséges osztályok tagfüggvényeinek megvalósítását */using namespace std;void File::Writer::write() {    ofstream file;    if ( !file.fail() )    {        file.open( path.c_str() );        file << buffer;        file.close();    }    else    {        throw ofstream::failure( "Error while writing to file" );    }}void File::Writer::parse(Components::LinkedList<String> &input) {    buffer = "<Instructions>\n";    Components::LinkedList<String>::Iterator start = input.begin();    Components::LinkedList<String>::Iterator end = input.end();    while ( start != end )    {        buffer = buffer + (*start) + "\n";        start++;    }    buffer = buffer + "</Instructions>";}void File::Writer::parse(Components::LinkedList<Components::IngredientQ> &input) {    buffer = "<IngredientQ>\n";    Components::LinkedList<Components::IngredientQ>::Iterator start = input.begin();    Components::LinkedList<Components::IngredientQ>::Iterator end = input.end();    while ( start != end )    {        stringstream stream;        stream << start->getQuantity();        buffer = buffer + start->getName() + ";" + start->getUnit() + ";" + (stream.str().c_str()) + "\n";        start++;    }    buffer = buffer + "</IngredientQ>";}void File::Writer::parse(Components::LinkedList<Components::Recipe> &input) {    String tmpBuffer = "<RecipeList>\n";    Components::LinkedList<Components::Recipe>::Iterator start = input.begin();    Components::LinkedList<Components::Recipe>::Iterator end = input.end();    while ( start != end )    {        tmpBuffer = tmpBuffer + "<Recipe>\n<Title>\n" + start->getTitle() + "\n</Title>\n";        parse( *start->getIngredients() );        tmpBuffer = tmpBuffer + buffer + "\n";        parse( *start->getInstructions() );        tmpBuffer = tmpBuffer + buffer + "\n</Recipe>\n";        start++;    }    tmpBuffer = tmpBuffer + "</RecipeList>";    buffer = tmpBuffer;}void File::Writer::parse(Components::LinkedList<Components::Ingredient> &input) {    buffer = "<Ingredient>\n";    Components::LinkedList<Components::Ingredient>::Iterator start = input.begin();    Components::LinkedList<Components::Ingredient>::Iterator end = input.end();    while ( start != end )    {        buffer = buffer + start->getName() + ";" + start->getUnit() + "\n";        start++;    }    buffer = buffer + "</Ingredient>";}void File::Reader::read() {    string line;    ifstream file( path.c_str() );    buffer.clear();    if ( file.is_open() )    {        while ( getline ( file,line ) )        {            string tmp = line;            trim( tmp );            if ( !tmp.empty() ) buffer.push( line.c_str() );        }        file.close();    }    else    {        throw ifstream::failure("Hiba tortent a(z) \"" + std::string(path.c_str()) + "\" megnyitasa kozben!");    }}void File::Reader::parseRecipe( Components::LinkedList<Components::Recipe>& newList ) {    Components::LinkedList<String>::Iterator start = buffer.begin();    Components::LinkedList<String>::Iterator end = buffer.end();    bool read = false;    int stage = 0;    Components::Recipe* currentRecipe;    for ( ; start != end; start++ )    {        if ( (*start) == "<RecipeList>" ) { read = true; continue; }        else if ( (*start) == "</RecipeList>" ) { read = false; continue; }        if ( read && (*start) == "<Recipe>" ) { stage = 1; currentRecipe = new Components::Recipe(); continue; }        if ( read && (*start) == "</Recipe>" )        {            stage = 0;            std::string tmp = currentRecipe->getTitle().c_str();            if ( !trim(tmp).empty() ) newList.push( *currentRecipe );            currentRecipe->setInstructions(nullptr);            currentRecipe->setIngredients(nullptr);            delete currentRecipe;            continue;        }        if ( !read ) continue;        switch ( stage )        {            case 1: // Title            {                if ( (*start) == "<Title>" ) continue;                if ( (*start) == "</Title>" ) { stage++; continue; }                currentRecipe->setTitle( *start );                break;            }            case 2: // IngredientQ            {                if ( (*start) == "<IngredientQ>" ) { currentRecipe->setIngredients( new Components::LinkedList<Components::IngredientQ>() ); continue; }                if ( (*start) == "</IngredientQ>" ) { stage++; continue; }                if ( (*start).size() < 3 ) continue;                std::stringstream line( (*start).c_str() );                std::vector<std::string> list;                std::string segment;                while ( std::getline( line, segment, ';' ) )                {                    list.push_back( segment );                }                int num;                try {                    if ( list.size() != 3 || list[0].empty() || list[1].empty() ) throw std::invalid_argument("hibas sor");                    num = std::stoi( list[2] );                } catch( ... ) { cerr << "Hibas formatum fajlbeolvasas kozben! Hibas sor: \"" << *start << "\"" << endl; break; }                if ( currentRecipe->getIngredients()->contains( Components::IngredientQ( String(list[0].c_str()), String(), 0 ) ) ) continue;                currentRecipe->getIngredients()->push( Components::IngredientQ( String(list[0].c_str()), String(list[1].c_str()), num ) );                break;            }            case 3: // Instructions            {                if ( (*start) == "<Instructions>" ) { currentRecipe->setInstructions( new Components::LinkedList<String>() ); continue; }                if ( (*start) == "</Instructions>" ) { stage = 1; continue; }                std::string tmp = start->c_str();                if ( !trim(tmp).empty() ) currentRecipe->getInstructions()->push( *start );                break;            }        }    }}void File::Reader::parseIngredient(Components::LinkedList<Components::Ingredient>& newList) {    Components::LinkedList<String>::Iterator start = buffer.begin();    Components::LinkedList<String>::Iterator end = buffer.end();    Components::Ingredient* currentIngredient;    bool read = false;    for ( ; start != end; start++ )    {        if ( (*start) == "<Ingredient>" ) { read = true; continue; }        else if ( (*start) == "</Ingredient>" ) { read = false; continue; }        if ( !read ) continue;        std::stringstream line( (*start).c_str() );        std::vector<std::string> list;        std::string segment;        while ( std::getline( line, segment, ';' ) )        {            list.push_back( segment );        }        if ( list.size() != 2 || list[0].empty() || list[1].empty() ) { cerr << "Hibas sor fajlbeolvasas kozban! Kapott input: \"" << *start << "\"" << endl; continue; }        if ( newList.contains( Components::Ingredient( String(list[0].c_str()), String() ) ) ) continue;        currentIngredient =  new Components::Ingredient(String(list[0].c_str()), String(list[1].c_str()));        newList.push( *currentIngredient );        delete currentIngredient;    }}void File::Reader::parseIngredientQ( Components::LinkedList<Components::IngredientQ>& newList ) {    Components::LinkedList<String>::Iterator start = buffer.begin();    Components::LinkedList<String>::Iterator end = buffer.end();    Components::IngredientQ* currentIngredientQ;    bool read = false;    for ( ; start != end; start++ )    {        if ( (*start) == "<IngredientQ>" ) { read = true; continue; }        else if ( (*start) == "</IngredientQ>" ) { read = false; continue; }        if ( !read ) continue;        std::stringstream line( (*start).c_str() );        std::vector<std::string> list;        std::string segment;        while ( std::getline( line, segment, ';' ) )        {            list.push_back( segment );        }        int num;        try {            if ( list.size() != 3 || list[0].empty() || list[1].empty() ) throw std::invalid_argument("hibas input");            num = std::stoi( list[2] );        } catch ( ... ) { cerr << "Hibas sor fajlbeolvasas kozban! Kapott input: \"" << *start << "\"" << endl; continue; }        if ( newList.contains( Components::IngredientQ( String(list[0].c_str()), String(), 0 ) ) ) continue;        currentIngredientQ =  new Components::IngredientQ(String(list[0].c_str()), String(list[1].c_str()), num);        newList.push( *currentIngredientQ );        delete currentIngredientQ;    }}
\ No newline at end of file
+#include <algorithm>#include <cerrno>#include <climits>#include <cstdio>#include <cstring>#include <thread>#include <fcntl.h>#include <sys/stat.h>#include <sys/uio.h>#include <unistd.h>#include "asyncio.h"#include "file.h"#include "components.h"#include "memtrace.h"/** * \file file.cpp * * Ez a fájl tartalmazza a fájlból olvasáshoz, és fájlba íráshoz szükséges osztályok tagfüggvényeinek megvalósítását */using namespace std;namespace{    /// A fájlrészlet nem üres sorainak listába töltése    /// @param block - fájlrészlet    /// @param lines - ide kerülnek a sorok    void splitLines( const string& block, Components::LinkedList<String>& lines )    {        stringstream stream( block );        string line;        while ( getline( stream, line ) )        {            string tmp = line;            if ( !trim( tmp ).empty() ) lines.emplace( line.c_str() );        }    }    /// Az ellenőrzött blokk záró sorának hozzáfűzése    /// @param out - a kiírandó szöveg    /// @param from - a blokk eleje    void appendChecksum( string& out, size_t from )    {        File::Crc32c crc;        crc.update( out.data() + from, out.size() - from );        out += "<Checksum>" + File::Crc32c::toHex( crc.value() ) + "</Checksum>\n";    }    /// Instrukciólista kiírható formája (<Instructions> blokk, az utolsó sorvég nélkül)    /// @param out - ide fűzi    /// @param input - lista    void appendInstructions( string& out, const Components::LinkedList<String>& input )    {        out += "<Instructions>\n";        for ( Components::LinkedList<String>::Iterator it( input ); it != Components::LinkedList<String>::Iterator(); it++ )        {            out.append( it->c_str(), it->size() );            out += "\n";        }        out += "</Instructions>";    }    /// Hozzávalólista kiírható formája (<IngredientQ> blokk, az utolsó sorvég nélkül)    /// @param out - ide fűzi    /// @param input - lista    void appendIngredients( string& out, const Components::LinkedList<Components::IngredientQ>& input )    {        out += "<IngredientQ>\n";        for ( Components::LinkedList<Components::IngredientQ>::Iterator it( input ); it != Components::LinkedList<Components::IngredientQ>::Iterator(); it++ )        {            String name = it->getName();            String unit = it->getUnit();            char quantity[16];            snprintf( quantity, sizeof( quantity ), "%u", it->getQuantity() );            out.append( name.c_str(), name.size() );            out += ";";            out.append( unit.c_str(), unit.size() );            out += ";";            out += quantity;            out += "\n";        }        out += "</IngredientQ>";    }    /// Ellenőrzőösszeg sor beolvasása    /// @param line - sor    /// @param value - ide kerül az összeg    /// @return bool - <Checksum>xxxxxxxx</Checksum> alakú-e    bool parseChecksum( const string& line, unsigned int& value )    {        static const string open = "<Checksum>", close = "</Checksum>";        if ( line.size() != open.size() + 8 + close.size() ) return false;        if ( line.compare( 0, open.size(), open ) != 0 || line.compare( open.size() + 8, close.size(), close ) != 0 ) return false;        return File::Crc32c::fromHex( line.substr( open.size(), 8 ), value );    }}void File::Writer::write() {    string target = path.c_str();    string temporary = target + ".tmp";    int fd = ::open( temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666 );    if ( fd < 0 ) throw ofstream::failure( "Error while writing to file" );    // A darabok egy vektoros írásban (nagyon sok darabnál IOV_MAX-onként) kerülnek ki, összefűzés nélkül    std::vector<struct iovec> parts;    for ( size_t i = 0; i < chunks.size(); i++ )    {        if ( chunks[i].empty() ) continue;        struct iovec part;        part.iov_base = const_cast<char*>( chunks[i].data() );        part.iov_len = chunks[i].size();        parts.push_back( part );    }    bool failed = false;    size_t next = 0;    while ( next < parts.size() )    {        int count = (int)std::min( parts.size() - next, (size_t)IOV_MAX );        ssize_t n = ::writev( fd, &parts[next], count );        if ( n < 0 && errno == EINTR ) continue;        if ( n <= 0 ) { failed = true; break; }        // Részleges írás - a kiírt darabokat átlépjük, a félig kiírtat megvágjuk        size_t done = (size_t)n;        for ( ; next < parts.size() && done >= parts[next].iov_len; next++ ) done -= parts[next].iov_len;        if ( done > 0 )        {            parts[next].iov_base = static_cast<char*>( parts[next].iov_base ) + done;            parts[next].iov_len -= done;        }    }    // Az átnevezés előtt az adatnak a lemezen kell lennie, különben összeomlás után üres vagy csonka fájl maradhat    if ( !failed && ::fsync( fd ) != 0 ) failed = true;    if ( ::close( fd ) != 0 ) failed = true;    if ( failed || std::rename( temporary.c_str(), target.c_str() ) != 0 )    {        std::remove( temporary.c_str() );        throw ofstream::failure( "Error while writing to file" );    }    // Az átnevezés a könyvtár bejegyzése - azt is ki kell írni    size_t slash = target.rfind( '/' );    string directory = slash == string::npos ? string( "." ) : slash == 0 ? string( "/" ) : target.substr( 0, slash );    int dir = ::open( directory.c_str(), O_RDONLY | O_DIRECTORY );    if ( dir >= 0 )    {        ::fsync( dir );        ::close( dir );    }}void File::Writer::parse(Components::LinkedList<String> &input) {    chunks.assign( 1, string() );    appendInstructions( chunks[0], input );}void File::Writer::parse(Components::LinkedList<Components::IngredientQ> &input) {    chunks.assign( 1, string() );    appendIngredients( chunks[0], input );}void File::Writer::serialize( const std::vector<const Components::Recipe*>& recipes, size_t from, size_t to, const String& source,                              string& out, std::vector<Components::TextRange>& ranges, string& error ) {    // A forrásfájlt csak akkor nyitjuk meg (egyszer), ha van lustán betöltött recept    ifstream sourceFile;    for ( size_t i = from; i < to; i++ )    {        const Components::Recipe& recipe = *recipes[i];        size_t checkedStart = out.size();        out += "<Recipe>\n<Title>\n";        out.append( recipe.getTitle().c_str(), recipe.getTitle().size() );        out += "\n</Title>\n";        appendIngredients( out, *recipe.getIngredients() );        out += "\n";        size_t blockStart = out.size();        if ( recipe.instructionsLoaded() ) appendInstructions( out, *recipe.getInstructions() );        else        {            // Lustán betöltött recept - az instrukciókat a forrásfájlból vesszük át            if ( !sourceFile.is_open() )            {                sourceFile.open( source.c_str(), ios::binary );                if ( !sourceFile.is_open() ) { error = "Hiba tortent a(z) \"" + string( source.c_str() ) + "\" megnyitasa kozben!"; return; }            }            Components::LinkedList<String> instructions;            try {                Reader::readRange( sourceFile, recipe.getInstructionRange(), instructions );            } catch ( ifstream::failure& ex ) { error = ex.what(); return; }            appendInstructions( out, instructions );        }        // A blokk tartalma a nyitó tag sora után kezdődik, és a záró tag előtt ér véget        const long long open = strlen( "<Instructions>\n" ), close = strlen( "</Instructions>" );        ranges.push_back( Components::TextRange( (long long)blockStart + open, (long long)( out.size() - blockStart ) - open - close ) );        out += "\n</Recipe>\n";        appendChecksum( out, checkedStart );    }}void File::Writer::parse(Components::LinkedList<Components::Recipe> &input, const Components::TextCodec& codec, unsigned int threads) {    ranges.clear();    // Fejléc és szótár    string head = "<RecipeList>\n";    head += CHECKSUMS_HEADER;    head += "\n";    size_t checkedStart = head.size();    head += "<Dictionary>\n";    for ( size_t i = 0; i < codec.size(); i++ ) head += Components::TextCodec::toHex( codec.entry( i ) ) + "\n";    head += "</Dictionary>\n";    appendChecksum( head, checkedStart );    std::vector<const Components::Recipe*> recipes;    recipes.reserve( input.size() );    for ( Components::LinkedList<Components::Recipe>::Iterator it = input.begin(); it != input.end(); it++ ) recipes.push_back( &*it );    if ( threads == 0 ) threads = std::thread::hardware_concurrency();    if ( threads == 0 ) threads = 1;    size_t maxThreads = recipes.size() / MIN_RECIPES_PER_THREAD;    if ( threads > maxThreads ) threads = maxThreads > 0 ? (unsigned int)maxThreads : 1;    // Szeletenként külön darab és külön helylista, így a szálaknak nem kell zárolniuk    std::vector<string> parts( threads );    std::vector< std::vector<Components::TextRange> > partRanges( threads );    std::vector<string> errors( threads );    size_t slice = ( recipes.size() + threads - 1 ) / threads;    if ( threads == 1 ) serialize( recipes, 0, recipes.size(), source, parts[0], partRanges[0], errors[0] );    else    {        std::vector<std::thread> workers;        for ( unsigned int t = 0; t < threads; t++ )        {            size_t from = t * slice;            size_t to = std::min( recipes.size(), from + slice );            workers.push_back( std::thread( serialize, std::cref( recipes ), from, to, std::cref( source ),                                            std::ref( parts[t] ), std::ref( partRanges[t] ), std::ref( errors[t] ) ) );        }        for ( size_t t = 0; t < workers.size(); t++ ) workers[t].join();    }    for ( size_t t = 0; t < errors.size(); t++ )        if ( !errors[t].empty() ) throw ofstream::failure( errors[t] );    // A szeletek helyei a fájl elejéhez képest    long long offset = (long long)head.size();    ranges.reserve( recipes.size() );    for ( size_t t = 0; t < threads; t++ )    {        for ( size_t i = 0; i < partRanges[t].size(); i++ )            ranges.push_back( Components::TextRange( partRanges[t][i].offset + offset, partRanges[t][i].length ) );        offset += (long long)parts[t].size();    }    chunks.clear();    chunks.reserve( threads + 2 );    chunks.push_back( string() );    chunks.back().swap( head );    for ( size_t t = 0; t < threads; t++ )    {        chunks.push_back( string() );        chunks.back().swap( parts[t] );    }    chunks.push_back( "</RecipeList>" );}void File::Writer::parse(Components::LinkedList<Components::Ingredient> &input) {    chunks.assign( 1, "<Ingredient>\n" );    string& out = chunks[0];    Components::LinkedList<Components::Ingredient>::Iterator start = input.begin();    Components::LinkedList<Components::Ingredient>::Iterator end = input.end();    while ( start != end )    {        String name = start->getName();        String unit = start->getUnit();        out.append( name.c_str(), name.size() );        out += ";";        out.append( unit.c_str(), unit.size() );        out += "\n";        start++;    }    out += "</Ingredient>";}void File::Reader::read() {    buffer.clear();    ranges.clear();    damaged = 0;    int fd = ::open( path.c_str(), O_RDONLY );    if ( fd < 0 ) throw ifstream::failure("Hiba tortent a(z) \"" + std::string(path.c_str()) + "\" megnyitasa kozben!");    struct stat info;    long long size = fstat( fd, &info ) == 0 ? (long long)info.st_size : 0;    // Egyszerre legfeljebb DEPTH blokk olvasása fut, a beérkezett blokkot közben dolgozzuk fel    AsyncIO& io = AsyncIO::instance();    const long long block = AsyncIO::BLOCK;    long long count = ( size + block - 1 ) / block;    AsyncIO::Buffer slots[AsyncIO::DEPTH];    unsigned long long tickets[AsyncIO::DEPTH];    long long submitted = 0;    for ( ; submitted < count && submitted < AsyncIO::DEPTH; submitted++ )    {        slots[submitted].allocate( (size_t)std::min( block, size ) );        tickets[submitted] = io.read( fd, slots[submitted].data(), (size_t)std::min( block, size - submitted * block ), submitted * block );    }    Scan scan;    string line;    bool failed = false;    long long k = 0;    for ( ; k < count; k++ )    {        int slot = (int)( k % AsyncIO::DEPTH );        long long expected = std::min( block, size - k * block );        long long received = io.wait( tickets[slot] );        if ( received < 0 ) { failed = true; k++; break; }        // Sorokra bontás - a blokkhatáron átnyúló sor a következő blokkban folytatódik        const char* data = slots[slot].data();        const char* end = data + received;        while ( data < end )        {            const char* newline = (const char*)memchr( data, '\n', end - data );            if ( newline == nullptr ) { line.append( data, end - data ); break; }            line.append( data, newline - data );            scanLine( line, scan );            line.clear();            data = newline + 1;        }        // Az AsyncIO a rövid olvasásokat folytatja, így kevesebb bájt csak a fájl végén jöhet:        // a fájl időközben rövidebb lett, itt a vége        if ( received < expected ) { k++; break; }        if ( submitted < count )        {            tickets[slot] = io.read( fd, slots[slot].data(), (size_t)std::min( block, size - submitted * block ), submitted * block );            submitted++;        }    }    // A még futó olvasásokat meg kell várni, mielőtt a pufferek felszabadulnak    for ( ; k < submitted; k++ ) io.wait( tickets[k % AsyncIO::DEPTH] );    ::close( fd );    if ( failed ) throw ifstream::failure("Hiba tortent a(z) \"" + std::string(path.c_str()) + "\" olvasasa kozben!");    // Az utolsó, sorvége nélküli sor    if ( !line.empty() ) scanLine( line, scan );    // Lezáratlan ellenőrzött blokk - a fájl csonka    if ( scan.checked ) closeChecked( scan, false );    // Lezáratlan blokk - a fájl végéig tart    if ( scan.blockStart >= 0 ) ranges.push_back( Components::TextRange( scan.blockStart, scan.offset - scan.blockStart ) );}void File::Reader::scanLine( const string& line, Scan& scan ) {    long long lineStart = scan.offset;    scan.offset += line.size() + 1;    if ( line == "<Dictionary>" ) scan.compressed = true;    if ( line == CHECKSUMS_HEADER ) scan.checksummed = true;    if ( scan.checksummed )    {        // Új blokk kezdődik - az előző, ha nem zárult le, csonka        if ( line == "<Recipe>" || line == "<Dictionary>" )        {            if ( scan.checked ) closeChecked( scan, false );            scan.checked = true;            scan.dictionary = line == "<Dictionary>";            scan.checkedStart = lineStart;            scan.checkedLines = 0;            scan.checkedRanges = ranges.size();            scan.crc.reset();        }        unsigned int expected;        if ( parseChecksum( line, expected ) )        {            if ( scan.checked ) closeChecked( scan, expected == scan.crc.value() );            return;        }        if ( scan.checked )        {            scan.crc.update( line.data(), line.size() );            scan.crc.update( "\n", 1 );        }    }    if ( lazy && scan.compressed )    {        if ( scan.blockStart < 0 && line == "<Instructions>" ) scan.blockStart = scan.offset;        else if ( scan.blockStart >= 0 && line == "</Instructions>" )        {            ranges.push_back( Components::TextRange( scan.blockStart, lineStart - scan.blockStart ) );            scan.blockStart = -1;        }        else if ( scan.blockStart >= 0 ) return;    }    string tmp = line;    trim( tmp );    if ( tmp.empty() ) return;    buffer.emplace( line.c_str() );    if ( scan.checked ) scan.checkedLines++;}void File::Reader::closeChecked( Scan& scan, bool intact ) {    scan.checked = false;    if ( intact ) return;    if ( scan.dictionary )    {        // A szótár nélkül egyik recept instrukciói sem olvashatók, ezért megtartjuk        cerr << "Serult szotar a(z) \"" << path << "\" fajlban, az instrukciok hibasak lehetnek!" << endl;        return;    }    for ( ; scan.checkedLines > 0; scan.checkedLines-- ) buffer.erase( buffer.last() );    ranges.erase( ranges.begin() + scan.checkedRanges, ranges.end() );    scan.blockStart = -1;    damaged++;    cerr << "Serult recept a(z) \"" << path << "\" fajlban (" << scan.checkedStart << ". bajttol), kihagyva!" << endl;}void File::Reader::readRange( const String& path, const Components::TextRange& range, Components::LinkedList<String>& lines ) {    ifstream file( path.c_str(), ios::binary );    if ( !file.is_open() ) throw ifstream::failure("Hiba tortent a(z) \"" + std::string(path.c_str()) + "\" megnyitasa kozben!");    readRange( file, range, lines );}void File::Reader::readRange( std::istream& file, const Components::TextRange& range, Components::LinkedList<String>& lines ) {    std::string block( (size_t)range.length, '\0' );    file.clear();    file.seekg( range.offset );    file.read( &block[0], range.length );    if ( file.bad() || ( file.fail() && !file.eof() ) ) throw ifstream::failure("Hiba tortent az instrukciok olvasasa kozben!");    block.resize( (size_t)file.gcount() );    splitLines( block, lines );}void File::Reader::parseRecipe( Components::LinkedList<Components::Recipe>& newList, Components::TextCodec& codec ) {    Components::LinkedList<String>::Iterator start = buffer.begin();    Components::LinkedList<String>::Iterator end = buffer.end();    bool read = false;    int stage = 0;    size_t blocks = 0;  // lusta módban az eddig látott instrukció-blokkok száma    bool dictionary = false;    // a szótár blokkban vagyunk-e    bool compressed = false;    // volt-e szótár a fájlban    // A receptet közvetlenül a lista végén hozzuk létre, így nincs másolás    Components::LinkedList<Components::Recipe>::Iterator current;    Components::Recipe* currentRecipe = nullptr;    for ( ; start != end; start++ )    {        if ( lazy && (*start) == "<Instructions>" ) blocks++;        if ( (*start) == "<RecipeList>" ) { read = true; continue; }        else if ( (*start) == "</RecipeList>" ) { read = false; continue; }        if ( (*start) == "<Dictionary>" ) { dictionary = compressed = true; codec.clear(); continue; }        if ( dictionary )        {            if ( (*start) == "</Dictionary>" ) { dictionary = false; continue; }            std::string entry;            if ( Components::TextCodec::fromHex( start->c_str(), entry ) ) codec.add( entry );            else cerr << "Hibas szotar elem fajlbeolvasas kozben! Hibas sor: \"" << *start << "\"" << endl;            continue;        }        if ( read && (*start) == "<Recipe>" ) { stage = 1; current = newList.emplace(); currentRecipe = &*current; continue; }        if ( read && (*start) == "</Recipe>" && currentRecipe != nullptr )        {            stage = 0;            std::string tmp = currentRecipe->getTitle().c_str();            if ( trim(tmp).empty() ) newList.erase( current );            currentRecipe = nullptr;            continue;        }        if ( !read || currentRecipe == nullptr ) continue;        switch ( stage )        {            case 1: // Title            {                if ( (*start) == "<Title>" ) continue;                if ( (*start) == "</Title>" ) { stage++; continue; }                currentRecipe->setTitle( *start );                break;            }            case 2: // IngredientQ            {                if ( (*start) == "<IngredientQ>" ) { currentRecipe->getIngredients()->clear(); continue; }                if ( (*start) == "</IngredientQ>" ) { stage++; continue; }                if ( (*start).size() < 3 ) continue;                std::stringstream line( (*start).c_str() );                std::vector<std::string> list;                std::string segment;                while ( std::getline( line, segment, ';' ) )                {                    list.push_back( segment );                }                int num;                try {                    if ( list.size() != 3 || list[0].empty() || list[1].empty() ) throw std::invalid_argument("hibas sor");                    num = std::stoi( list[2] );                } catch( ... ) { cerr << "Hibas formatum fajlbeolvasas kozben! Hibas sor: \"" << *start << "\"" << endl; break; }                if ( currentRecipe->getIngredients()->contains( Components::IngredientQ( String(list[0].c_str()), String(), 0 ) ) ) continue;                currentRecipe->getIngredients()->emplace( String(list[0].c_str()), String(list[1].c_str()), num );                break;            }            case 3: // Instructions            {                if ( (*start) == "<Instructions>" )                {                    currentRecipe->getInstructions()->clear();                    if ( lazy && blocks <= ranges.size() ) currentRecipe->setInstructionRange( ranges[blocks-1] );                    continue;                }                if ( (*start) == "</Instructions>" ) { stage = 1; continue; }                std::string tmp = start->c_str();                if ( !trim(tmp).empty() ) currentRecipe->getInstructions()->push( *start );                break;            }        }    }    if ( compressed ) return;    // Régi (tömörítetlen) formátum - szótár tanítása, ha még nincs, majd az instrukciók kódolása    Components::LinkedList<Components::Recipe>::Iterator it;    if ( codec.size() == 0 )    {        std::vector<std::string> samples;        for ( it = newList.begin(); it != newList.end(); it++ )            for ( Components::LinkedList<String>::Iterator line = it->getInstructions()->begin(); line != it->getInstructions()->end(); line++ )                samples.push_back( line->c_str() );        codec.train( samples );    }    for ( it = newList.begin(); it != newList.end(); it++ )        for ( Components::LinkedList<String>::Iterator line = it->getInstructions()->begin(); line != it->getInstructions()->end(); line++ )            *line = String( codec.encode( line->c_str() ).c_str() );}void File::Reader::parseIngredient(Components::LinkedList<Components::Ingredient>& newList) {    Components::LinkedList<String>::Iterator start = buffer.begin();    Components::LinkedList<String>::Iterator end = buffer.end();    bool read = false;    for ( ; start != end; start++ )    {        if ( (*start) == "<Ingredient>" ) { read = true; continue; }        else if ( (*start) == "</Ingredient>" ) { read = false; continue; }        if ( !read ) continue;        std::stringstream line( (*start).c_str() );        std::vector<std::string> list;        std::string segment;        while ( std::getline( line, segment, ';' ) )        {            list.push_back( segment );        }        if ( list.size() != 2 || list[0].empty() || list[1].empty() ) { cerr << "Hibas sor fajlbeolvasas kozban! Kapott input: \"" << *start << "\"" << endl; continue; }        if ( newList.contains( Components::Ingredient( String(list[0].c_str()), String() ) ) ) continue;        newList.emplace( String(list[0].c_str()), String(list[1].c_str()) );    }}void File::Reader::parseIngredientQ( Components::LinkedList<Components::IngredientQ>& newList ) {    Components::LinkedList<String>::Iterator start = buffer.begin();    Components::LinkedList<String>::Iterator end = buffer.end();    bool read = false;    for ( ; start != end; start++ )    {        if ( (*start) == "<IngredientQ>" ) { read = true; continue; }        else if ( (*start) == "</IngredientQ>" ) { read = false; continue; }        if ( !read ) continue;        std::stringstream line( (*start).c_str() );        std::vector<std::string> list;        std::string segment;        while ( std::getline( line, segment, ';' ) )        {            list.push_back( segment );        }        int num;        try {            if ( list.size() != 3 || list[0].empty() || list[1].empty() ) throw std::invalid_argument("hibas input");            num = std::stoi( list[2] );        } catch ( ... ) { cerr << "Hibas sor fajlbeolvasas kozban! Kapott input: \"" << *start << "\"" << endl; continue; }        if ( newList.contains( Components::IngredientQ( String(list[0].c_str()), String(), 0 ) ) ) continue;        newList.emplace( String(list[0].c_str()), String(list[1].c_str()), num );    }}File::Source::Source( const String& path ) :fd( ::open( path.c_str(), O_RDONLY ) ) {    if ( fd < 0 ) throw ifstream::failure("Hiba tortent a(z) \"" + std::string(path.c_str()) + "\" megnyitasa kozben!");}File::Source::~Source() {    ::close( fd );}void File::Source::readRange( const Components::TextRange& range, Components::LinkedList<String>& lines ) const {    std::string block( (size_t)range.length, '\0' );    size_t done = 0;    while ( done < block.size() )    {        ssize_t n = ::pread( fd, &block[done], block.size() - done, (off_t)( range.offset + done ) );        if ( n < 0 && errno == EINTR ) continue;        if ( n < 0 ) throw ifstream::failure("Hiba tortent az instrukciok olvasasa kozben!");        if ( n == 0 ) break;        done += (size_t)n;    }    block.resize( done );    splitLines( block, lines );}
\ No newline at end of file
@@ -9,39 +9,88 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <vector>
 #include "string5.h"
 #include "list.h"
 #include "components.h"
+#include "textcodec.h"
+#include "crc32c.h"
 #include "memtrace.h"
 
 namespace File
 {
+    /// A receptfájl ellenőrzött blokkjai: a szótár és minden recept után egy <Checksum>xxxxxxxx</Checksum> sor
+    /// áll, amely a blokk nyitó sorától a záró sorig (sorvégekkel együtt) számolt CRC-32C-t tartalmazza.
+    /// A formátumot a <RecipeList> utáni fejlécsor jelzi; a fejléc nélküli (régi) fájl ellenőrzés nélkül töltődik be.
+    const char* const CHECKSUMS_HEADER = "<Checksums>crc32c</Checksums>";
+
     /**
      * Writer osztály
      * Az adatszerkezet fájlba írását megvalósító osztály
+     * A kiírandó szöveg darabokban áll össze (a receptlistánál szálanként egy darab), a darabokat
+     * összefűzés nélkül, vektoros írással (writev) írja ki
      */
     class Writer
     {
+    public:
+        enum { MIN_RECIPES_PER_THREAD = 256 };  /// Ennél kevesebb receptet nem érdemes külön szálon feldolgozni
+
     private:
         String path;    /// Fájl útvonala
-        String buffer;  /// Buffer - parse-oláshoz szükséges ideiglenes tároló -> ez kerül kiírásra a fájlba
+        String source;  /// A még be nem töltött instrukciókat tartalmazó fájl útvonala
+        std::vector<std::string> chunks;    /// A fájlba kerülő szöveg darabjai, fájlbeli sorrendben
+        std::vector<Components::TextRange> ranges;  /// A receptek instrukció-blokkjainak helye a kiírt fájlban
+
+        /// A receptek egy szeletének kiírható formára alakítása (szálanként)
+        /// @param recipes - receptek
+        /// @param from - a szelet eleje
+        /// @param to - a szelet vége (kizárva)
+        /// @param source - a lustán betöltött receptek forrásfájlja
+        /// @param out - ide kerül a szöveg
+        /// @param ranges - ide kerülnek az instrukció-blokkok helyei (a szelet elejéhez képest)
+        /// @param error - hiba esetén az üzenet (a szálból nem dobható tovább a kivétel)
+        static void serialize( const std::vector<const Components::Recipe*>& recipes, size_t from, size_t to, const String& source,
+                               std::string& out, std::vector<Components::TextRange>& ranges, std::string& error );
 
     public:
         /// Default konstruktor - inicializálja a fájl utvonalát
+        /// A be nem töltött instrukciókat ugyanebből a fájlból olvassa (a kiírás előtt)
         /// @param p - a fájl útvonala
-        explicit Writer( const String& p ) :path( p ) {};
+        explicit Writer( const String& p ) :path( p ), source( p ) {};
 
-        /// Kiírja a buffert a fájlba
+        /// Konstruktor - inicializálja a fájl és a forrásfájl útvonalát
+        /// @param p - a fájl útvonala
+        /// @param src - a lustán betöltött receptek forrásfájlja
+        Writer( const String& p, const String& src ) :path( p ), source( src ) {};
+
+        /// Kiírja a darabokat a fájlba
+        /// Előbb egy ideiglenes fájlba ír, majd azt nevezi át, így a fájl mindig teljes
+        /// (a régi tartalmat már megnyitott olvasók továbbra is a régit látják)
         /// ofstream::failure hibát dob, ha nem sikerült a művelet
         void write();
 
         /// Parse függvények
-        /// A paraméterben kapott listát írható formátumú szöveggé alakítja, majd menti a bufferbe
+        /// A paraméterben kapott listát írható formátumú szöveggé alakítja (a korábbi tartalom helyére)
         /// @param input - a kiírni kívánt lista
-        void parse( Components::LinkedList<Components::Recipe>& input );
         void parse( Components::LinkedList<Components::Ingredient>& input );
         void parse( Components::LinkedList<Components::IngredientQ>& input );
         void parse( Components::LinkedList<String>& input );
+
+        /// A receptlistát a tömörítő szótárával együtt írja ki
+        /// Az instrukciók a memóriában is kódolva vannak, így változatlanul kerülnek a fájlba
+        /// A szótár és minden recept blokkja ellenőrzőösszeggel zárul
+        /// A receptek szeletei párhuzamosan, szálanként külön darabba kerülnek
+        /// ofstream::failure hibát dob, ha a lustán betöltött receptek forrásfájlja nem olvasható
+        /// @param input - a kiírni kívánt lista
+        /// @param codec - az instrukciók kódolásához használt szótár
+        /// @param threads - szálak száma, 0 esetén a hardver alapján választ
+        void parse( Components::LinkedList<Components::Recipe>& input, const Components::TextCodec& codec, unsigned int threads = 0 );
+
+        /// A legutóbb kiírt receptlista instrukció-blokkjainak helye (a receptek sorrendjében)
+        /// Mentés után a lustán betöltött receptek ezekre állíthatók át
+        /// @return const std::vector<TextRange>& - fájlrészletek
+        const std::vector<Components::TextRange>& instructionRanges() const { return ranges; }
     };
 
     /**
@@ -53,22 +102,114 @@ namespace File
     private:
         String path;    /// Fájl útvonala
         Components::LinkedList<String> buffer;  /// Buffer - ideiglenes tároláshoz szükséges lista
+        bool lazy;      /// Lusta mód - az instrukciókat nem olvassa be, csak a helyüket jegyzi fel
+        std::vector<Components::TextRange> ranges;  /// Lusta módban az instrukció-blokkok helye, fájlbeli sorrendben
+        size_t damaged; /// A legutóbbi beolvasáskor kihagyott sérült blokkok
+
+        /// A soronkénti feldolgozás állapota
+        struct Scan
+        {
+            long long offset;       /// A következő sor eleje
+            long long blockStart;   /// Az aktuális instrukció-blokk eleje (lusta mód), -1 ha nincs
+            bool compressed;        /// Volt-e már szótár (csak a tömörített formátum olvasható lustán)
+            bool checksummed;       /// A fájl blokkjai ellenőrzőösszeggel zárulnak-e
+            bool checked;           /// Ellenőrzött blokkban vagyunk-e
+            bool dictionary;        /// Az ellenőrzött blokk a szótár-e (ez nem hagyható ki)
+            long long checkedStart; /// Az ellenőrzött blokk eleje (hibaüzenethez)
+            int checkedLines;       /// Az ellenőrzött blokkból a bufferbe került sorok
+            size_t checkedRanges;   /// Az instrukció-blokkok száma az ellenőrzött blokk elején
+            Crc32c crc;             /// Az ellenőrzött blokk eddigi összege
+
+            Scan() :offset( 0 ), blockStart( -1 ), compressed( false ), checksummed( false ), checked( false ),
+                    dictionary( false ), checkedStart( 0 ), checkedLines( 0 ), checkedRanges( 0 ) {};
+        };
+
+        /// Egy beolvasott sor feldolgozása: a bufferbe teszi, vagy (lusta módban) átugorja az instrukció-blokkot
+        /// @param line - sor (sorvége nélkül)
+        /// @param scan - a feldolgozás állapota
+        void scanLine( const std::string& line, Scan& scan );
+
+        /// Az ellenőrzött blokk lezárása: ha az összeg nem egyezik (vagy a blokk nem zárult le), a blokk sorait
+        /// és instrukció-helyeit eldobja, és jelzi a hibát (a szótárat csak jelzi)
+        /// @param scan - a feldolgozás állapota
+        /// @param intact - egyezett-e az összeg
+        void closeChecked( Scan& scan, bool intact );
 
     public:
         /// Default konstruktor - inicializálja a fájl útvonalát
         /// @param p - fájl útvonala
-        explicit Reader( const String& p ) :path( p ), buffer(Components::LinkedList<String>()) {};
+        /// @param l - lusta mód
+        explicit Reader( const String& p, bool l = false ) :path( p ), buffer(Components::LinkedList<String>()), lazy( l ), damaged( 0 ) {};
 
         /// Beolvassa az összes sort a megadott fájlból
+        /// A fájlt nagy blokkokban, aszinkron olvassa (AsyncIO), és a következő blokkok olvasása közben
+        /// dolgozza fel az előzőt
+        /// Lusta módban az <Instructions> blokkok tartalmát kihagyja, és feljegyzi a bájt tartományukat
+        /// (csak tömörített fájlnál, azaz ha a fájl <Dictionary> blokkal kezdődik - a régi formátumot teljesen beolvassa)
+        /// Ellenőrzött fájlnál a sérült vagy csonka recept blokkokat a cerr-re jelzi és kihagyja
         /// ifstream::failure hibát dob, ha nem sikerült a művelet
         void read();
 
+        /// A legutóbbi beolvasáskor kihagyott sérült blokkok száma
+        size_t corruptedBlocks() const { return damaged; }
+
+        /// Beolvassa a megadott fájlrészlet nem üres sorait
+        /// ifstream::failure hibát dob, ha nem sikerült a művelet
+        /// @param path - fájl útvonala
+        /// @param range - fájlrészlet
+        /// @param lines - ide tölti a sorokat
+        static void readRange( const String& path, const Components::TextRange& range, Components::LinkedList<String>& lines );
+
+        /// Beolvassa a megadott fájlrészlet nem üres sorait egy már megnyitott fájlból
+        /// ifstream::failure hibát dob, ha nem sikerült a művelet
+        /// @param file - megnyitott (bináris) fájl
+        /// @param range - fájlrészlet
+        /// @param lines - ide tölti a sorokat
+        static void readRange( std::istream& file, const Components::TextRange& range, Components::LinkedList<String>& lines );
+
         /// Parse függvények
         /// A paraméterben kapott listába tölti a beolvasott elemeket, egy séma alapján
         /// @param ing - lista referenciája, amibe betöltjük a beolvasott elemeket
         void parseIngredientQ( Components::LinkedList<Components::IngredientQ>& ing );
         void parseIngredient( Components::LinkedList<Components::Ingredient>& ing );
-        void parseRecipe( Components::LinkedList<Components::Recipe>& ing );
+
+        /// A receptek instrukciói kódolva kerülnek a listába
+        /// Ha a fájlban van szótár, azt tölti a codec-be; ha nincs (régi formátum), és a codec üres,
+        /// a beolvasott instrukciókon tanítja, majd kódolja őket
+        /// @param ing - lista referenciája, amibe betöltjük a beolvasott elemeket
+        /// @param codec - tömörítő szótár
+        void parseRecipe( Components::LinkedList<Components::Recipe>& ing, Components::TextCodec& codec );
+    };
+
+    /**
+     * Source osztály
+     * Megnyitott receptfájl, amelyből több szál egyszerre olvashat fájlrészleteket (pread, közös pozíció nélkül)
+     * Mivel a mentés új fájlt ír és átnevezi a régi helyére, a megnyitott példány a mentés után is
+     * a régi tartalmat látja - így a régi fájlrészletek a mentés után is érvényesek maradnak rajta
+     */
+    class Source
+    {
+    private:
+        int fd;     /// Fájlleíró
+
+        /// Másolás tiltása
+        Source( const Source& );
+        Source& operator=( const Source& );
+
+    public:
+        /// Konstruktor - megnyitja a fájlt
+        /// ifstream::failure hibát dob, ha nem sikerült a művelet
+        /// @param path - fájl útvonala
+        explicit Source( const String& path );
+
+        /// Destruktor - bezárja a fájlt
+        ~Source();
+
+        /// Beolvassa a megadott fájlrészlet nem üres sorait
+        /// ifstream::failure hibát dob, ha nem sikerült a művelet
+        /// @param range - fájlrészlet
+        /// @param lines - ide tölti a sorokat
+        void readRange( const Components::TextRange& range, Components::LinkedList<String>& lines ) const;
     };
 }
 
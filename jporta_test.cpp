@@ -1,7 +1,472 @@
+/**
+ * \file jporta_test.cpp
+ *
+ * Ez a fájl tartalmazza a tároló- és indexszerkezetek (B+fa, lappuffer, slot map, skip list, szövegtömörítő,
+ * crc32c, LRU gyorsítótár) ellenőrző tesztjeit
+ * Hiba esetén kiírja a hibás feltételt, és nem nulla kóddal lép ki; ha minden teszt sikeres, "Siker"-t ír ki.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "memtrace.h"
+#include "string5.h"
+#include "bufferpool.h"
+#include "btree.h"
+#include "slotmap.h"
+#include "skiplist.h"
+#include "textcodec.h"
+#include "crc32c.h"
+#include "lrucache.h"
+
+/// Hibás ellenőrzések száma
+static int failures = 0;
+
+/// Feltétel ellenőrzése: hiba esetén kiírja a helyét és a feltételt
+#define CHECK( cond ) \
+    do { if ( !( cond ) ) { failures++; std::cerr << __FILE__ << ":" << __LINE__ << ": HIBA: " << #cond << std::endl; } } while ( 0 )
+
+/// Determinisztikus álvéletlen számok (a futások összehasonlíthatók maradnak)
+static unsigned int nextRandom() {
+    static unsigned int state = 12345;
+    state = state * 1103515245u + 12345u;
+    return ( state >> 16 ) & 0x7fff;
+}
+
+/// Teszt kulcs a sorszámból (nem sorrendben érkeznek, így a fa szétválásai is előfordulnak)
+static std::string testKey( unsigned int n ) {
+    char buf[32];
+    std::snprintf( buf, sizeof( buf ), "kulcs%05u", n );
+    return buf;
+}
+
+/// Teszt érték: minden ötödik hosszabb, mint amit a levél tárolhat (túlcsordulási lánc, néha több lapos)
+static std::string testValue( unsigned int n, unsigned int round ) {
+    size_t length = n % 5 == 0 ? File::BPlusTree::MAX_INLINE + 1 + ( n * 977 ) % 9000 : 1 + n % 40;
+    std::string value( length, ' ' );
+    for ( size_t i = 0; i < length; i++ ) value[i] = (char)( 'a' + ( n + round + i ) % 26 );
+    return value;
+}
+
+/// A fa tartalmának összevetése a referenciával: elemszám, keresés és rendezett bejárás
+static void compareTree( File::BPlusTree& tree, const std::map<std::string, std::string>& expected ) {
+    CHECK( tree.size() == expected.size() );
+
+    std::map<std::string, std::string>::const_iterator it = expected.begin();
+    File::BPlusTree::Cursor cursor = tree.lowerBound( "" );
+    for ( ; cursor.valid() && it != expected.end(); ++cursor, ++it )
+    {
+        CHECK( cursor.key() == it->first );
+        CHECK( cursor.value() == it->second );
+    }
+    CHECK( !cursor.valid() );
+    CHECK( it == expected.end() );
+
+    for ( it = expected.begin(); it != expected.end(); ++it )
+    {
+        std::string value;
+        CHECK( tree.find( it->first, value ) );
+        CHECK( value == it->second );
+    }
+}
+
+/// B+fa a std::map-pel összevetve: beszúrás, felülírás, törlés, túlcsordulási láncok és újranyitás
+static void testBPlusTree() {
+    const char* path = "jporta_test_btree.db";
+    std::remove( path );
+
+    std::map<std::string, std::string> expected;
+    {
+        // Kis keretszám, hogy a lapok kiírása és visszaolvasása is előforduljon
+        File::BufferPool pool( path, 0 );
+        File::BPlusTree tree( pool, 0 );
+        CHECK( tree.size() == 0 );
+        CHECK( !tree.lowerBound( "" ).valid() );
+
+        for ( unsigned int round = 0; round < 3; round++ )
+        {
+            for ( unsigned int i = 0; i < 1500; i++ )
+            {
+                unsigned int n = nextRandom() % 2000;
+                std::string key = testKey( n );
+                bool fresh = expected.find( key ) == expected.end();
+                if ( round > 0 && nextRandom() % 3 == 0 )
+                {
+                    CHECK( tree.erase( key ) == !fresh );
+                    expected.erase( key );
+                }
+                else
+                {
+                    std::string value = testValue( n, round );
+                    CHECK( tree.insert( key, value ) == fresh );
+                    expected[key] = value;
+                }
+            }
+            compareTree( tree, expected );
+        }
+
+        std::string value;
+        CHECK( !tree.find( "nincs ilyen", value ) );
+        CHECK( !tree.erase( "nincs ilyen" ) );
+
+        // A lowerBound az első, nem kisebb kulcsra áll
+        File::BPlusTree::Cursor cursor = tree.lowerBound( "kulcs01000" );
+        std::map<std::string, std::string>::const_iterator it = expected.lower_bound( "kulcs01000" );
+        CHECK( cursor.valid() == ( it != expected.end() ) );
+        if ( cursor.valid() && it != expected.end() ) CHECK( cursor.key() == it->first );
+
+        // Túl hosszú kulcs
+        bool thrown = false;
+        try { tree.insert( std::string( File::BPlusTree::MAX_KEY + 1, 'k' ), "x" ); }
+        catch ( std::length_error& ) { thrown = true; }
+        CHECK( thrown );
+        CHECK( tree.insert( std::string( File::BPlusTree::MAX_KEY, 'k' ), "leghosszabb" ) );
+        expected[std::string( File::BPlusTree::MAX_KEY, 'k' )] = "leghosszabb";
+    }
+
+    // Újranyitás: a destruktor kiírta a lapokat, a tartalomnak meg kell maradnia
+    unsigned int pages = 0;
+    {
+        File::BufferPool pool( path, 0 );
+        File::BPlusTree tree( pool, 0 );
+        compareTree( tree, expected );
+
+        // Minden törlése: a felszabadított lapok (túlcsordulási láncok is) a szabadlistára kerülnek
+        while ( !expected.empty() )
+        {
+            CHECK( tree.erase( expected.begin()->first ) );
+            expected.erase( expected.begin() );
+        }
+        compareTree( tree, expected );
+        pages = pool.pages();
+        pool.flush();
+    }
+
+    // Újranyitás üresen, majd újratöltés: a felszabadított lapokat újrahasznosítja, a fájl nem nő
+    {
+        File::BufferPool pool( path, 0 );
+        File::BPlusTree tree( pool, 0 );
+        compareTree( tree, expected );
+        for ( unsigned int n = 0; n < 300; n++ )
+        {
+            CHECK( tree.insert( testKey( n ), testValue( n, 7 ) ) );
+            expected[testKey( n )] = testValue( n, 7 );
+        }
+        compareTree( tree, expected );
+        CHECK( pool.pages() <= pages );
+    }
+
+    std::remove( path );
+}
+
+/// Lappuffer: lapok írása, felszabadítása és újrahasznosítása, fejléc adatok újranyitás után
+static void testBufferPool() {
+    const char* path = "jporta_test_pool.db";
+    std::remove( path );
+
+    std::vector<unsigned int> ids;
+    {
+        File::BufferPool pool( path, 0 );
+        CHECK( pool.capacity() >= File::BufferPool::MIN_FRAMES );
+
+        // Több lap, mint keret: a kiszorított, módosult lapokat ki kell írni
+        for ( unsigned int i = 0; i < 3 * File::BufferPool::MIN_FRAMES; i++ )
+        {
+            File::BufferPool::Page page = pool.allocate();
+            CHECK( page.id() != 0 );
+            std::snprintf( page.edit(), File::PageFile::PAGE_SIZE, "lap %u", i );
+            ids.push_back( page.id() );
+        }
+        CHECK( pool.resident() <= pool.capacity() );
+
+        pool.setRoot( 1, ids[3] );
+        pool.setCounter( 2, 4242 );
+
+        // A felszabadított lap a következő foglaláskor (nullázva) visszajön
+        pool.release( ids.back() );
+        File::BufferPool::Page reused = pool.allocate();
+        CHECK( reused.id() == ids.back() );
+        CHECK( reused.data()[0] == 0 );
+        std::snprintf( reused.edit(), File::PageFile::PAGE_SIZE, "ujra" );
+    }
+
+    {
+        File::BufferPool pool( path, 0 );
+        CHECK( pool.root( 1 ) == ids[3] );
+        CHECK( pool.counter( 2 ) == 4242 );
+        CHECK( pool.root( 0 ) == 0 );
+        for ( size_t i = 0; i + 1 < ids.size(); i++ )
+        {
+            char expected[32];
+            std::snprintf( expected, sizeof( expected ), "lap %u", (unsigned int)i );
+            CHECK( std::string( pool.fetch( ids[i] ).data() ) == expected );
+        }
+        CHECK( std::string( pool.fetch( ids.back() ).data() ) == "ujra" );
+    }
+
+    // Nem ilyen formátumú fájl
+    {
+        std::string garbage( File::PageFile::PAGE_SIZE, 'x' );
+        std::FILE* f = std::fopen( path, "wb" );
+        if ( f ) { std::fwrite( garbage.data(), 1, garbage.size(), f ); std::fclose( f ); }
+        bool thrown = false;
+        try { File::BufferPool pool( path, 0 ); }
+        catch ( std::exception& ) { thrown = true; }
+        CHECK( thrown );
+    }
+
+    std::remove( path );
+}
+
+/// Slot map: az azonosítók generációja miatt törlés (és a hely újrafelhasználása) után a régi azonosító érvénytelen
+static void testSlotMap() {
+    Components::SlotMap<std::string> map;
+    Components::Handle a = map.insert( "alma" );
+    Components::Handle b = map.insert( "korte" );
+    CHECK( map.size() == 2 );
+    CHECK( !( a == b ) );
+    CHECK( map.get( a ) != nullptr && *map.get( a ) == "alma" );
+    CHECK( map.get( b ) != nullptr && *map.get( b ) == "korte" );
+
+    CHECK( map.erase( a ) );
+    CHECK( !map.erase( a ) );
+    CHECK( !map.contains( a ) );
+    CHECK( map.get( a ) == nullptr );
+
+    // Az új elem a felszabadult helyre kerül, de más generációval
+    Components::Handle c = map.insert( "szilva" );
+    CHECK( c.index == a.index );
+    CHECK( c.generation != a.generation );
+    CHECK( map.get( a ) == nullptr );
+    CHECK( map.get( c ) != nullptr && *map.get( c ) == "szilva" );
+    CHECK( map.get( b ) != nullptr && *map.get( b ) == "korte" );
+    CHECK( map.size() == 2 );
+
+    // Szöveges alak oda-vissza
+    std::ostringstream text;
+    text << c;
+    Components::Handle parsed;
+    CHECK( Components::Handle::parse( text.str(), parsed ) );
+    CHECK( parsed == c );
+    CHECK( Components::Handle::looksLike( "#3.1" ) );
+    CHECK( !Components::Handle::looksLike( "alma" ) );
+    CHECK( !Components::Handle::parse( "#3", parsed ) );
+    CHECK( !Components::Handle::parse( "#a.1", parsed ) );
+
+    map.clear();
+    CHECK( map.size() == 0 );
+    CHECK( map.get( b ) == nullptr );
+    CHECK( map.get( c ) == nullptr );
+}
+
+/// Skip list a std::set-tel összevetve: rendezettség, rang, rang szerinti elérés, törlés
+static void testSkipList() {
+    Components::SkipList<int> list;
+    std::set<int> expected;
+    CHECK( list.empty() );
+    CHECK( !list.begin().valid() );
+
+    for ( int i = 0; i < 3000; i++ )
+    {
+        int value = (int)( nextRandom() % 1000 );
+        if ( nextRandom() % 4 == 0 ) CHECK( list.erase( value ) == ( expected.erase( value ) == 1 ) );
+        else CHECK( list.insert( value ) == expected.insert( value ).second );
+    }
+    CHECK( list.size() == expected.size() );
+
+    size_t rank = 0;
+    Components::SkipList<int>::Cursor cursor = list.begin();
+    for ( std::set<int>::const_iterator it = expected.begin(); it != expected.end(); ++it, ++cursor, rank++ )
+    {
+        CHECK( cursor.valid() && *cursor == *it );
+        CHECK( list.rankOf( *it ) == rank );
+        CHECK( list.at( rank ).valid() && *list.at( rank ) == *it );
+    }
+    CHECK( !cursor.valid() );
+    CHECK( !list.at( expected.size() ).valid() );
+
+    // Nem szereplő elem rangja: az előtte lévő elemek száma
+    for ( int value = -1; value <= 1001; value += 37 )
+        CHECK( list.rankOf( value ) == (size_t)std::distance( expected.begin(), expected.lower_bound( value ) ) );
+
+    list.clear();
+    CHECK( list.empty() );
+    CHECK( list.insert( 5 ) );
+    CHECK( !list.insert( 5 ) );
+    CHECK( list.size() == 1 );
+}
+
+/// Szövegtömörítő: visszaalakítás, vezérlőbájtok kódolása, szótár szöveges alakja
+static void testTextCodec() {
+    std::vector<std::string> samples;
+    for ( int i = 0; i < 200; i++ )
+    {
+        samples.push_back( "Keverd ossze a lisztet es a cukrot, majd sussd 180 fokon" );
+        samples.push_back( "Forrald fel a vizet, add hozza a hagymat es a sot" );
+    }
+
+    Components::TextCodec codec;
+    CHECK( codec.size() == 0 );
+
+    // Üres szótárral a kódolás nem változtat a 7 bites szövegen
+    CHECK( codec.encode( "alma" ) == "alma" );
+
+    codec.train( samples );
+    CHECK( codec.size() > 0 );
+    CHECK( codec.size() <= Components::TextCodec::MAX_ENTRIES );
+
+    std::vector<std::string> texts( samples.begin(), samples.begin() + 2 );
+    texts.push_back( "" );
+    texts.push_back( "Hagyd kihulni, \xc3\xa9s t\xc3\xa1lald" );   // UTF-8 ékezetek (0x80 feletti bájtok)
+    texts.push_back( std::string( "\x80\x81\xfe\xff\x7f", 5 ) );         // a kódokkal egyező bájtok
+    std::string all;
+    for ( int c = 1; c < 256; c++ ) if ( c != '\n' ) all += (char)c;
+    texts.push_back( all );
+
+    for ( size_t i = 0; i < texts.size(); i++ )
+    {
+        std::string encoded = codec.encode( texts[i] );
+        CHECK( codec.decode( encoded ) == texts[i] );
+        CHECK( encoded.find( '\0' ) == std::string::npos );
+        CHECK( encoded.find( '\n' ) == std::string::npos );
+    }
+
+    // A tanított szövegek rövidülnek
+    CHECK( codec.encode( samples[0] ).size() < samples[0].size() );
+
+    // A szótár hexa alakból visszaépítve ugyanúgy dekódol
+    Components::TextCodec copy;
+    for ( size_t i = 0; i < codec.size(); i++ )
+    {
+        std::string entry;
+        CHECK( Components::TextCodec::fromHex( Components::TextCodec::toHex( codec.entry( i ) ), entry ) );
+        CHECK( entry == codec.entry( i ) );
+        copy.add( entry );
+    }
+    for ( size_t i = 0; i < texts.size(); i++ ) CHECK( copy.decode( codec.encode( texts[i] ) ) == texts[i] );
+
+    std::string entry;
+    CHECK( !Components::TextCodec::fromHex( "abc", entry ) );
+    CHECK( !Components::TextCodec::fromHex( "zz", entry ) );
+
+    codec.clear();
+    CHECK( codec.size() == 0 );
+}
+
+/// crc32c: szabványos ellenőrző érték, hardveres és táblás változat egyezése, darabolt számítás
+static void testCrc32c() {
+    const char* check = "123456789";
+    File::Crc32c crc;
+    crc.update( check, 9 );
+    CHECK( crc.value() == 0xE3069283u );
+    CHECK( ~File::Crc32c::extend( 0xffffffffu, check, 9 ) == 0xE3069283u );
+    CHECK( ~File::Crc32c::extendTable( 0xffffffffu, check, 9 ) == 0xE3069283u );
+
+    crc.reset();
+    CHECK( crc.value() == 0 );
+
+    // Hosszabb, nem igazított adat darabokban és egyben
+    std::string data;
+    for ( int i = 0; i < 5000; i++ ) data += (char)( nextRandom() & 0xff );
+    unsigned int whole = File::Crc32c::extend( 0xffffffffu, data.data(), data.size() );
+    CHECK( whole == File::Crc32c::extendTable( 0xffffffffu, data.data(), data.size() ) );
+    for ( size_t pos = 0; pos < data.size(); )
+    {
+        size_t length = std::min( data.size() - pos, (size_t)( 1 + nextRandom() % 97 ) );
+        crc.update( data.data() + pos, length );
+        pos += length;
+    }
+    CHECK( crc.value() == ~whole );
+
+    unsigned int value = 0;
+    CHECK( File::Crc32c::fromHex( File::Crc32c::toHex( 0xE3069283u ), value ) );
+    CHECK( value == 0xE3069283u );
+    CHECK( !File::Crc32c::fromHex( "xyz", value ) );
+}
+
+/// LRU gyorsítótár: kiszorítás elemszám és súly szerint, a legrégebben használt megy ki, változatváltás
+static void testLruCache() {
+    Components::LruCache<std::string, int> cache( 3, 10 );
+    cache.insert( "a", 1, 1, 1 );
+    cache.insert( "b", 1, 2, 1 );
+    cache.insert( "c", 1, 3, 1 );
+    CHECK( cache.size() == 3 );
+
+    // Az "a" használata után a "b" a legrégebbi, így az új elem azt szorítja ki
+    CHECK( cache.find( "a", 1 ) != nullptr && *cache.find( "a", 1 ) == 1 );
+    cache.insert( "d", 1, 4, 1 );
+    CHECK( cache.size() == 3 );
+    CHECK( cache.find( "b", 1 ) == nullptr );
+    CHECK( cache.find( "a", 1 ) != nullptr );
+    CHECK( cache.find( "c", 1 ) != nullptr );
+    CHECK( cache.find( "d", 1 ) != nullptr );
+
+    // Felülírás: az érték és a súly is cserélődik
+    cache.insert( "d", 1, 40, 2 );
+    CHECK( *cache.find( "d", 1 ) == 40 );
+    CHECK( cache.weight() == 4 );
+
+    // Súlykorlát: a nehéz elem a legrégebben használtat ("a") szorítja ki, a többi belefér
+    cache.insert( "e", 1, 5, 7 );
+    CHECK( cache.weight() == 10 );
+    CHECK( cache.size() == 3 );
+    CHECK( cache.find( "a", 1 ) == nullptr );
+    CHECK( cache.find( "c", 1 ) != nullptr );
+    CHECK( cache.find( "e", 1 ) != nullptr );
+
+    // A korlátnál nehezebb érték nem kerül be, és nem szorít ki semmit
+    cache.insert( "f", 1, 6, 11 );
+    CHECK( cache.find( "f", 1 ) == nullptr );
+    CHECK( cache.size() == 3 );
+
+    // Újabb elem: a legrégebben használt "d" megy ki (a "c" és az "e" keresése frissítette a sorrendet)
+    cache.insert( "h", 1, 8, 2 );
+    CHECK( cache.size() == 3 );
+    CHECK( cache.weight() == 10 );
+    CHECK( cache.find( "d", 1 ) == nullptr );
+    CHECK( cache.find( "c", 1 ) != nullptr );
+    CHECK( cache.find( "h", 1 ) != nullptr );
+
+    // Új változat: minden korábbi bejegyzés elavult
+    CHECK( cache.find( "d", 2 ) == nullptr );
+    CHECK( cache.size() == 0 );
+    CHECK( cache.weight() == 0 );
+    cache.insert( "g", 2, 7, 1 );
+    CHECK( cache.find( "g", 2 ) != nullptr );
+
+    cache.clear();
+    CHECK( cache.size() == 0 );
+}
 
 int main()
 {
+    try {
+        testBPlusTree();
+        testBufferPool();
+        testSlotMap();
+        testSkipList();
+        testTextCodec();
+        testCrc32c();
+        testLruCache();
+    } catch ( std::exception& ex ) {
+        failures++;
+        std::cerr << "Varatlan kivetel: " << ex.what() << std::endl;
+    }
+
+    if ( failures != 0 )
+    {
+        std::cerr << failures << " hibas ellenorzes" << std::endl;
+        return 1;
+    }
     std::cout << "Siker" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -6,9 +6,14 @@
  * Ez a fájl tartalmazza a működéshez szükséges Result, és LinkedList osztályokat
  */
 
+#include <algorithm>
 #include <cstddef>
+#include <utility>
 #include "memtrace.h"
 #include "string5.h"
+#include "stats.h"
+#include "memusage.h"
+#include "render.h"
 
 
 namespace Components
@@ -59,17 +64,30 @@ namespace Components
         {
         public:
             T item;     /// Adat
+            Node* prev; /// Előző elemre mutató pointer
             Node* next; /// Következő elemre mutató pointer
 
-            /// Dafault konstruktor
-            /// Inicializáljuk a következő elemre mutató pointert null-lal
-            Node() :next( nullptr ) {};
+            /// Konstruktor
+            /// Az adatot helyben hozza létre a kapott paraméterekből,
+            /// a szomszédos elemekre mutató pointereket null-lal inicializálja
+            /// @param args - az adat konstruktorának paraméterei
+            template<class... Args>
+            explicit Node( Args&&... args ) :item( std::forward<Args>( args )... ), prev( nullptr ), next( nullptr ) {};
         };
 
     private:
         Node* start;    /// A legelső elemre mutató pointer (strázsa)
         Node* back;     /// A legutolsó elemre mutató pointer (strázsa)
         size_t siz;     /// A lista hossza
+        unsigned long long edits;   /// Változatszámláló: minden módosítás növeli (lásd version())
+
+        /// Kifűzi és felszabadítja a megadott elemet - O(1)
+        /// @param node - törlendő elem
+        void unlink( Node* node );
+
+        /// A lista végére fűzi a megadott (már lefoglalt) elemet - O(1)
+        /// @param node - új elem
+        void link( Node* node );
 
         /// Indexelő operátor
         /// Biztonság kedvéért privát, hogy ne legyen összekeverhető egy tömbbel
@@ -80,7 +98,32 @@ namespace Components
     public:
         /// Default konstruktor
         /// Inicializáljuk a kezdő,vég strázsát, és a lista hosszát
-        LinkedList() : start(nullptr), back(nullptr), siz(0) {};
+        LinkedList() : start(nullptr), back(nullptr), siz(0), edits(0) {};
+
+        /// Másoló konstruktor
+        /// Az elemeket egyenként lemásolja (mély másolat)
+        /// @param other - másolandó lista
+        LinkedList( const LinkedList& other );
+
+        /// Mozgató konstruktor
+        /// Átveszi a másik lista elemeit, a másik lista üres lesz - O(1)
+        /// @param other - lista, aminek az elemeit átvesszük
+        LinkedList( LinkedList&& other ) :start( other.start ), back( other.back ), siz( other.siz ), edits( other.edits )
+        {
+            other.start = nullptr;
+            other.back = nullptr;
+            other.siz = 0;
+            other.edits++;
+        };
+
+        /// Értékadó operátor (másoló és mozgató is)
+        /// @param other - jobboldali lista (érték szerint, így mozgatáskor nincs másolás)
+        /// @return LinkedList& - a baloldali lista referenciája
+        LinkedList& operator=( LinkedList other ) { swap( other ); return *this; }
+
+        /// Kicseréli a két lista tartalmát - O(1)
+        /// @param other - másik lista
+        void swap( LinkedList& other );
 
         /// Iterátor osztály elődeklarálása
         class Iterator;
@@ -93,6 +136,10 @@ namespace Components
         /// @return Iterátor az utolsó utáni elemre
         Iterator end() { return Iterator(); };
 
+        /// Iterátor, ami a lista legutolsó elemére mutat (pl. a push után a beszúrt elemre)
+        /// @return Iterátor az utolsó elemre, üres lista esetén end()
+        Iterator last() { return Iterator( back ); };
+
         /// Lista hosszának gettere
         /// @return int - a lista hossza
         int size() const { return siz; }
@@ -101,22 +148,54 @@ namespace Components
         /// @return bool - üres-e a lista
         bool empty() const { return siz == 0; }
 
+        /// A lista változatszáma
+        /// Minden beszúrás, törlés és csere növeli, így ha két lekérdezés között nem változott, a lista
+        /// tartalma sem változott (pl. a keresési eredmények gyorsítótárazhatóak)
+        /// Az elemek helyben (iterátoron keresztül) történő módosítása után a hívónak touch()-ot kell hívnia
+        /// @return unsigned long long - változatszám
+        unsigned long long version() const { return edits; }
+
+        /// Helyben módosított elem jelzése: növeli a változatszámot
+        void touch() { edits++; }
+
+        /// A lista memóriahasználata: a lista feje, az elemek Node-jai és az elemek saját területei
+        /// Az elemtípushoz kell egy memoryUsageOf( const T& ) függvény (lásd memusage.h)
+        /// @return MemoryUsage - kimutatás
+        MemoryUsage memoryUsage() const;
+
         /// Hozzáadja a paraméterben kapott elemet a listához
         /// @param data - az elem referenciája
         /// @return int - az elem indexe
         int push( const T& data );
 
+        /// Hozzáadja a paraméterben kapott elemet a listához, másolás helyett mozgatással
+        /// @param data - az elem (jobbérték)
+        /// @return int - az elem indexe
+        int push( T&& data );
+
+        /// Új elemet hoz létre a lista végén, közvetlenül a végleges helyén (nincs másolás)
+        /// @param args - az elem konstruktorának paraméterei
+        /// @return Iterator - iterátor az új elemre
+        template<class... Args>
+        Iterator emplace( Args&&... args );
+
         /// Kiveszi a listából a megadott elemet
         /// @param index - az elem indexe a listában
         void pop( int index );
 
+        /// Kiveszi a listából az iterátor által mutatott elemet - O(1)
+        /// Az iterátor (és az elemre mutató pointerek) ezután érvénytelenek
+        /// std::out_of_range hibát dob, ha az iterátor nem mutat elemre
+        /// @param it - a törlendő elemre mutató iterátor
+        void erase( Iterator it );
+
         /// Törli és felszabadítja az összes elemet a listából
         void clear();
 
         /// Megadja hogy a keresett elem szerepel-e a listában
         /// @param element - a keresett elem
-        bool contains( const T* element );
-        bool contains( T element );
+        bool contains( const T* element ) const;
+        bool contains( const T& element ) const;
 
         /// Visszaadja a keresett elemre mutató pointert
         /// Az indexelő operátort valósítja meg, egy listásabb formátumban
@@ -129,10 +208,16 @@ namespace Components
         /// -1-gyel tér vissza ha az elem nincs a listában
         /// @param item - A keresett elem
         /// @return int - a talált elem indexe
-        int indexOf( const T* item );
-        int indexOf( const T item );
+        int indexOf( const T* item ) const;
+        int indexOf( const T& item ) const;
+
+        /// Iterátor a megadott pozíción lévő elemre - O(offset)
+        /// @param offset - 0-tól számozott pozíció
+        /// @return Iterator - iterátor az elemre, ha offset >= size() akkor end()
+        Iterator at( size_t offset );
 
         /// Egy számozott listát ír ki a kapott kimenetre a tárolt elemekkel
+        /// A sorokat pufferbe formázza, és nagyobb blokkokban, soronkénti flush nélkül írja ki
         /// @param ostream - standard kimenet
         /// @param displayEmpty - kiírja-e a kimenetre ha a lista üres? default = false
         /// @param from - szám, ahonnan az indexelést kezdje. default = 1
@@ -149,11 +234,14 @@ namespace Components
             LinkedList<Result<T>* > ret = LinkedList<Result<T>* >();
 
             Iterator start = begin();
-            for(int i = 1; start != end(); start++, i++)
+            int i = 1;
+            for( ; start != end(); start++, i++)
             {
                 if ( func(*start) ) ret.push( new Result<T>( &*start, i ) );
             }
 
+            STATS_COUNT( NODES_VISITED, i - 1 );
+            STATS_COUNT( COMPARISONS, i - 1 );
             return ret;
         }
 
@@ -171,6 +259,12 @@ namespace Components
         private:
             Node* current; /// Az aktuális elemre mutató pointer
 
+            friend class LinkedList<T>;
+
+            /// Konstruktor, ami a megadott elemre mutató iterátort hozza létre
+            /// @param node - az elem
+            explicit Iterator( Node* node ) :current( node ) {};
+
         public:
             /// Konstruktor, ami inicializálja az utolsó utáni iterátort
             Iterator() :current( nullptr ) {};
@@ -219,28 +313,102 @@ namespace Components
         start = nullptr;
         back = nullptr;
         siz = 0;
+        edits++;
     }
 
     template<class T>
-    int LinkedList<T>::push(const T &data) {
-        Node* tmp = new Node();
-        tmp->item = data;
+    MemoryUsage LinkedList<T>::memoryUsage() const {
+        MemoryUsage usage;
+        usage.nodes = sizeof( LinkedList<T> );
+        for ( const Node* current = start; current != nullptr; current = current->next )
+        {
+            // Az elem a Node-ba ágyazva van, a saját méretét az elem kimutatása tartalmazza
+            usage += memoryUsageOf( current->item );
+            usage.nodes += sizeof( Node ) - sizeof( T );
+            usage.allocated( sizeof( Node ) );
+        }
+        return usage;
+    }
+
+    template<class T>
+    LinkedList<T>::LinkedList(const LinkedList &other) :start( nullptr ), back( nullptr ), siz( 0 ), edits( 0 ) {
+        for ( Node* current = other.start; current != nullptr; current = current->next )
+            link( new Node( current->item ) );
+    }
+
+    template<class T>
+    void LinkedList<T>::swap(LinkedList &other) {
+        Node* tmpStart = start;
+        Node* tmpBack = back;
+        size_t tmpSiz = siz;
 
+        start = other.start;
+        back = other.back;
+        siz = other.siz;
+
+        other.start = tmpStart;
+        other.back = tmpBack;
+        other.siz = tmpSiz;
+
+        // Mindkét lista olyan változatszámot kap, amit egyik sem látott még
+        edits = other.edits = std::max( edits, other.edits ) + 1;
+    }
+
+    template<class T>
+    void LinkedList<T>::link(Node *node) {
         siz++;
+        edits++;
 
         if ( start == nullptr )
         {
-            start = tmp;
-            back = tmp;
-            return siz - 1;
+            start = node;
+            back = node;
+            return;
         }
 
-        back->next = tmp;
-        back = back->next;
+        node->prev = back;
+        back->next = node;
+        back = node;
+    }
+
+    template<class T>
+    int LinkedList<T>::push(const T &data) {
+        link( new Node( data ) );
+        return siz - 1;
+    }
 
+    template<class T>
+    int LinkedList<T>::push(T &&data) {
+        link( new Node( std::move( data ) ) );
         return siz - 1;
     }
 
+    template<class T>
+    template<class... Args>
+    typename LinkedList<T>::Iterator LinkedList<T>::emplace(Args&&... args) {
+        link( new Node( std::forward<Args>( args )... ) );
+        return last();
+    }
+
+    template<class T>
+    void LinkedList<T>::unlink( Node* node ) {
+        if ( node->prev != nullptr ) node->prev->next = node->next;
+        else start = node->next;
+
+        if ( node->next != nullptr ) node->next->prev = node->prev;
+        else back = node->prev;
+
+        delete node;
+        siz--;
+        edits++;
+    }
+
+    template<class T>
+    void LinkedList<T>::erase( Iterator it ) {
+        if ( it.current == nullptr ) throw std::out_of_range("Bad iterator");
+        unlink( it.current );
+    }
+
     template<class T>
     T &LinkedList<T>::operator[](int index) {
         if ( index < 0 ) throw std::out_of_range("Bad indexing");
@@ -251,10 +419,11 @@ namespace Components
 
         while ( curr != end )
         {
-            if ( counter == index ) return *curr;
+            if ( counter == index ) { STATS_COUNT( NODES_VISITED, counter + 1 ); return *curr; }
             curr++; counter++;
         }
 
+        STATS_COUNT( NODES_VISITED, counter );
         throw std::out_of_range("Bad indexing");
     }
 
@@ -262,97 +431,132 @@ namespace Components
     void LinkedList<T>::pop(int index) {
         if ( index < 0 || index >= size() ) throw std::out_of_range("Bad indexing");
 
-        if ( index == 0 )
+        // A lista végéhez közelebbi elemeket hátulról keressük meg
+        Node* current;
+        int counter;
+        if ( index < size() / 2 )
         {
-            Node* tmp = start;
-            start = start->next;
-
-            delete tmp;
-            siz--;
-            return;
+            current = start;
+            for ( counter = 0; counter < index; counter++ ) current = current->next;
+            STATS_COUNT( NODES_VISITED, counter + 1 );
         }
-
-        Node* current = start->next;
-        Node* prev = start;
-        int counter = 1;
-
-        while ( current != nullptr )
+        else
         {
-            if ( counter == index )
-            {
-                if ( counter == size()-1 )
-                {
-                    prev->next = nullptr;
-                    back = prev;
-                    delete current;
-                }
-                else
-                {
-                    prev->next = current->next;
-                    delete current;
-                }
-                siz--;
-                return;
-            }
-
-            prev = current;
-            current = current->next;
-            counter++;
+            current = back;
+            for ( counter = size() - 1; counter > index; counter-- ) current = current->prev;
+            STATS_COUNT( NODES_VISITED, size() - counter );
         }
+
+        unlink( current );
     }
 
     template<class T>
-    bool LinkedList<T>::contains( const T* element ) {
+    bool LinkedList<T>::contains( const T* element ) const {
         return indexOf( element ) != -1;
     }
 
     template<class T>
-    bool LinkedList<T>::contains( T element ) {
+    bool LinkedList<T>::contains( const T& element ) const {
         return indexOf( element ) != -1;
     }
 
     template<class T>
-    int LinkedList<T>::indexOf( const T* element) {
-        for ( int i = 0; i < size(); i++ )
+    int LinkedList<T>::indexOf( const T* element) const {
+        return indexOf( *element );
+    }
+
+    template<class T>
+    int LinkedList<T>::indexOf( const T& element) const {
+        int i = 0;
+        for ( Node* current = start; current != nullptr; current = current->next, i++ )
         {
-            if ( *get(i) == *element )
+            if ( current->item == element )
             {
+                STATS_COUNT( NODES_VISITED, i + 1 );
+                STATS_COUNT( COMPARISONS, i + 1 );
                 return i;
             }
         }
 
+        STATS_COUNT( NODES_VISITED, size() );
+        STATS_COUNT( COMPARISONS, size() );
         return -1;
     }
 
     template<class T>
-    int LinkedList<T>::indexOf( const T element) {
-        for ( int i = 0; i < size(); i++ )
-        {
-            if ( *get(i) == element )
-            {
-                return i;
-            }
-        }
+    typename LinkedList<T>::Iterator LinkedList<T>::at(size_t offset) {
+        if ( offset >= siz ) return end();
 
-        return -1;
+        Node* current = start;
+        for ( size_t i = 0; i < offset; i++ ) current = current->next;
+        STATS_COUNT( NODES_VISITED, offset );
+        return Iterator( current );
     }
 
     template<class T>
     void LinkedList<T>::printOrderedList(std::ostream &ostream, bool displayEmpty, int from) {
+        PageBuffer page( ostream );
         LinkedList<T>::Iterator start = begin();
         for ( ; start != end(); start++ , from++ )
         {
-            ostream << from << ". ";
-            (*start).printDetails( ostream );
-            ostream << std::endl;
+            page.row() << from << ". ";
+            (*start).printDetails( page.row() );
+            page.endRow();
         }
 
         if ( displayEmpty && size() < 1 )
         {
-            ostream << "A lista ures." << std::endl;
+            page.row() << "A lista ures.";
+            page.endRow();
         }
     }
 
+    /**
+     * Pager osztály
+     * Lapozó kurzor egy listához: minden next() hívás a következő oldalt írja ki, egyetlen írással
+     * Csak az aktuális pozíciót tárolja, így a következő oldalhoz nem kell újra bejárni a lista elejét
+     * Az oldalak kiírása között a lista nem módosulhat
+     */
+    template<class T>
+    class Pager
+    {
+    private:
+        LinkedList<T>& list;                        /// Lapozott lista
+        typename LinkedList<T>::Iterator cursor;    /// A következő oldal első eleme
+        int number;                                 /// A következő elem sorszáma
+        size_t limit;                               /// Egy oldalon lévő elemek száma
+
+    public:
+        /// Konstruktor
+        /// @param l - lapozott lista
+        /// @param lim - egy oldalon lévő elemek száma
+        /// @param offset - az első kiírandó elem (0-tól számozott) pozíciója
+        Pager( LinkedList<T>& l, size_t lim, size_t offset = 0 )
+            :list( l ), cursor( l.at( offset ) ), number( (int)offset + 1 ), limit( lim ) {};
+
+        /// Van-e még kiírandó elem
+        bool hasNext() { return cursor != list.end(); }
+
+        /// A következő kiírandó elem sorszáma (1-től számozva)
+        int position() const { return number; }
+
+        /// Kiírja a következő oldalt
+        /// @param ostream - kimenet
+        /// @return size_t - kiírt elemek száma
+        size_t next( std::ostream& ostream )
+        {
+            PageBuffer page( ostream );
+            size_t printed = 0;
+            for ( ; printed < limit && cursor != list.end(); printed++, cursor++, number++ )
+            {
+                page.row() << number << ". ";
+                (*cursor).printDetails( page.row() );
+                page.endRow();
+            }
+            return printed;
+        }
+    };
+
     template<class T>
     LinkedList<T>::~LinkedList() {
         Node* current = start;
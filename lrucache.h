@@ -0,0 +1,143 @@
+#ifndef NHF4_LRUCACHE_H
+#define NHF4_LRUCACHE_H
+/**
+ * \file lrucache.h
+ *
+ * Ez a fájl tartalmazza a keresési eredmények gyorsítótárazásához szükséges LruCache osztályt
+ */
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include "memtrace.h"
+#include "stats.h"
+
+namespace Components
+{
+    /**
+     * LruCache osztály
+     * Kulcs -> érték gyorsítótár a forrás (pl. egy lista) egy változatához kötve. A bejegyzések a
+     * forrás változatszámával együtt érvényesek: ha a lekérdezés vagy a beszúrás újabb változatszámot
+     * kap, az összes korábbi bejegyzés elavult, és törlődik. A méretét a bejegyzések száma és az
+     * értékek összesített súlya (pl. a találatok száma) korlátozza; a korlát felett a legrégebben
+     * használt bejegyzés esik ki.
+     */
+    template<class K, class V, class Hash = std::hash<K> >
+    class LruCache
+    {
+    private:
+        /// Egy bejegyzés
+        struct Entry
+        {
+            K key;          /// Kulcs
+            V value;        /// Érték
+            size_t weight;  /// Súly (a korláthoz)
+
+            Entry( const K& k, const V& v, size_t w ) :key( k ), value( v ), weight( w ) {};
+        };
+
+        typedef typename std::list<Entry>::iterator Position;
+
+        std::list<Entry> entries;                       /// Bejegyzések, elöl a legutóbb használt
+        std::unordered_map<K, Position, Hash> index;    /// Kulcs -> bejegyzés
+        size_t maxEntries;                              /// Bejegyzések legnagyobb száma
+        size_t maxWeight;                               /// Összesített súly felső korlátja
+        size_t totalWeight;                             /// Összesített súly
+        unsigned long long current;                     /// A bejegyzések forrásának változatszáma
+
+        /// Ha a forrás változott, az összes bejegyzés elavult
+        /// @param version - a forrás aktuális változatszáma
+        void sync( unsigned long long version );
+
+        /// A legrégebben használt bejegyzések törlése, amíg a korlát felett vagyunk
+        void evict();
+
+    public:
+        /// Konstruktor
+        /// @param entriesLimit - bejegyzések legnagyobb száma
+        /// @param weightLimit - összesített súly felső korlátja
+        LruCache( size_t entriesLimit, size_t weightLimit )
+            :maxEntries( entriesLimit ), maxWeight( weightLimit ), totalWeight( 0 ), current( 0 ) {};
+
+        /// Érték keresése; találat esetén a bejegyzés a legutóbb használt lesz
+        /// @param key - kulcs
+        /// @param version - a forrás aktuális változatszáma
+        /// @return const V* - az érték, ha nincs (vagy elavult) akkor nullptr
+        const V* find( const K& key, unsigned long long version );
+
+        /// Érték felvétele (a meglévőt felülírja)
+        /// A korlátnál nagyobb súlyú értéket nem tárolja
+        /// @param key - kulcs
+        /// @param version - a forrás változatszáma, amiből az érték készült
+        /// @param value - érték
+        /// @param weight - súly
+        void insert( const K& key, unsigned long long version, const V& value, size_t weight );
+
+        /// Az összes bejegyzés törlése
+        void clear();
+
+        /// Bejegyzések száma
+        size_t size() const { return entries.size(); }
+
+        /// Összesített súly
+        size_t weight() const { return totalWeight; }
+    };
+
+    template<class K, class V, class Hash>
+    void LruCache<K, V, Hash>::sync( unsigned long long version ) {
+        if ( version == current ) return;
+        clear();
+        current = version;
+    }
+
+    template<class K, class V, class Hash>
+    void LruCache<K, V, Hash>::evict() {
+        while ( !entries.empty() && ( entries.size() > maxEntries || totalWeight > maxWeight ) )
+        {
+            totalWeight -= entries.back().weight;
+            index.erase( entries.back().key );
+            entries.pop_back();
+        }
+    }
+
+    template<class K, class V, class Hash>
+    const V* LruCache<K, V, Hash>::find( const K& key, unsigned long long version ) {
+        sync( version );
+
+        typename std::unordered_map<K, Position, Hash>::iterator it = index.find( key );
+        if ( it == index.end() ) { STATS_COUNT( CACHE_MISSES, 1 ); return nullptr; }
+
+        STATS_COUNT( CACHE_HITS, 1 );
+        entries.splice( entries.begin(), entries, it->second );
+        return &it->second->value;
+    }
+
+    template<class K, class V, class Hash>
+    void LruCache<K, V, Hash>::insert( const K& key, unsigned long long version, const V& value, size_t weight ) {
+        sync( version );
+        if ( weight > maxWeight ) return;
+
+        typename std::unordered_map<K, Position, Hash>::iterator it = index.find( key );
+        if ( it != index.end() )
+        {
+            totalWeight -= it->second->weight;
+            entries.erase( it->second );
+            index.erase( it );
+        }
+
+        entries.push_front( Entry( key, value, weight ) );
+        index[key] = entries.begin();
+        totalWeight += weight;
+        evict();
+    }
+
+    template<class K, class V, class Hash>
+    void LruCache<K, V, Hash>::clear() {
+        entries.clear();
+        index.clear();
+        totalWeight = 0;
+    }
+}
+
+#endif // NHF4_LRUCACHE_H
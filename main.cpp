@@ -1,5 +1,8 @@
 #include <iostream>
+#include <cstdlib>
 #include "controller.h"
+#include "daemon.h"
+#include "protocol.h"
 /**
  * \file main.cpp
  *
@@ -43,12 +46,39 @@ public:
 };
 
 
-int main()
+int main( int argc, char* argv[] )
 {
     cout << "NHF - Recepteskonyv" << endl;
 
+    // Lusta mód (--lazy): a receptek instrukcióit csak megtekintéskor / módosításkor töltjük be
+    // Daemon mód (--daemon [--socket utvonal]): menü helyett socketen szolgálja ki a klienseket
+    // Lemezes mód (--store fajl [--pool KB]): a receptkönyv egy lapokra osztott fájlban, B+fákban van
+    bool lazy = false;
+    bool daemon = false;
+    std::string socketPath = Protocol::DEFAULT_SOCKET;
+    std::string storePath;
+    size_t storeBudget = File::RecipeStore::DEFAULT_BUDGET;
+    for ( int i = 1; i < argc; i++ )
+    {
+        std::string arg = argv[i];
+        if ( arg == "--lazy" ) lazy = true;
+        else if ( arg == "--daemon" ) daemon = true;
+        else if ( arg == "--socket" && i + 1 < argc ) socketPath = argv[++i];
+        else if ( arg == "--store" && i + 1 < argc ) storePath = argv[++i];
+        else if ( arg == "--pool" && i + 1 < argc ) storeBudget = (size_t)std::strtoul( argv[++i], nullptr, 10 ) * 1024;
+        else cerr << "Ismeretlen kapcsolo: " << arg << endl;
+    }
+
+    if ( daemon && !storePath.empty() ) { cerr << "A daemon mod a lemezes receptkonyvvel nem hasznalhato!" << endl; return 1; }
+
     // Példányosítjuk a vezérlő osztályt
-    Controller controller = Controller();
+    Controller controller( lazy, storePath, storeBudget );
+
+    if ( daemon )
+    {
+        Daemon server( controller, socketPath );
+        return server.run();
+    }
 
     // Menüpontokat tároló tömb
     Menu menupontok[] = {
@@ -57,6 +87,7 @@ int main()
             Menu( 300, "Receptkonyv", nullptr ),
             Menu( 400, "Kereses", nullptr ),
             Menu( 200, "Kamra", nullptr ),
+            Menu( 500, "Rendszer", nullptr ),
             // Alapanyaglista menü
             Menu( 10, "Alapanyag - Listazas", &Controller::listIngredients ),
             Menu( 10, "Alapanyag - Uj elem", &Controller::addIngredient ),
@@ -67,8 +98,10 @@ int main()
             Menu( 20, "Kamra - Uj elem", &Controller::addPantry ),
             Menu( 20, "Kamra - Eltavolitas", &Controller::removePantry ),
             Menu( 20, "Kamra - Modositas", &Controller::modifyPantry ),
+            Menu( 20, "Kamra - Bevasarlolista", &Controller::shoppingList ),
             // Receptkönyv menü
             Menu( 30, "Receptkonyv - Listazas", &Controller::listRecipes ),
+            Menu( 30, "Receptkonyv - Abc sorrend", &Controller::listRecipesSorted ),
             Menu( 30, "Receptkonyv - Megtekint", &Controller::displayRecipe ),
             Menu( 30, "Receptkonyv - Uj elem", &Controller::addRecipe ),
             Menu( 30, "Receptkonyv - Eltavolitas", &Controller::removeRecipe ),
@@ -76,8 +109,17 @@ int main()
             // Keresés menü
             Menu( 40, "Kereses - Etel neve alapjan", &Controller::searchByRecipeName ),
             Menu( 40, "Kereses - Nincs otletem", &Controller::searchRandom ),
+            Menu( 40, "Kereses - Nev eleje alapjan", &Controller::searchByPrefix ),
+            Menu( 40, "Kereses - Hasonlo receptek", &Controller::searchSimilar ),
             Menu( 40, "Kereses - Ennek egy kis...", &Controller::searchByOneIngredient ),
             Menu( 40, "Kereses - El kell hasznalni", &Controller::serachByMoreIngredient ),
+            Menu( 40, "Kereses - Osszetett kereses", &Controller::searchCombined ),
+            // Rendszer menü
+            Menu( 50, "Rendszer - Statisztika", &Controller::printStats ),
+            Menu( 50, "Rendszer - Statisztika (JSON)", &Controller::printStatsJson ),
+            Menu( 50, "Rendszer - Elgepeles-turo kereses ki/be", &Controller::toggleFuzzySearch ),
+            Menu( 50, "Rendszer - Memoriahasznalat", &Controller::printMemory ),
+            Menu( 50, "Rendszer - Lapozas ki/be", &Controller::togglePaging ),
             // Végjel
             Menu()
     };
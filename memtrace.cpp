@@ -21,6 +21,11 @@ typo:       2019.
 #include <string.h>
 #include <time.h>
 #include <ctype.h>
+#if defined(__unix__) || defined(__APPLE__)
+	#include <pthread.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
 
 #ifdef MEMTRACE
 #define FROM_MEMTRACE_CPP
@@ -39,6 +44,21 @@ typo:       2019.
 #define P(pu)   ((char*)pu-CANARY_LEN)	// user pointerbol mem poi
 #define XSTR(s) STR(s)
 #define STR(s)  #s
+
+/* tobbszalu hasznalathoz: a regisztert zar vedi, a delete hivas helye szalankent tarolodik */
+#if defined(__unix__) || defined(__APPLE__)
+	static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+	#define LOCK_REGISTRY()   pthread_mutex_lock(&registry_lock)
+	#define UNLOCK_REGISTRY() pthread_mutex_unlock(&registry_lock)
+#else
+	#define LOCK_REGISTRY()
+	#define UNLOCK_REGISTRY()
+#endif
+#if defined(__cplusplus) && __cplusplus >= 201103L
+	#define THREAD_LOCAL thread_local
+#else
+	#define THREAD_LOCAL
+#endif
 /*******************************************************************/
 /* Segedfuggvenyek es egyebek */
 /*******************************************************************/
@@ -87,6 +107,93 @@ START_NAMESPACE
 		return p;
 	}
 
+#ifdef MEMTRACE_GUARD_PAGES
+	/* vedolapos blokk: [kanari][adat][kerekitesi res] kozvetlenul egy PROT_NONE lap elott */
+	/* a tulcimzes azonnal laphibat okoz, a felszabaditott blokk lapjai PROT_NONE-kent karantenba kerulnek */
+	static const size_t GUARD_ALIGN = 16;
+	static size_t page_size;
+
+	typedef struct {
+		char * base;
+		size_t len;
+	} quarantine_item;
+
+	static quarantine_item quarantine[MEMTRACE_QUARANTINE];
+	static unsigned int quarantine_next;
+
+	static BOOL guarded(size_t size) {
+		#if MEMTRACE_GUARD_PAGES > 0
+			return size >= (size_t)MEMTRACE_GUARD_PAGES ? TRUE : FALSE;
+		#else
+			(void)size;
+			return TRUE;
+		#endif
+	}
+
+	static size_t guard_rounded(size_t size) {
+		return (size + GUARD_ALIGN-1) & ~(GUARD_ALIGN-1);
+	}
+
+	/* a kanari es az adat lapjainak szama (a vedolap nelkul) */
+	static size_t guard_pages(size_t size) {
+		return (CANARY_LEN + guard_rounded(size) + page_size-1) / page_size;
+	}
+
+	static char * guard_base(void * p, size_t size) {
+		return (char*)p + CANARY_LEN + guard_rounded(size) - guard_pages(size)*page_size;
+	}
+
+	static void *guard_malloc(size_t size, unsigned char data) {
+		size_t pages = guard_pages(size);
+		char *base, *p;
+		base = (char *)mmap(NULL, (pages+1)*page_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+		if (base == (char *)MAP_FAILED) return NULL;
+		if (mprotect(base+pages*page_size, page_size, PROT_NONE) != 0) {
+			munmap(base, (pages+1)*page_size);
+			return NULL;
+		}
+		p = base + pages*page_size - guard_rounded(size) - CANARY_LEN;
+		memset(p, canary_byte1, CANARY_LEN);
+		/* az adatot nem toltjuk fel (data): az uj lapok nullak, es csak hasznalatkor kerulnek a memoriaba */
+		(void)data;
+		memset(p+CANARY_LEN+size, canary_byte2, guard_rounded(size)-size);
+		return p;
+	}
+
+	/* regisztralatlan blokk azonnali felszabaditasa */
+	static void guard_discard(void *p, size_t size) {
+		munmap(guard_base(p, size), (guard_pages(size)+1)*page_size);
+	}
+
+	/* felszabaditott blokk karantenba: a lapjai elerhetetlenek, a legregebbi karantenos blokk felszabadul */
+	/* a koltsege nem fugg a blokk meretetol (nincs tartalomirtas) - a regiszter zarja alatt hivando */
+	static void guard_quarantine(void *p, size_t size) {
+		quarantine_item * q = &quarantine[quarantine_next];
+		char * base = guard_base(p, size);
+		size_t pages = guard_pages(size);
+		mprotect(base, pages*page_size, PROT_NONE);
+		if (q->base) munmap(q->base, q->len);
+		q->base = base;
+		q->len = (pages+1)*page_size;
+		quarantine_next = (quarantine_next+1) % MEMTRACE_QUARANTINE;
+	}
+#endif/*MEMTRACE_GUARD_PAGES*/
+
+	static void *block_malloc(size_t size, unsigned char data) {
+		#ifdef MEMTRACE_GUARD_PAGES
+			if (guarded(size)) return guard_malloc(size, data);
+		#endif
+		return canary_malloc(size, data);
+	}
+
+	static void block_discard(void *p, size_t size) {
+		#ifdef MEMTRACE_GUARD_PAGES
+			if (guarded(size)) { guard_discard(p, size); return; }
+		#endif
+		(void)size;
+		free(p);
+	}
+
 	static int chk_canary(void *p, size_t size) {
 		unsigned char *pc = (unsigned char*)p;
 		unsigned int i;
@@ -94,6 +201,15 @@ START_NAMESPACE
 			if (pc[i] != canary_byte1)
 				return -1;
 		pc += CANARY_LEN+size;
+		#ifdef MEMTRACE_GUARD_PAGES
+			/* a blokk utan csak a kerekitesi res van, utana a vedolap */
+			if (guarded(size)) {
+				for (i = 0; i < guard_rounded(size)-size; i++)
+					if (pc[i] != canary_byte2)
+						return 1;
+				return 0;
+			}
+		#endif
 		for (i = 0; i < CANARY_LEN; i++)
 			if (pc[i] != canary_byte2)
 				return 1;
@@ -173,6 +289,11 @@ START_NAMESPACE
 		}
 		if (a) print_call("\tFoglalas:\t", *a);
 		if (d) print_call("\tFelszabaditas:\t", *d);
+		#ifdef MEMTRACE_GUARD_PAGES
+			/* a vedolapos blokk utan nincs kanari: csak az adat */
+			if (p && guarded(size)) dump_memory(PU(p), size, 0, fperror);
+			else
+		#endif
                 if (p) dump_memory(p, size, CANARY_LEN, fperror);
 
 		dying = TRUE;
@@ -197,11 +318,108 @@ START_NAMESPACE
 
 	static registry_item registry; /*sentinel*/
 
-	static void print_registry_item(registry_item * p) {
-		if (p) {
-			print_registry_item(p->next);
-			fprintf(fperror, "\t%p%5d byte ",p->p, (int)p->size);
-			print_call(NULL, p->call);
+	/* szivargasok hivasi helyenkent (fuggveny, fajl, sor) osszesitve */
+	#define LEAK_EXAMPLES 3
+	typedef struct {
+		registry_item * first;	/* a hely egy blokkja: a kiirt hivas */
+		long count;
+		size_t bytes;
+		void * example[LEAK_EXAMPLES];
+	} leak_site;
+
+	static unsigned long site_hash(const call_t * c) {
+		unsigned long h = 2166136261UL;
+		const char * s;
+		if (c->file)
+			for (s = c->file; *s; s++) h = (h ^ (unsigned char)*s) * 16777619UL;
+		h = (h ^ (unsigned long)c->line) * 16777619UL;
+		return (h ^ (unsigned long)c->f) * 16777619UL;
+	}
+
+	static BOOL same_site(const call_t * a, const call_t * b) {
+		if (a->f != b->f || a->line != b->line) return FALSE;
+		if (a->file == NULL || b->file == NULL) return a->file == b->file ? TRUE : FALSE;
+		return strcmp(a->file, b->file) == 0 ? TRUE : FALSE;
+	}
+
+	/* a hely resze a nyilt cimzesu tablaban (cap ketto hatvany), ha uj, letrehozza */
+	static leak_site * find_site(leak_site * table, size_t cap, registry_item * p, size_t * used) {
+		size_t i = site_hash(&p->call) & (cap-1);
+		while (table[i].first && !same_site(&table[i].first->call, &p->call))
+			i = (i+1) & (cap-1);
+		if (table[i].first == NULL) {
+			table[i].first = p;
+			(*used)++;
+		}
+		return &table[i];
+	}
+
+	static int cmp_site(const void * a, const void * b) {
+		const leak_site * x = (const leak_site *)a;
+		const leak_site * y = (const leak_site *)b;
+		if (x->bytes != y->bytes) return x->bytes < y->bytes ? 1 : -1;
+		if (x->count != y->count) return x->count < y->count ? 1 : -1;
+		return 0;
+	}
+
+	/* osszesito jelentes a szivargo blokkokrol, majd a regiszter felszabaditasa (iterativan) */
+	static void print_registry(registry_item * list) {
+		registry_item * p, * next;
+		leak_site * table = NULL, * bigger;
+		size_t cap = 64, used = 0, i, j;
+		long blocks = 0;
+		size_t bytes = 0;
+
+		table = (leak_site*)calloc(cap, sizeof(leak_site));
+		for (p = list; p && table; p = p->next) {
+			leak_site * site;
+			if (2*(used+1) > cap) {
+				/* atmeretezes: a helyek ujrahashelese a duplaja meretu tablaba */
+				bigger = (leak_site*)calloc(2*cap, sizeof(leak_site));
+				if (bigger) {
+					size_t moved = 0;
+					for (i = 0; i < cap; i++)
+						if (table[i].first) *find_site(bigger, 2*cap, table[i].first, &moved) = table[i];
+					cap *= 2;
+				}
+				free(table);
+				table = bigger;
+				if (table == NULL) break;
+			}
+			site = find_site(table, cap, p, &used);
+			if (site->count < LEAK_EXAMPLES) site->example[site->count] = PU(p->p);
+			site->count++;
+			site->bytes += p->size;
+			blocks++;
+			bytes += p->size;
+		}
+
+		if (table) {
+			/* a foglalt helyek a tabla elejere, majd csokkeno meret szerint */
+			for (i = 0, j = 0; i < cap; i++)
+				if (table[i].first) table[j++] = table[i];
+			qsort(table, used, sizeof(leak_site), cmp_site);
+
+			fprintf(fperror, "\t%ld blokk, %lu byte, %lu helyen:\n", blocks, (unsigned long)bytes, (unsigned long)used);
+			for (i = 0; i < used; i++) {
+				fprintf(fperror, "\t%7ld blokk %10lu byte  ", table[i].count, (unsigned long)table[i].bytes);
+				print_call(NULL, table[i].first->call);
+				fprintf(fperror, "\t\tpl.:");
+				for (j = 0; j < LEAK_EXAMPLES && (long)j < table[i].count; j++)
+					fprintf(fperror, " %p", table[i].example[j]);
+				fprintf(fperror, "%s\n", table[i].count > LEAK_EXAMPLES ? " ..." : "");
+			}
+			free(table);
+		} else {
+			/* nincs memoria az osszesiteshez: blokkonkent */
+			for (p = list; p; p = p->next) {
+				fprintf(fperror, "\t%p%5d byte ", PU(p->p), (int)p->size);
+				print_call(NULL, p->call);
+			}
+		}
+
+		for (p = list; p; p = next) {
+			next = p->next;
 			if(p->call.par_txt) free(p->call.par_txt);
 			if(p->call.file) free(p->call.file);
 			free(p);
@@ -219,7 +437,12 @@ START_NAMESPACE
                 fperror = fopen(XSTR(MEMTRACE_ERRFILE), "w");
             #endif
 			fprintf(fperror, "Szivargas:\n");
-			print_registry_item(registry.next);
+			#if defined(MEMTRACE_SAMPLE_BYTES)
+				fprintf(fperror, "(mintavetelezes: atlagosan %ld bajtonkent egy foglalas kovetett)\n", (long)MEMTRACE_SAMPLE_BYTES);
+			#elif defined(MEMTRACE_SAMPLING)
+				fprintf(fperror, "(mintavetelezes: atlagosan minden %ld. foglalas kovetett)\n", (long)MEMTRACE_SAMPLE);
+			#endif
+			print_registry(registry.next);
 			registry.next = NULL;
 			return 1;           /* memória fogyás */
 		}
@@ -238,6 +461,86 @@ START_NAMESPACE
 END_NAMESPACE
 #endif
 
+/*******************************************************************/
+/* MEMTRACE_SAMPLING - mintavetelezes */
+/*******************************************************************/
+
+#ifdef MEMTRACE_SAMPLING
+#if defined(__GNUC__)
+	#define FILTER_LOAD(c)    __atomic_load_n(c, __ATOMIC_RELAXED)
+	#define FILTER_STORE(c,v) __atomic_store_n(c, v, __ATOMIC_RELAXED)
+#else
+	#define FILTER_LOAD(c)    (*(c))
+	#define FILTER_STORE(c,v) (*(c) = (v))
+#endif
+#define SAMPLE_FILTER_SIZE (1 << 16)
+
+START_NAMESPACE
+	#ifdef MEMTRACE_SAMPLE_BYTES
+		static const long sample_period = MEMTRACE_SAMPLE_BYTES;
+	#else
+		static const long sample_period = MEMTRACE_SAMPLE;
+	#endif
+
+	/* szalankent: a kovetkezo kovetett foglalasig hatralevo foglalasok (bajtok), 0: meg nincs beallitva */
+	static THREAD_LOCAL long sample_countdown;
+	static THREAD_LOCAL unsigned int sample_seed;
+
+	/* a kovetkezo kovetett foglalas tavolsaga: 1..2*periodus egyenletesen (atlagosan a periodus), */
+	/* hogy a mintavetel ne alljon ossze a program szabalyos foglalasi mintajaval */
+	static long next_sample_distance() {
+		if (sample_seed == 0) sample_seed = (unsigned int)(size_t)&sample_seed ^ (unsigned int)time(NULL) ^ 0x9e3779b9u;
+		sample_seed ^= sample_seed << 13;
+		sample_seed ^= sample_seed >> 17;
+		sample_seed ^= sample_seed << 5;
+		return 1 + (long)(sample_seed % (unsigned long)(2*sample_period));
+	}
+
+	/* kovetni kell-e a foglalast - zar nelkul, csak a szal sajat szamlaloja */
+	static BOOL sample(size_t size) {
+		if (sample_countdown == 0) sample_countdown = next_sample_distance();
+		#ifdef MEMTRACE_SAMPLE_BYTES
+			sample_countdown -= (long)size;
+		#else
+			(void)size;
+			sample_countdown--;
+		#endif
+		if (sample_countdown > 0) return FALSE;
+		sample_countdown = next_sample_distance();
+		return TRUE;
+	}
+
+	/* a kovetett blokkok (felhasznaloi cimuk szerinti) szamlalos szuroje: ha a rekesz 0, a blokk biztosan */
+	/* nem kovetett, igy felszabaditaskor a legtobb blokkhoz nem kell a regiszter zarja */
+	/* irni csak a regiszter zarjaval szabad, olvasni zar nelkul is */
+	static unsigned char sampled_filter[SAMPLE_FILTER_SIZE];
+
+	static unsigned int filter_slot(const void * pu) {
+		size_t a = (size_t)pu;
+		return (unsigned int)((a >> 4) ^ (a >> 20)) & (SAMPLE_FILTER_SIZE-1);
+	}
+
+	static void mark_sampled(const void * pu, int delta) {
+		unsigned char * c = &sampled_filter[filter_slot(pu)];
+		unsigned char v = FILTER_LOAD(c);
+		if (v == 255) return; /* telitett rekesz: onnantol mindig a regiszterben keresunk */
+		FILTER_STORE(c, (unsigned char)(v + delta));
+	}
+
+	static registry_item *find_registry_item(void * p);
+
+	/* kovetett (a regiszterben levo) blokk-e */
+	static BOOL sampled_block(void * pu) {
+		BOOL found;
+		if (FILTER_LOAD(&sampled_filter[filter_slot(pu)]) == 0) return FALSE;
+		LOCK_REGISTRY();
+		found = find_registry_item(P(pu))->next != NULL ? TRUE : FALSE;
+		UNLOCK_REGISTRY();
+		return found;
+	}
+END_NAMESPACE
+#endif/*MEMTRACE_SAMPLING*/
+
 /*******************************************************************/
 /* register/unregister */
 /*******************************************************************/
@@ -249,6 +552,7 @@ START_NAMESPACE
 
 	static BOOL register_memory(void * p, size_t size, call_t call) {
 		initialize();
+		LOCK_REGISTRY();
 		allocated_blks++;
 		#ifdef MEMTRACE_TO_FILE
 			fprintf(trace_file, "%p\t%d\t%s%s", PU(p), (int)size, pretty[call.f], call.par_txt ? call.par_txt : "?");
@@ -259,7 +563,7 @@ START_NAMESPACE
 		#ifdef MEMTRACE_TO_MEMORY
 		{/*C-blokk*/
 			registry_item * n = (registry_item*)malloc(sizeof(registry_item));
-			if(n==NULL) return FALSE;
+			if(n==NULL) { UNLOCK_REGISTRY(); return FALSE; }
 			n->p = p;
 			n->size = size;
 			n->call = call;
@@ -267,7 +571,11 @@ START_NAMESPACE
 			registry.next = n;
 		}/*C-blokk*/
 		#endif
+		#ifdef MEMTRACE_SAMPLING
+			mark_sampled(PU(p), 1);
+		#endif
 
+		UNLOCK_REGISTRY();
 		return TRUE;
 	}
 
@@ -279,8 +587,11 @@ START_NAMESPACE
     	}
     	#endif
 
-	static void unregister_memory(void * p, call_t call) {
+	/* ha a blokkot a hivonak kell felszabaditania (free), akkor TRUE-val ter vissza */
+	static BOOL unregister_memory(void * p, call_t call) {
+		BOOL release = TRUE;
 		initialize();
+		LOCK_REGISTRY();
 		#ifdef MEMTRACE_TO_FILE
                         fprintf(trace_file, "%p\t%d\t%s%s", PU(p), -1, pretty[call.f], call.par_txt ? call.par_txt : "?");
                         if (call.f <= 3) fprintf(trace_file, ")");
@@ -294,29 +605,49 @@ START_NAMESPACE
                 allocated_blks--;
 				registry_item * r = n->next;
 				n->next = r->next;
+				#ifdef MEMTRACE_SAMPLING
+					mark_sampled(PU(r->p), -1);
+				#endif
 				if(COMP(r->call.f,call.f)) {
                     int chk = chk_canary(r->p, r->size);
-                    if (chk < 0)
+                    /* die() exit-tel ter vissza: a kilepeskori felszabaditasok ujra zarolnanak */
+                    if (chk < 0) {
+						UNLOCK_REGISTRY();
 						die("Blokk elott serult a memoria:", r->p,r->size,&r->call,&call);
-                    if (chk > 0)
+					}
+                    if (chk > 0) {
+						UNLOCK_REGISTRY();
                         die("Blokk utan serult a memoria", r->p,r->size,&r->call,&call);
+					}
 					/*rendben van minden*/
 					if(call.par_txt) free(call.par_txt);
 					if(r->call.par_txt) free(r->call.par_txt);
 					if(call.file) free(call.file);
 					if(r->call.file) free(r->call.file);
-					memset(PU(r->p), 'f', r->size);
-					PU(r->p)[r->size-1] = 0;
+					#ifdef MEMTRACE_GUARD_PAGES
+					if (guarded(r->size)) {
+						guard_quarantine(r->p, r->size);
+						release = FALSE;
+					} else
+					#endif
+					{
+						memset(PU(r->p), 'f', r->size);
+						PU(r->p)[r->size-1] = 0;
+					}
 					free(r);
 				} else {
 					/*hibas felszabaditas*/
+					UNLOCK_REGISTRY();
 					die("Hibas felszabaditas:",r->p,r->size,&r->call,&call);
 				}
 			} else {
+				UNLOCK_REGISTRY();
 				die("Nem letezo, vagy mar felszabaditott adat felszabaditasa:", p, 0,NULL,&call);
 			}
 		} /*C-blokk*/
 		#endif
+		UNLOCK_REGISTRY();
+		return release;
 	}
 END_NAMESPACE
 
@@ -329,10 +660,13 @@ START_NAMESPACE
 	void * traced_malloc(size_t size, const char * par_txt, int line, const char * file) {
 		void * p;
 		initialize();
-		p = canary_malloc(size, random_byte);
+		#ifdef MEMTRACE_SAMPLING
+			if (!sample(size)) return malloc(size);
+		#endif
+		p = block_malloc(size, random_byte);
 		if (p) {
 			if(!register_memory(p,size,pack(FMALLOC,par_txt,line,file))) {
-				free(p);
+				block_discard(p, size);
 				return NULL;
 			}
 		    return PU(p);
@@ -343,11 +677,14 @@ START_NAMESPACE
 	void * traced_calloc(size_t count, size_t size, const char * par_txt, int line, const char * file) {
 		void * p;
 		initialize();
+		#ifdef MEMTRACE_SAMPLING
+			if (!sample(count*size)) return calloc(count, size);
+		#endif
                 size *= count;
-                p = canary_malloc(size, 0);
+                p = block_malloc(size, 0);
 		if(p) {
 			if(!register_memory(p,size,pack(FCALLOC,par_txt,line,file))) {
-				free(p);
+				block_discard(p, size);
 				return NULL;
 			}
 		    return PU(p);
@@ -357,9 +694,12 @@ START_NAMESPACE
 
 	void traced_free(void * pu, const char * par_txt, int line, const char * file) {
 		initialize();
+		#ifdef MEMTRACE_SAMPLING
+			if (pu && !sampled_block(pu)) { free(pu); return; }
+		#endif
 		if(pu) {
-			unregister_memory(P(pu), pack(FFREE,par_txt,line,file));
-			free(P(pu));
+			if (unregister_memory(P(pu), pack(FFREE,par_txt,line,file)))
+				free(P(pu));
 		} else {
 			/*free(NULL) eset*/
 			#ifdef MEMTRACE_TO_FILE
@@ -382,11 +722,21 @@ START_NAMESPACE
         size_t oldsize = 0;
 		registry_item * n;
 		initialize();
+		#ifdef MEMTRACE_SAMPLING
+			/* a nem kovetett blokk nem kovetett marad */
+			if (old ? !sampled_block(old) : !sample(size)) return realloc(old, size);
+		#endif
 
 		#ifdef MEMTRACE_TO_MEMORY
-        		n = find_registry_item(P(old));
-        		if (n) oldsize = n->next->size;
-			p = canary_malloc(size, random_byte);
+			if (old) {
+				/* a regiszter bejarasa alatt mas szal nem modosithatja; ismeretlen blokknal
+				   oldsize 0 marad, es az unregister_memory jelzi a hibat */
+				LOCK_REGISTRY();
+				n = find_registry_item(P(old));
+				if (n->next) oldsize = n->next->size;
+				UNLOCK_REGISTRY();
+			}
+			p = block_malloc(size, random_byte);
         	#else
         		p = realloc(old, size);
         	#endif
@@ -395,14 +745,12 @@ START_NAMESPACE
 			register_memory(p,size,pack(FREALLOC, par_txt, line,file));
             		if (old) {
 				#ifdef MEMTRACE_TO_MEMORY
-					int cpsize = 2*CANARY_LEN;
-                			if (oldsize < size) cpsize += oldsize;
-                			else cpsize += size;
-                			memcpy(p, P(old), cpsize);
-				#endif
+					/*csak az adat: a kanarikat block_malloc mar beallitotta*/
+                			memcpy(PU(p), old, oldsize < size ? oldsize : size);
+		    			if (unregister_memory(P(old), pack(FREALLOC, par_txt, line, file)))
+                				free P(old);
+				#else
 		    			unregister_memory(P(old), pack(FREALLOC, par_txt, line, file));
-				#ifdef MEMTRACE_TO_MEMORY
-                			free P(old);
             			#endif
             		}
             		return PU(p);
@@ -427,22 +775,37 @@ START_NAMESPACE
 		_new_handler = h;
 	}
 
-	static call_t delete_call;
-	static BOOL delete_called;
+	/* a delete hivas helye: a szoveget csak akkor masoljuk (pack), ha a blokk kovetett */
+	static THREAD_LOCAL int delete_line;
+	static THREAD_LOCAL const char * delete_file;
+	static THREAD_LOCAL BOOL delete_called;
 
 	void set_delete_call(int line, const char * file) {
 		initialize();
-		delete_call=pack(0,"",line,file); /*func értéke lényegtelen, majd felülírjuk*/
+		delete_line = line;
+		delete_file = file;
 		delete_called = TRUE;
 	}
 
 	void * traced_new(size_t size, int line, const char * file, int func) {
 		initialize();
+		#ifdef MEMTRACE_SAMPLING
+			BOOL traced = sample(size);
+		#endif
 		for (;;) {
-			void * p = canary_malloc(size, random_byte);
-			if(p) {
-				register_memory(p,size,pack(func,"",line,file));
-				return PU(p);
+			#ifdef MEMTRACE_SAMPLING
+			if (!traced) {
+				/*nem kovetett foglalas: kozvetlenul a rendszertol*/
+				void * p = malloc(size ? size : 1);
+				if (p) return p;
+			} else
+			#endif
+			{
+				void * p = block_malloc(size, random_byte);
+				if(p) {
+					register_memory(p,size,pack(func,"",line,file));
+					return PU(p);
+				}
 			}
 
 			if (_new_handler == 0)
@@ -454,11 +817,14 @@ START_NAMESPACE
 
 	void traced_delete(void * pu, int func) {
 		initialize();
+		#ifdef MEMTRACE_SAMPLING
+			if (pu && !sampled_block(pu)) { free(pu); pu = NULL; }
+		#endif
 		if(pu) {
 			/*kiolvasom call-t, ha van*/
-			memtrace::call_t call = delete_called ? (delete_call.f=func, delete_call) : pack(func,NULL,0,NULL);
-			memtrace::unregister_memory(P(pu),call);
-			free(P(pu));
+			memtrace::call_t call = delete_called ? pack(func,"",delete_line,delete_file) : pack(func,NULL,0,NULL);
+			if (memtrace::unregister_memory(P(pu),call))
+				free(P(pu));
 		}
 		delete_called=FALSE;
  	}
@@ -510,6 +876,9 @@ START_NAMESPACE
 		if(first) {
             fperror = stderr;
             random_byte = (unsigned char)time(NULL);
+			#ifdef MEMTRACE_GUARD_PAGES
+				page_size = (size_t)sysconf(_SC_PAGESIZE);
+			#endif
 			first = FALSE;
 			dying = FALSE;
 			#ifdef MEMTRACE_TO_MEMORY
@@ -524,7 +893,6 @@ START_NAMESPACE
 			#ifdef MEMTRACE_CPP
 				_new_handler = NULL;
 				delete_called = FALSE;
-				delete_call = pack(0,NULL,0,NULL);
 			#endif
 		}
 	}
@@ -26,6 +26,23 @@ inclue-ok:  2017., 2018. 2019.
 /*ha definialva van, akkor a megallaskor automatikus riport keszul */
 #define MEMTRACE_AUTO
 
+/*ha definialva van, akkor csak minden N-edik foglalast koveti (mintavetelezes, pl. eles forditashoz) */
+/*a tobbi foglalas kozvetlenul a rendszerhez megy, a riport a kovetett foglalasokrol szol */
+/*#define MEMTRACE_SAMPLE 100*/
+
+/*ha definialva van, akkor atlagosan N bajtonkent egy foglalast kovet (a nagy blokkok nagyobb esellyel) */
+/*#define MEMTRACE_SAMPLE_BYTES 524288*/
+
+/*ha definialva van, akkor a legalabb N bajtos blokkok egy vedett (PROT_NONE) lap ele kerulnek (0: minden blokk) */
+/*a tulcimzes azonnal laphibat okoz, a felszabaditott blokk pedig elerhetetlen lapokkal karantenba kerul */
+/*blokkonkent legalabb ket lap es ket lekepezes: sok kis blokkhoz mintavetelezessel egyutt hasznald */
+/*#define MEMTRACE_GUARD_PAGES 4096*/
+
+/*a karantenban tartott felszabaditott vedolapos blokkok szama*/
+#ifndef MEMTRACE_QUARANTINE
+	#define MEMTRACE_QUARANTINE 1024
+#endif
+
 /*ha definialva van, akkor malloc()/calloc()/realloc()/free() kovetve lesz*/
 #define MEMTRACE_C
 
@@ -60,6 +77,14 @@ inclue-ok:  2017., 2018. 2019.
     #undef USE_ATEXIT_OBJECT
 #endif
 
+#if (defined(MEMTRACE_SAMPLE) || defined(MEMTRACE_SAMPLE_BYTES)) && defined(MEMTRACE_TO_MEMORY)
+	#define MEMTRACE_SAMPLING
+#endif
+
+#if defined(MEMTRACE_GUARD_PAGES) && (!defined(MEMTRACE_TO_MEMORY) || !(defined(__unix__) || defined(__APPLE__)))
+	#undef MEMTRACE_GUARD_PAGES
+#endif
+
 #ifdef __cplusplus
 	#define START_NAMESPACE namespace memtrace {
 	#define END_NAMESPACE } /*namespace*/
@@ -153,6 +178,15 @@ END_NAMESPACE
 	#include <map>
 	#include <algorithm>
 	#include <functional>
+	#include <atomic>
+	#include <chrono>
+	#include <utility>
+	#include <unordered_map>
+	#include <thread>
+	#include <mutex>
+	#include <condition_variable>
+	#include <memory>
+	#include <deque>
 #endif
 #ifdef MEMTRACE_CPP
 	namespace std {
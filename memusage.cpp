@@ -0,0 +1,62 @@
+/**
+ * \file memusage.cpp
+ *
+ * Ez a fájl tartalmazza a MemoryUsage osztály megvalósítását
+ */
+
+#include <iomanip>
+#include "memusage.h"
+#include "memtrace.h"
+
+size_t Components::MemoryUsage::slack( size_t requested ) {
+    size_t chunk = ( requested + sizeof( size_t ) + 15 ) & ~(size_t)15;
+    if ( chunk < 32 ) chunk = 32;
+    return chunk - requested;
+}
+
+void Components::MemoryUsage::allocated( size_t requested ) {
+    allocations++;
+    fragmentation += slack( requested );
+}
+
+Components::MemoryUsage& Components::MemoryUsage::operator+=( const MemoryUsage& other ) {
+    objects += other.objects;
+    allocations += other.allocations;
+    payload += other.payload;
+    overhead += other.overhead;
+    nodes += other.nodes;
+    fragmentation += other.fragmentation;
+    return *this;
+}
+
+void Components::MemoryUsage::printHeader( std::ostream& ostream ) {
+    ostream << std::left << std::setw( 14 ) << "Lista" << std::right
+            << std::setw( 10 ) << "elemek" << std::setw( 10 ) << "foglalas" << std::setw( 12 ) << "hasznos"
+            << std::setw( 12 ) << "szerkezet" << std::setw( 12 ) << "lancolas" << std::setw( 12 ) << "heap"
+            << std::setw( 12 ) << "osszesen" << std::setw( 8 ) << "arany" << '\n';
+}
+
+void Components::MemoryUsage::printRow( std::ostream& ostream, const char* name ) const {
+    std::ios_base::fmtflags flags = ostream.flags();
+    ostream << std::left << std::setw( 14 ) << name << std::right
+            << std::setw( 10 ) << objects << std::setw( 10 ) << allocations << std::setw( 12 ) << payload
+            << std::setw( 12 ) << overhead << std::setw( 12 ) << nodes << std::setw( 12 ) << fragmentation
+            << std::setw( 12 ) << total()
+            << std::fixed << std::setprecision( 1 ) << std::setw( 7 ) << ( total() ? 100.0 * payload / total() : 0.0 ) << "%\n";
+    ostream.flags( flags );
+}
+
+Components::MemoryUsage Components::memoryUsageOf( const String& s ) {
+    MemoryUsage usage;
+    usage.objects = 1;
+    usage.overhead = sizeof( String );
+
+    size_t capacity = s.capacity();
+    if ( capacity > 0 )
+    {
+        usage.payload += s.size();
+        usage.overhead += capacity - s.size();
+        usage.allocated( capacity );
+    }
+    return usage;
+}
@@ -0,0 +1,70 @@
+#ifndef NHF4_MEMUSAGE_H
+#define NHF4_MEMUSAGE_H
+/**
+ * \file memusage.h
+ *
+ * Ez a fájl tartalmazza az adatszerkezet memóriahasználatának kimutatásához szükséges MemoryUsage osztályt
+ */
+
+#include <cstddef>
+#include <iostream>
+#include "memtrace.h"
+#include "string5.h"
+
+namespace Components
+{
+    /**
+     * MemoryUsage osztály
+     * Egy objektum (és az általa birtokolt dinamikus területek) memóriahasználata bájtban, bontva:
+     *  - payload:       a hasznos adat (karakterek, mennyiségek)
+     *  - overhead:      az objektumok szerkezeti többlete (vptr, pointerek, hosszak, lezáró nullák, igazítás)
+     *  - nodes:         a láncolás többlete (a Node szomszéd-pointerei, a lista feje)
+     *  - fragmentation: a heap becsült többlete foglalásonként (fejléc és méretosztályra kerekítés)
+     * A konvenció: egy objektum kimutatása a saját (beágyazott) méretét is tartalmazza, így a tartalmazó
+     * objektum csak a tagjain felüli részt számolja.
+     */
+    struct MemoryUsage
+    {
+        size_t objects;         /// Objektumok (listaelemek, sztringek) száma
+        size_t allocations;     /// Dinamikus foglalások száma
+        size_t payload;         /// Hasznos adat
+        size_t overhead;        /// Szerkezeti többlet
+        size_t nodes;           /// Láncolási többlet
+        size_t fragmentation;   /// A heap becsült többlete
+
+        /// Default konstruktor - üres kimutatás
+        MemoryUsage() :objects( 0 ), allocations( 0 ), payload( 0 ), overhead( 0 ), nodes( 0 ), fragmentation( 0 ) {};
+
+        /// Összesen lefoglalt bájtok
+        size_t total() const { return payload + overhead + nodes + fragmentation; }
+
+        /// Egy dinamikus foglalás rögzítése: a kért méreten felüli heap többletet számolja el
+        /// @param requested - a kért méret bájtban
+        void allocated( size_t requested );
+
+        /// Két kimutatás összeadása
+        MemoryUsage& operator+=( const MemoryUsage& other );
+
+        /// A glibc malloc becsült többlete egy foglalásnál: 8 bájt fejléc, 16 bájtos kerekítés,
+        /// legalább 32 bájtos blokk (64 bites rendszeren; a memtrace saját többletét nem számolja)
+        /// @param requested - a kért méret bájtban
+        /// @return size_t - a ténylegesen elhasznált és a kért méret különbsége
+        static size_t slack( size_t requested );
+
+        /// Táblázat fejléce (printRow oszlopaihoz)
+        /// @param ostream - kimenet
+        static void printHeader( std::ostream& ostream );
+
+        /// Egy táblázatsor kiírása
+        /// @param ostream - kimenet
+        /// @param name - a sor neve
+        void printRow( std::ostream& ostream, const char* name ) const;
+    };
+
+    /// Egy sztring memóriahasználata (a String objektum és a karaktertömb)
+    /// @param s - sztring
+    /// @return MemoryUsage - kimutatás
+    MemoryUsage memoryUsageOf( const String& s );
+}
+
+#endif // NHF4_MEMUSAGE_H
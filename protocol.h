@@ -0,0 +1,110 @@
+#ifndef NHF4_PROTOCOL_H
+#define NHF4_PROTOCOL_H
+/**
+ * \file protocol.h
+ *
+ * Ez a fájl tartalmazza a daemon és a kliens közötti (Unix domain socket feletti) szöveges protokoll
+ * közös részeit
+ *
+ * Kérés: egyetlen sor, "PARANCS parameter" alakban.
+ * Válasz: "OK" vagy "ERR" sor, utána a törzs sorai, végül egy csak "." pontot tartalmazó sor.
+ * A ponttal kezdődő törzssorok elé még egy pont kerül (mint az SMTP-nél), a kliens ezt eltávolítja.
+ */
+
+#include <string>
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "memtrace.h"
+
+// macOS-en nincs MSG_NOSIGNAL, ott a SIGPIPE-ot figyelmen kívül hagyjuk
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace Protocol
+{
+    const char* const DEFAULT_SOCKET = "receptkonyv.sock";  /// Alapértelmezett socket (az adatfájlok mellett)
+    const char* const END = ".";                            /// A válasz végét jelző sor
+    const size_t MAX_LINE = 64 * 1024;                      /// A leghosszabb elfogadott sor
+
+    /**
+     * LineReader osztály
+     * Soronként olvas egy socketről (pufferelt, egy read() több sort is behozhat)
+     */
+    class LineReader
+    {
+    private:
+        int fd;                 /// Socket
+        std::string pending;    /// Beolvasott, de még fel nem dolgozott bájtok
+
+    public:
+        /// Konstruktor
+        /// @param f - socket
+        explicit LineReader( int f ) :fd( f ) {};
+
+        /// Következő sor (a sorvége jel nélkül)
+        /// @param line - ide kerül a sor
+        /// @return bool - hamis, ha a kapcsolat lezárult, hiba történt, vagy túl hosszú a sor
+        bool next( std::string& line )
+        {
+            size_t pos;
+            while ( ( pos = pending.find( '\n' ) ) == std::string::npos )
+            {
+                if ( pending.size() > MAX_LINE ) return false;
+
+                char chunk[4096];
+                ssize_t n = ::read( fd, chunk, sizeof( chunk ) );
+                if ( n < 0 && errno == EINTR ) continue;
+                if ( n <= 0 ) return false;
+                pending.append( chunk, (size_t)n );
+            }
+
+            line.assign( pending, 0, pos );
+            pending.erase( 0, pos + 1 );
+            if ( !line.empty() && line[line.size() - 1] == '\r' ) line.erase( line.size() - 1 );
+            return true;
+        }
+    };
+
+    /// A teljes puffer kiírása a socketre
+    /// @param fd - socket
+    /// @param data - kiírandó adat
+    /// @return bool - sikerült-e
+    inline bool writeAll( int fd, const std::string& data )
+    {
+        size_t sent = 0;
+        while ( sent < data.size() )
+        {
+            ssize_t n = ::send( fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL );
+            if ( n < 0 && errno == EINTR ) continue;
+            if ( n <= 0 ) return false;
+            sent += (size_t)n;
+        }
+        return true;
+    }
+
+    /// Válasz összeállítása: státusz sor, a törzs (pont-védelemmel), záró sor
+    /// @param ok - sikeres volt-e a kérés
+    /// @param body - törzs (soronként)
+    /// @return std::string - a küldendő válasz
+    inline std::string response( bool ok, const std::string& body )
+    {
+        std::string out = ok ? "OK\n" : "ERR\n";
+        size_t start = 0;
+        while ( start < body.size() )
+        {
+            size_t end = body.find( '\n', start );
+            if ( end == std::string::npos ) end = body.size();
+            if ( body[start] == '.' ) out += '.';
+            out.append( body, start, end - start );
+            out += '\n';
+            start = end + 1;
+        }
+        out += END;
+        out += '\n';
+        return out;
+    }
+}
+
+#endif // NHF4_PROTOCOL_H
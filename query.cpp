@@ -0,0 +1,209 @@
+/**
+ * \file query.cpp
+ *
+ * Ez a fájl tartalmazza az IngredientIndex, a PantryStock és a QueryPlanner osztály megvalósítását
+ */
+
+#include <algorithm>
+#include <cctype>
+#include "query.h"
+#include "memtrace.h"
+
+namespace
+{
+    /// Kisbetűs másolat
+    std::string lower( const char* text )
+    {
+        std::string result( text );
+        for ( size_t i = 0; i < result.size(); i++ ) result[i] = (char)std::tolower( (unsigned char)result[i] );
+        return result;
+    }
+
+    /// A maradék feltételek sorrendje: a kis költségű, sokat kiszűrő feltétel kerül előre
+    bool cheaper( const Components::QueryPlanner::Filter& a, const Components::QueryPlanner::Filter& b )
+    {
+        double ra = a.selectivity < 1.0 ? a.cost / ( 1.0 - a.selectivity ) : 1e300;
+        double rb = b.selectivity < 1.0 ? b.cost / ( 1.0 - b.selectivity ) : 1e300;
+        return ra < rb;
+    }
+
+    /// Arány százalékban (kiíráshoz)
+    int percent( double ratio ) { return (int)( ratio * 100 + 0.5 ); }
+}
+
+void Components::IngredientIndex::update( const Handle& id, const Recipe& recipe ) {
+    remove( id );
+
+    std::vector<std::string> recipeNames;
+    LinkedList<IngredientQ>::Iterator it( *recipe.getIngredients() );
+    for ( ; it != LinkedList<IngredientQ>::Iterator(); it++ )
+        recipeNames.push_back( it->getName().c_str() );
+    std::sort( recipeNames.begin(), recipeNames.end() );
+    recipeNames.erase( std::unique( recipeNames.begin(), recipeNames.end() ), recipeNames.end() );
+
+    for ( size_t i = 0; i < recipeNames.size(); i++ ) postings[recipeNames[i]].push_back( id );
+    names[id.key()].swap( recipeNames );
+}
+
+bool Components::IngredientIndex::remove( const Handle& id ) {
+    std::unordered_map<unsigned long long, std::vector<std::string> >::iterator entry = names.find( id.key() );
+    if ( entry == names.end() ) return false;
+
+    for ( size_t i = 0; i < entry->second.size(); i++ )
+    {
+        std::unordered_map<std::string, std::vector<Handle> >::iterator posting = postings.find( entry->second[i] );
+        if ( posting == postings.end() ) continue;
+
+        std::vector<Handle>& ids = posting->second;
+        std::vector<Handle>::iterator found = std::find( ids.begin(), ids.end(), id );
+        if ( found != ids.end() ) { *found = ids.back(); ids.pop_back(); }
+        if ( ids.empty() ) postings.erase( posting );
+    }
+
+    names.erase( entry );
+    return true;
+}
+
+const std::vector<Components::Handle>* Components::IngredientIndex::find( const std::string& name ) const {
+    std::unordered_map<std::string, std::vector<Handle> >::const_iterator it = postings.find( name );
+    return it != postings.end() ? &it->second : nullptr;
+}
+
+size_t Components::IngredientIndex::count( const std::string& name ) const {
+    const std::vector<Handle>* ids = find( name );
+    return ids != nullptr ? ids->size() : 0;
+}
+
+void Components::IngredientIndex::clear() {
+    postings.clear();
+    names.clear();
+}
+
+
+Components::PantryStock::PantryStock( const LinkedList<IngredientQ>& pantry ) {
+    items.reserve( pantry.size() );
+    LinkedList<IngredientQ>::Iterator it( pantry );
+    for ( ; it != LinkedList<IngredientQ>::Iterator(); it++ )
+    {
+        // A kamra listája név szerint egyedi; egy esetleges ismétlést kihagyunk, hogy az index = név azonosító maradjon
+        if ( items.getNames().find( it->getName() ) != NameTable::NONE ) continue;
+        items.add( *it );
+    }
+}
+
+bool Components::PantryStock::covers( const IngredientQ& ingredient ) const {
+    unsigned int name = items.getNames().find( ingredient.getName() );
+    if ( name == NameTable::NONE ) return false;
+
+    const IngredientRecord& item = items[name];
+    // A hibás (negatív) mennyiség 0-nak számít, mint a bevásárlólistában
+    return item.unit == items.getUnits().find( ingredient.getUnit() ) && item.quantity >= 0 && item.quantity >= (int)ingredient.getQuantity();
+}
+
+size_t Components::PantryStock::covered( const Recipe& recipe ) const {
+    size_t count = 0;
+    LinkedList<IngredientQ>::Iterator it( *recipe.getIngredients() );
+    for ( ; it != LinkedList<IngredientQ>::Iterator(); it++ )
+        if ( covers( *it ) ) count++;
+    return count;
+}
+
+
+const double Components::QueryPlanner::LEARNING_RATE = 0.3;
+
+Components::QueryPlanner::QueryPlanner() {
+    // Kezdeti becslések, amíg nincs mérés
+    observed[TITLE] = 0.1;
+    observed[INGREDIENT] = 0.1;
+    observed[PANTRY] = 0.2;
+    observed[STEPS] = 0.5;
+}
+
+Components::QueryPlanner::Plan Components::QueryPlanner::plan( const Query& query, size_t total, const IngredientIndex& index, bool lazySteps ) const {
+    Plan plan;
+    plan.total = total;
+    plan.candidates = total;
+
+    std::vector<Filter> filters;
+    if ( !query.title.empty() ) filters.push_back( Filter( TITLE, lower( query.title.c_str() ), observed[TITLE], 1.0 ) );
+
+    std::vector<std::string> names( query.ingredients );
+    std::sort( names.begin(), names.end() );
+    names.erase( std::unique( names.begin(), names.end() ), names.end() );
+    for ( size_t i = 0; i < names.size(); i++ )
+        filters.push_back( Filter( INGREDIENT, names[i], total ? (double)index.count( names[i] ) / total : 0.0, 1.0 ) );
+
+    if ( query.cookable ) filters.push_back( Filter( PANTRY, std::string(), observed[PANTRY], 2.0 ) );
+
+    if ( query.maxSteps >= 0 )
+    {
+        // Lusta betöltésnél a lépések számához a fájlból kell olvasni
+        filters.push_back( Filter( STEPS, std::string(), observed[STEPS], lazySteps ? 50.0 : 0.5 ) );
+        filters.back().limit = query.maxSteps;
+    }
+
+    // A jelölteket a legkevesebb receptet adó indexelt szűrő adja
+    int driver = -1;
+    for ( size_t i = 0; i < filters.size(); i++ )
+        if ( filters[i].kind == INGREDIENT && ( driver < 0 || filters[i].selectivity < filters[driver].selectivity ) ) driver = (int)i;
+
+    if ( driver >= 0 )
+    {
+        plan.indexed = true;
+        plan.driver = filters[driver].arg;
+        plan.candidates = index.count( plan.driver );
+        filters.erase( filters.begin() + driver );
+    }
+
+    std::stable_sort( filters.begin(), filters.end(), cheaper );
+    plan.residuals.swap( filters );
+    return plan;
+}
+
+void Components::QueryPlanner::Plan::print( std::ostream& ostream ) const {
+    ostream << "[Vegrehajtasi terv]" << '\n';
+    if ( indexed ) ostream << "Jeloltek: hozzavalo-index \"" << driver << "\" - " << candidates << " / " << total << " recept" << '\n';
+    else ostream << "Jeloltek: teljes lista - " << total << " recept" << '\n';
+
+    for ( size_t i = 0; i < residuals.size(); i++ )
+    {
+        const Filter& filter = residuals[i];
+        ostream << ( i + 1 ) << ". szures: ";
+        switch ( filter.kind )
+        {
+            case TITLE: ostream << "a cim tartalmazza \"" << filter.arg << "\""; break;
+            case INGREDIENT: ostream << "hozzavalo \"" << filter.arg << "\""; break;
+            case PANTRY: ostream << "elkeszitheto a kamrabol"; break;
+            case STEPS: ostream << "legfeljebb " << filter.limit << " lepes"; break;
+            default: break;
+        }
+        ostream << " (becsult arany: " << percent( filter.selectivity ) << "%)" << '\n';
+    }
+    ostream.flush();
+}
+
+bool Components::QueryPlanner::test( const Filter& filter, const Recipe& recipe, const PantryStock& stock ) {
+    switch ( filter.kind )
+    {
+        case TITLE:
+            return lower( recipe.getTitle().c_str() ).find( filter.arg ) != std::string::npos;
+
+        case INGREDIENT:
+            return recipe.getIngredients()->contains( IngredientQ( String( filter.arg.c_str() ), String(), 0 ) );
+
+        case PANTRY: {
+            LinkedList<IngredientQ>::Iterator it( *recipe.getIngredients() );
+            for ( ; it != LinkedList<IngredientQ>::Iterator(); it++ )
+                if ( !stock.covers( *it ) ) return false;
+            return true;
+        }
+
+        default:
+            return true;
+    }
+}
+
+void Components::QueryPlanner::observe( Kind kind, size_t checked, size_t passed ) {
+    if ( checked == 0 ) return;
+    observed[kind] = ( 1.0 - LEARNING_RATE ) * observed[kind] + LEARNING_RATE * passed / checked;
+}
@@ -0,0 +1,270 @@
+#ifndef NHF4_QUERY_H
+#define NHF4_QUERY_H
+/**
+ * \file query.h
+ *
+ * Ez a fájl tartalmazza az összetett (több feltételes) keresésekhez szükséges IngredientIndex,
+ * PantryStock, Query és QueryPlanner osztályokat
+ */
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "memtrace.h"
+#include "components.h"
+#include "compact.h"
+#include "stats.h"
+
+namespace Components
+{
+    /**
+     * IngredientIndex osztály
+     * Fordított index: alapanyag neve -> az alapanyagot tartalmazó receptek azonosítói
+     * Egy alapanyagot tartalmazó receptek száma így pontosan és O(1) időben ismert
+     */
+    class IngredientIndex
+    {
+    private:
+        /// Alapanyag neve -> receptek azonosítói
+        std::unordered_map<std::string, std::vector<Handle> > postings;
+
+        /// Azonosító kulcsa -> a recept indexelt alapanyagnevei (törléshez, frissítéshez)
+        std::unordered_map<unsigned long long, std::vector<std::string> > names;
+
+    public:
+        /// Indexben lévő receptek száma
+        size_t size() const { return names.size(); }
+
+        /// Recept felvétele vagy frissítése (pl. a hozzávalók módosítása után)
+        /// @param id - recept azonosítója
+        /// @param recipe - recept
+        void update( const Handle& id, const Recipe& recipe );
+
+        /// Recept törlése az indexből
+        /// @param id - recept azonosítója
+        /// @return bool - szerepelt-e
+        bool remove( const Handle& id );
+
+        /// Az alapanyagot tartalmazó receptek
+        /// @param name - alapanyag neve
+        /// @return const std::vector<Handle>* - azonosítók, nullptr ha egy recept sem tartalmazza
+        const std::vector<Handle>* find( const std::string& name ) const;
+
+        /// Az alapanyagot tartalmazó receptek száma
+        /// @param name - alapanyag neve
+        size_t count( const std::string& name ) const;
+
+        /// Minden elem törlése
+        void clear();
+    };
+
+    /**
+     * PantryStock osztály
+     * A kamra készlete tömör rekordokban (IngredientTable) a hozzávalók gyors ellenőrzéséhez. A kamrában minden
+     * alapanyag egyszer szerepel, így a rekord indexe a név azonosítója: egy hozzávaló ellenőrzése két
+     * foglalásmentes névtábla-keresés, kulcs építése és virtuális hívás nélkül.
+     */
+    class PantryStock
+    {
+    private:
+        IngredientTable items;  /// Alapanyagonként egy rekord (név, mértékegység, mennyiség)
+
+    public:
+        /// Default konstruktor - üres készlet
+        PantryStock() {};
+
+        /// Konstruktor - a kamra tartalmából
+        /// @param pantry - kamra
+        explicit PantryStock( const LinkedList<IngredientQ>& pantry );
+
+        /// Van-e a kamrában legalább a megadott mennyiség (azonos névvel és mértékegységgel)
+        /// @param ingredient - hozzávaló
+        bool covers( const IngredientQ& ingredient ) const;
+
+        /// A recept hozzávalói közül ennyi van meg a kamrában
+        /// @param recipe - recept
+        size_t covered( const Recipe& recipe ) const;
+
+        /// Üres-e a készlet
+        bool empty() const { return items.size() == 0; }
+    };
+
+    /**
+     * Query osztály
+     * Összetett keresés feltételei - a megadott feltételek mindegyikének teljesülnie kell
+     */
+    struct Query
+    {
+        std::string title;                      /// Szövegrészlet a címben (üres = nincs feltétel)
+        std::vector<std::string> ingredients;   /// A recept ezeket mind tartalmazza
+        bool cookable;                          /// Csak a kamrából elkészíthető receptek
+        int maxSteps;                           /// Legfeljebb ennyi lépés (negatív = nincs feltétel)
+
+        /// Default konstruktor - nincs feltétel
+        Query() :cookable( false ), maxSteps( -1 ) {};
+
+        /// Nincs-e egy feltétel sem
+        bool empty() const { return title.empty() && ingredients.empty() && !cookable && maxSteps < 0; }
+    };
+
+    /**
+     * QueryPlanner osztály
+     * Összetett keresések végrehajtási terve. Szűrőnként becsüli a feltételnek megfelelő receptek arányát
+     * (szelektivitás): az indexelt szűrőknél (alapanyag) pontosan, a többinél a korábbi végrehajtások
+     * során mért arányok mozgóátlagából. A jelölteket a legszelektívebb indexelt szűrő adja (ha nincs
+     * ilyen, a teljes lista), a többi szűrő maradék feltételként fut a jelölteken, olyan sorrendben,
+     * hogy a drága és kevéssé szűrő feltételek a végére kerüljenek (költség / (1 - szelektivitás)).
+     * Így egy összetett keresés a receptek töredékét vizsgálja meg.
+     */
+    class QueryPlanner
+    {
+    public:
+        /// Szűrők fajtái
+        enum Kind { TITLE, INGREDIENT, PANTRY, STEPS, KINDS };
+
+        /// Egy szűrő a tervben
+        struct Filter
+        {
+            Kind kind;              /// Fajta
+            std::string arg;        /// Paraméter (kisbetűs cím-részlet, illetve alapanyagnév)
+            int limit;              /// Lépések felső korlátja (STEPS)
+            double selectivity;     /// A feltételnek megfelelő receptek becsült aránya
+            double cost;            /// Egy recept vizsgálatának becsült relatív költsége
+
+            Filter( Kind k, const std::string& a, double s, double c ) :kind( k ), arg( a ), limit( 0 ), selectivity( s ), cost( c ) {};
+        };
+
+        /// Végrehajtási terv
+        struct Plan
+        {
+            bool indexed;                   /// Az indexből jönnek-e a jelöltek (különben a teljes lista)
+            std::string driver;             /// A jelölteket adó alapanyag (ha indexed)
+            size_t candidates;              /// A jelöltek (becsült) száma
+            size_t total;                   /// Az összes recept száma
+            std::vector<Filter> residuals;  /// Maradék feltételek végrehajtási sorrendben
+
+            Plan() :indexed( false ), candidates( 0 ), total( 0 ) {};
+
+            /// Kiírja a tervet
+            /// @param ostream - kimenet
+            void print( std::ostream& ostream ) const;
+        };
+
+        /// Egy végrehajtás eredménye
+        struct Outcome
+        {
+            std::vector<const Recipe*> matches;     /// Találatok
+            size_t examined;                        /// Megvizsgált jelöltek
+
+            Outcome() :examined( 0 ) {};
+        };
+
+    private:
+        double observed[KINDS];     /// A nem indexelt szűrők mért szelektivitása (mozgóátlag)
+
+        /// A mozgóátlagban az új mérés súlya
+        static const double LEARNING_RATE;
+
+        /// A recept megfelel-e a szűrőnek (a lépésszám kivételével)
+        /// @param filter - szűrő
+        /// @param recipe - recept
+        /// @param stock - a kamra készlete
+        static bool test( const Filter& filter, const Recipe& recipe, const PantryStock& stock );
+
+        /// Egy jelölt vizsgálata a maradék feltételekkel, az első nem teljesülőig
+        /// @param checked, passed - feltételenként a megvizsgált, illetve megfelelt receptek száma (növeli)
+        /// @return bool - minden feltételnek megfelel-e
+        template<class Steps>
+        static bool accept( const Plan& plan, const Recipe& recipe, const PantryStock& stock, Steps& steps,
+                            std::vector<size_t>& checked, std::vector<size_t>& passed );
+
+        /// Mért szelektivitás rögzítése
+        /// @param kind - szűrő fajtája
+        /// @param checked - megvizsgált receptek
+        /// @param passed - ezekből megfelelt
+        void observe( Kind kind, size_t checked, size_t passed );
+
+    public:
+        /// Default konstruktor - a kezdeti becslésekkel
+        QueryPlanner();
+
+        /// Végrehajtási terv készítése
+        /// @param query - feltételek
+        /// @param total - receptek száma
+        /// @param index - alapanyag-index
+        /// @param lazySteps - a lépésszámhoz fájlból kell-e olvasni (lusta betöltés - drága szűrő)
+        /// @return Plan - terv
+        Plan plan( const Query& query, size_t total, const IngredientIndex& index, bool lazySteps ) const;
+
+        /// A terv végrehajtása; a maradék feltételek mért szelektivitásával frissíti a becsléseket
+        /// @param plan - terv
+        /// @param recipes - a receptlista (ha nem indexelt a terv)
+        /// @param index - alapanyag-index
+        /// @param pantry - kamra
+        /// @param resolve - azonosító -> const Recipe* (nullptr, ha nincs ilyen)
+        /// @param steps - recept -> lépések száma (negatív, ha nem állapítható meg)
+        /// @return Outcome - találatok a jelöltek sorrendjében
+        template<class Resolve, class Steps>
+        Outcome execute( const Plan& plan, const LinkedList<Recipe>& recipes, const IngredientIndex& index,
+                        const LinkedList<IngredientQ>& pantry, Resolve resolve, Steps steps );
+    };
+
+    template<class Steps>
+    bool QueryPlanner::accept( const Plan& plan, const Recipe& recipe, const PantryStock& stock, Steps& steps,
+                               std::vector<size_t>& checked, std::vector<size_t>& passed ) {
+        for ( size_t i = 0; i < plan.residuals.size(); i++ )
+        {
+            const Filter& filter = plan.residuals[i];
+            checked[i]++;
+            if ( filter.kind == STEPS )
+            {
+                int count = steps( recipe );
+                if ( count < 0 || count > filter.limit ) return false;
+            }
+            else if ( !test( filter, recipe, stock ) ) return false;
+            passed[i]++;
+        }
+        return true;
+    }
+
+    template<class Resolve, class Steps>
+    QueryPlanner::Outcome QueryPlanner::execute( const Plan& plan, const LinkedList<Recipe>& recipes, const IngredientIndex& index,
+                                                const LinkedList<IngredientQ>& pantry, Resolve resolve, Steps steps ) {
+        Outcome result;
+        std::vector<size_t> checked( plan.residuals.size(), 0 ), passed( plan.residuals.size(), 0 );
+
+        PantryStock stock;
+        for ( size_t i = 0; i < plan.residuals.size(); i++ )
+            if ( plan.residuals[i].kind == PANTRY ) stock = PantryStock( pantry );
+
+        if ( plan.indexed )
+        {
+            const std::vector<Handle>* ids = index.find( plan.driver );
+            for ( size_t i = 0; ids != nullptr && i < ids->size(); i++ )
+            {
+                const Recipe* recipe = resolve( (*ids)[i] );
+                if ( recipe == nullptr ) continue;
+                result.examined++;
+                if ( accept( plan, *recipe, stock, steps, checked, passed ) ) result.matches.push_back( recipe );
+            }
+        }
+        else
+        {
+            typename LinkedList<Recipe>::Iterator it( recipes );
+            for ( ; it != typename LinkedList<Recipe>::Iterator(); it++ )
+            {
+                result.examined++;
+                if ( accept( plan, *it, stock, steps, checked, passed ) ) result.matches.push_back( &*it );
+            }
+        }
+
+        for ( size_t i = 0; i < plan.residuals.size(); i++ )
+            observe( plan.residuals[i].kind, checked[i], passed[i] );
+
+        STATS_COUNT( NODES_VISITED, result.examined );
+        return result;
+    }
+}
+
+#endif // NHF4_QUERY_H
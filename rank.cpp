@@ -0,0 +1,86 @@
+/**
+ * \file rank.cpp
+ *
+ * Ez a fájl tartalmazza a Relevance osztály megvalósítását
+ */
+
+#include <cctype>
+#include "rank.h"
+#include "memtrace.h"
+
+namespace
+{
+    /// Kisbetűs másolat
+    std::string lower( const char* text )
+    {
+        std::string result( text );
+        for ( size_t i = 0; i < result.size(); i++ ) result[i] = (char)std::tolower( (unsigned char)result[i] );
+        return result;
+    }
+
+    /// A (kisbetűs) részlet első előfordulása a szövegben, kis- és nagybetűt nem megkülönböztetve
+    /// Másolat nélkül - a pontozás minden találatra lefut
+    /// @param text - szöveg
+    /// @param length - a szöveg hossza
+    /// @param part - kisbetűs részlet
+    /// @return size_t - az előfordulás helye, ha nincs std::string::npos
+    size_t findLower( const char* text, size_t length, const std::string& part )
+    {
+        if ( part.size() > length ) return std::string::npos;
+        for ( size_t i = 0; i + part.size() <= length; i++ )
+        {
+            size_t j = 0;
+            while ( j < part.size() && (char)std::tolower( (unsigned char)text[i + j] ) == part[j] ) j++;
+            if ( j == part.size() ) return i;
+        }
+        return std::string::npos;
+    }
+}
+
+const double Components::Relevance::TITLE_WEIGHT = 0.4;
+const double Components::Relevance::INGREDIENT_WEIGHT = 0.35;
+const double Components::Relevance::PANTRY_WEIGHT = 0.25;
+
+Components::Relevance::Relevance( const std::string& query, const std::vector<std::string>& names, const LinkedList<IngredientQ>& pantryList )
+    :title( lower( query.c_str() ) ), ingredients( names ), stock( pantryList ), pantry( !pantryList.empty() ) {
+    std::sort( ingredients.begin(), ingredients.end() );
+    ingredients.erase( std::unique( ingredients.begin(), ingredients.end() ), ingredients.end() );
+}
+
+double Components::Relevance::titleScore( const Recipe& recipe ) const {
+    const String& text = recipe.getTitle();
+    size_t position = findLower( text.c_str(), text.size(), title );
+    if ( text.size() == 0 || position == std::string::npos ) return 0.0;
+
+    // Előrébb álló találat és rövidebb (a részlethez közelebbi) cím a jobb
+    double place = 1.0 - (double)position / text.size();
+    double share = (double)title.size() / text.size();
+    return 0.6 * place + 0.4 * share;
+}
+
+double Components::Relevance::ingredientScore( const Recipe& recipe ) const {
+    const LinkedList<IngredientQ>& list = *recipe.getIngredients();
+    if ( ingredients.empty() || list.empty() ) return 0.0;
+
+    // A keresett nevek rendezettek: hozzávalónként bináris keresés, másolat nélkül
+    size_t matched = 0;
+    LinkedList<IngredientQ>::Iterator it( list );
+    for ( ; it != LinkedList<IngredientQ>::Iterator(); it++ )
+        if ( std::binary_search( ingredients.begin(), ingredients.end(), it->getName().c_str() ) ) matched++;
+    matched = std::min( matched, ingredients.size() );
+
+    return 0.75 * matched / ingredients.size() + 0.25 * std::min( 1.0, (double)matched / list.size() );
+}
+
+double Components::Relevance::pantryScore( const Recipe& recipe ) const {
+    size_t count = recipe.getIngredients()->size();
+    return count ? (double)stock.covered( recipe ) / count : 0.0;
+}
+
+double Components::Relevance::score( const Recipe& recipe ) const {
+    double sum = 0.0, weight = 0.0;
+    if ( !title.empty() ) { sum += TITLE_WEIGHT * titleScore( recipe ); weight += TITLE_WEIGHT; }
+    if ( !ingredients.empty() ) { sum += INGREDIENT_WEIGHT * ingredientScore( recipe ); weight += INGREDIENT_WEIGHT; }
+    if ( pantry ) { sum += PANTRY_WEIGHT * pantryScore( recipe ); weight += PANTRY_WEIGHT; }
+    return weight > 0.0 ? sum / weight : 0.0;
+}
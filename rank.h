@@ -0,0 +1,150 @@
+#ifndef NHF4_RANK_H
+#define NHF4_RANK_H
+/**
+ * \file rank.h
+ *
+ * Ez a fájl tartalmazza a keresési találatok rangsorolásához szükséges TopK és Relevance osztályokat
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "memtrace.h"
+#include "components.h"
+#include "query.h"
+
+namespace Components
+{
+    /**
+     * TopK osztály
+     * A beadott elemek közül a K legjobbat tartja meg egy korlátos kupacban: a kupac tetején a megtartottak
+     * közül a legrosszabb áll, így egy új elemről O(1) időben eldől, hogy bekerül-e, és a csere O(log K).
+     * n elem kiválasztása O(n log K) idő és O(K) memória - a többi elemet nem kell tárolni.
+     * @tparam T - elem
+     * @tparam Better - rendezés: Better()(a, b) igaz, ha a jobb b-nél (szigorú gyenge rendezés)
+     */
+    template<class T, class Better>
+    class TopK
+    {
+    private:
+        std::vector<T> heap;    /// A megtartott elemek, a tetején a legrosszabb
+        size_t limit;           /// K
+        Better better;          /// Rendezés
+
+    public:
+        /// Konstruktor
+        /// @param k - a megtartott elemek legnagyobb száma
+        /// @param order - rendezés
+        explicit TopK( size_t k, const Better& order = Better() ) :limit( k ), better( order ) { heap.reserve( k ); };
+
+        /// Elem felajánlása - bekerül, ha a K legjobb közé tartozik
+        /// @param item - elem
+        /// @return bool - bekerült-e
+        bool push( const T& item );
+
+        /// Megtartott elemek száma
+        size_t size() const { return heap.size(); }
+
+        /// A megtartott elemek a legjobbtól a legrosszabbig; utána a kiválasztó üres
+        /// @return std::vector<T> - elemek
+        std::vector<T> take();
+    };
+
+    template<class T, class Better>
+    bool TopK<T, Better>::push( const T& item ) {
+        if ( limit == 0 ) return false;
+        if ( heap.size() < limit )
+        {
+            heap.push_back( item );
+            std::push_heap( heap.begin(), heap.end(), better );
+            return true;
+        }
+
+        if ( !better( item, heap.front() ) ) return false;
+        std::pop_heap( heap.begin(), heap.end(), better );
+        heap.back() = item;
+        std::push_heap( heap.begin(), heap.end(), better );
+        return true;
+    }
+
+    template<class T, class Better>
+    std::vector<T> TopK<T, Better>::take() {
+        std::sort_heap( heap.begin(), heap.end(), better );
+        std::vector<T> result;
+        result.swap( heap );
+        return result;
+    }
+
+    /**
+     * Ranked osztály
+     * Egy rangsorolt találat: pontszám, a recept sorszáma a listában (egyenlő pontszámnál ez dönt) és azonosítója
+     */
+    struct Ranked
+    {
+        double score;   /// Relevancia
+        int order;      /// Sorszám a listában
+        Handle id;      /// Azonosító
+
+        Ranked() :score( 0.0 ), order( 0 ) {};
+        Ranked( double s, int o, const Handle& h ) :score( s ), order( o ), id( h ) {};
+    };
+
+    /// Rendezés relevancia szerint: a nagyobb pontszám, egyenlőségnél a kisebb sorszám a jobb
+    struct more_relevant
+    {
+        bool operator()( const Ranked& a, const Ranked& b ) const
+        {
+            return a.score != b.score ? a.score > b.score : a.order < b.order;
+        }
+    };
+
+    /**
+     * Relevance osztály
+     * Egy recept relevanciája egy keresésre, 0 és 1 között. A pontszám a keresésben szereplő szempontok
+     * súlyozott átlaga:
+     *  - cím:        a keresett részlet helye (a cím elején a legjobb) és a cím hányad része
+     *  - hozzávalók: a keresett alapanyagok közül hány szerepel a receptben (és a recept hozzávalóinak
+     *                hányad részét adják - a kevés egyéb hozzávalót igénylő recept előrébb kerül)
+     *  - kamra:      a recept hozzávalói közül mennyi van meg a kamrában
+     */
+    class Relevance
+    {
+    private:
+        std::string title;                      /// Keresett részlet a címben (kisbetűs, üres = nincs)
+        std::vector<std::string> ingredients;   /// Keresett alapanyagok (rendezett, egyedi)
+        PantryStock stock;                      /// A kamra készlete
+        bool pantry;                            /// Számít-e a kamra (nem üres)
+
+        /// A szempontok súlya
+        static const double TITLE_WEIGHT;
+        static const double INGREDIENT_WEIGHT;
+        static const double PANTRY_WEIGHT;
+
+    public:
+        /// Konstruktor
+        /// @param query - keresett részlet a címben (üres = nincs)
+        /// @param names - keresett alapanyagok (üres = nincs)
+        /// @param pantryList - kamra
+        Relevance( const std::string& query, const std::vector<std::string>& names, const LinkedList<IngredientQ>& pantryList );
+
+        /// A cím pontszáma: 0, ha nem tartalmazza a részletet
+        /// @param recipe - recept
+        double titleScore( const Recipe& recipe ) const;
+
+        /// A hozzávalók pontszáma
+        /// @param recipe - recept
+        double ingredientScore( const Recipe& recipe ) const;
+
+        /// A kamra pontszáma: a meglévő hozzávalók aránya
+        /// @param recipe - recept
+        double pantryScore( const Recipe& recipe ) const;
+
+        /// A recept relevanciája
+        /// @param recipe - recept
+        /// @return double - pontszám 0 és 1 között
+        double score( const Recipe& recipe ) const;
+    };
+}
+
+#endif // NHF4_RANK_H
@@ -0,0 +1,170 @@
+#ifndef NHF4_RCU_H
+#define NHF4_RCU_H
+/**
+ * \file rcu.h
+ *
+ * Ez a fájl tartalmazza a közzétett, változatlan objektumok zár nélküli olvasását megvalósító Rcu osztályt
+ */
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "memtrace.h"
+
+namespace Components
+{
+    /**
+     * Rcu osztály (read-copy-update)
+     * Egy T típusú objektum aktuális, közzétett változatát tárolja. A közzétett változat már nem módosul:
+     * az író lemásolja, a másolatot módosítja, majd a másolatot teszi közzé egyetlen atomi cserével.
+     * Az olvasók zár nélkül érik el az aktuális változatot: egy olvasó-rekeszbe beírják az általuk látott
+     * korszakot (epoch), és csak utána olvassák ki a mutatót. A lecserélt változatot az író a csere utáni
+     * korszakkal együtt félreteszi, és csak akkor szabadítja fel, ha már nincs olyan olvasó, amelyik
+     * korábbi korszakban kezdett (késleltetett felszabadítás). Így az olvasók soha nem várnak az íróra,
+     * és - mivel minden olvasó külön cache line-on lévő rekeszt használ - egymásra sem.
+     */
+    template<class T>
+    class Rcu
+    {
+    public:
+        enum { MAX_READERS = 128 };     /// Egyszerre aktív olvasók legnagyobb száma
+        enum { CACHE_LINE = 64 };       /// A rekeszek távolsága (false sharing elkerülése)
+
+    private:
+        /// Olvasó-rekesz: 0 = szabad, egyébként az olvasó kezdetekor látott korszak
+        struct Slot
+        {
+            std::atomic<unsigned long long> epoch;
+            char padding[CACHE_LINE - sizeof( std::atomic<unsigned long long> )];
+
+            Slot() :epoch( 0 ) {};
+        };
+
+        std::atomic<const T*> current;              /// Az aktuális változat
+        std::atomic<unsigned long long> epoch;      /// A globális korszak (1-től számozva)
+        mutable Slot slots[MAX_READERS];            /// Olvasó-rekeszek
+        std::mutex writer;                          /// A közzétételeket sorosítja
+
+        /// Lecserélt, még fel nem szabadított változatok (a csere utáni korszak, változat)
+        std::vector<std::pair<unsigned long long, const T*> > retired;
+
+        /// Másolás tiltása
+        Rcu( const Rcu& );
+        Rcu& operator=( const Rcu& );
+
+        /// Felszabadítja azokat a lecserélt változatokat, amelyeket már egy olvasó sem láthat
+        /// Csak az író hívhatja (writer zárolva)
+        void reclaim();
+
+    public:
+        /**
+         * Reader osztály
+         * Olvasási szakasz: élettartama alatt a megszerzett változat nem szabadul fel
+         * A szakaszok ne ágyazódjanak egymásba, és ne tartsanak sokáig, mert addig a lecserélt
+         * változatok nem szabadulnak fel
+         */
+        class Reader
+        {
+        private:
+            Slot* slot;         /// A lefoglalt olvasó-rekesz
+            const T* value;     /// A megszerzett változat
+
+            /// Másolás tiltása
+            Reader( const Reader& );
+            Reader& operator=( const Reader& );
+
+        public:
+            /// Konstruktor - lefoglal egy rekeszt, és megszerzi az aktuális változatot
+            /// @param rcu - a közzétett objektum
+            explicit Reader( const Rcu& rcu );
+
+            /// Destruktor - felszabadítja a rekeszt
+            ~Reader() { slot->epoch.store( 0 ); }
+
+            /// A megszerzett változat (nullptr, ha még nincs közzétett változat)
+            const T* get() const { return value; }
+
+            const T& operator*() const { return *value; }
+            const T* operator->() const { return value; }
+        };
+
+        /// Default konstruktor - nincs közzétett változat
+        Rcu() :current( nullptr ), epoch( 1 ) {};
+
+        /// Destruktor - a futó olvasási szakaszoknak már be kell fejeződniük
+        ~Rcu();
+
+        /// Új változat közzététele; a régit késleltetve szabadítja fel
+        /// @param next - az új változat (dinamikusan foglalt, az Rcu veszi át)
+        void publish( const T* next );
+
+        /// Az aktuális változat olvasási szakasz nélkül
+        /// Csak az író használhatja (a közzétevő), mert csak ő tudja, hogy közben nem szabadul fel
+        /// @return const T* - az aktuális változat, nullptr ha még nincs
+        const T* latest() const { return current.load(); }
+
+        /// Felszabadításra váró lecserélt változatok száma
+        size_t pending() const { return retired.size(); }
+    };
+
+    template<class T>
+    Rcu<T>::Reader::Reader( const Rcu& rcu ) :slot( nullptr ), value( nullptr ) {
+        // A szálhoz tartozó kezdőrekesz, így a párhuzamos olvasók ritkán ütköznek
+        size_t i = std::hash<std::thread::id>()( std::this_thread::get_id() ) % MAX_READERS;
+        for ( size_t tries = 1; ; tries++, i = ( i + 1 ) % MAX_READERS )
+        {
+            // Előbb a korszakot rögzítjük, csak utána olvassuk ki a mutatót: ha az író a rekeszt
+            // még szabadnak látta, akkor a csere már megtörtént, és mi is az új változatot kapjuk
+            unsigned long long free = 0;
+            if ( rcu.slots[i].epoch.compare_exchange_strong( free, rcu.epoch.load() ) )
+            {
+                slot = &rcu.slots[i];
+                break;
+            }
+            if ( tries % MAX_READERS == 0 ) std::this_thread::yield();
+        }
+        value = rcu.current.load();
+    }
+
+    template<class T>
+    Rcu<T>::~Rcu() {
+        delete current.load();
+        for ( size_t i = 0; i < retired.size(); i++ ) delete retired[i].second;
+    }
+
+    template<class T>
+    void Rcu<T>::publish( const T* next ) {
+        std::lock_guard<std::mutex> guard( writer );
+
+        const T* old = current.exchange( next );
+        unsigned long long now = epoch.fetch_add( 1 ) + 1;
+        if ( old != nullptr ) retired.push_back( std::make_pair( now, old ) );
+
+        reclaim();
+    }
+
+    template<class T>
+    void Rcu<T>::reclaim() {
+        // A legrégebbi még futó olvasási szakasz korszaka (0 = nincs olvasó)
+        unsigned long long oldest = 0;
+        for ( size_t i = 0; i < MAX_READERS; i++ )
+        {
+            unsigned long long seen = slots[i].epoch.load();
+            if ( seen != 0 && ( oldest == 0 || seen < oldest ) ) oldest = seen;
+        }
+
+        size_t kept = 0;
+        for ( size_t i = 0; i < retired.size(); i++ )
+        {
+            // Aki a csere utáni korszakban (vagy később) kezdett, már az újabb változatot látja
+            if ( oldest == 0 || oldest >= retired[i].first ) delete retired[i].second;
+            else retired[kept++] = retired[i];
+        }
+        retired.resize( kept );
+    }
+}
+
+#endif // NHF4_RCU_H
@@ -0,0 +1,186 @@
+/**
+ * \file recipestore.cpp
+ *
+ * Ez a fájl tartalmazza a RecipeStore osztály megvalósítását
+ *
+ * Rekordformátum (a számok 4 bájtosak): cím hossza, cím, hozzávalók száma, hozzávalónként
+ * (név hossza, név, mértékegység hossza, mértékegység, mennyiség), instrukciók száma, instrukciónként
+ * (hossza, szövege)
+ */
+
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include "recipestore.h"
+#include "memtrace.h"
+
+using Components::Handle;
+using Components::Recipe;
+using Components::IngredientQ;
+using Components::LinkedList;
+
+namespace
+{
+    void putNumber( std::string& out, unsigned int value )
+    {
+        char bytes[4];
+        std::memcpy( bytes, &value, sizeof( bytes ) );
+        out.append( bytes, sizeof( bytes ) );
+    }
+
+    void putText( std::string& out, const char* text, size_t length )
+    {
+        putNumber( out, (unsigned int)length );
+        out.append( text, length );
+    }
+
+    /// Olvasás a rekordból - sérült (rövid) rekordnál ifstream::failure
+    unsigned int getNumber( const std::string& in, size_t& pos )
+    {
+        if ( pos + 4 > in.size() ) throw std::ifstream::failure( "Serult recept rekord!" );
+        unsigned int value;
+        std::memcpy( &value, in.data() + pos, sizeof( value ) );
+        pos += 4;
+        return value;
+    }
+
+    String getText( const std::string& in, size_t& pos )
+    {
+        size_t length = getNumber( in, pos );
+        if ( pos + length > in.size() ) throw std::ifstream::failure( "Serult recept rekord!" );
+        String text( in.substr( pos, length ).c_str() );
+        pos += length;
+        return text;
+    }
+
+    /// Kisbetűs másolat
+    std::string lower( const char* text )
+    {
+        std::string result( text );
+        for ( size_t i = 0; i < result.size(); i++ ) result[i] = (char)std::tolower( (unsigned char)result[i] );
+        return result;
+    }
+}
+
+File::RecipeStore::RecipeStore( const String& path, size_t budget )
+    :pool( path, budget ), byId( pool, BY_ID ), byTitle( pool, BY_TITLE )
+{
+    // A jelző előtti fájlok: ha már kapott azonosítót recept, az áttöltés megtörtént
+    if ( !imported() && pool.counter( NEXT_ID ) != 0 ) markImported();
+}
+
+std::string File::RecipeStore::idKey( const Handle& id ) {
+    std::string key( 8, '\0' );
+    for ( int i = 0; i < 4; i++ )
+    {
+        key[i] = (char)( id.index >> ( 24 - 8 * i ) );
+        key[4 + i] = (char)( id.generation >> ( 24 - 8 * i ) );
+    }
+    return key;
+}
+
+std::string File::RecipeStore::titleKey( const String& title, const Handle& id ) {
+    std::string key = lower( title.c_str() );
+    if ( key.size() > BPlusTree::MAX_KEY - 9 ) key.resize( BPlusTree::MAX_KEY - 9 );
+    key.push_back( '\0' );
+    return key + idKey( id );
+}
+
+std::string File::RecipeStore::serialize( const Recipe& recipe ) {
+    std::string record;
+    putText( record, recipe.getTitle().c_str(), recipe.getTitle().size() );
+
+    putNumber( record, (unsigned int)recipe.getIngredients()->size() );
+    LinkedList<IngredientQ>::Iterator it( *recipe.getIngredients() );
+    for ( ; it != LinkedList<IngredientQ>::Iterator(); it++ )
+    {
+        putText( record, it->getName().c_str(), it->getName().size() );
+        putText( record, it->getUnit().c_str(), it->getUnit().size() );
+        putNumber( record, it->getQuantity() );
+    }
+
+    putNumber( record, (unsigned int)recipe.getInstructions()->size() );
+    LinkedList<String>::Iterator line( *recipe.getInstructions() );
+    for ( ; line != LinkedList<String>::Iterator(); line++ )
+        putText( record, line->c_str(), line->size() );
+    return record;
+}
+
+void File::RecipeStore::deserialize( const std::string& record, Recipe& recipe ) {
+    size_t pos = 0;
+    String title = getText( record, pos );
+
+    LinkedList<IngredientQ> ingredients;
+    for ( size_t count = getNumber( record, pos ); count > 0; count-- )
+    {
+        String name = getText( record, pos );
+        String unit = getText( record, pos );
+        ingredients.push( IngredientQ( name, unit, getNumber( record, pos ) ) );
+    }
+
+    LinkedList<String> instructions;
+    for ( size_t count = getNumber( record, pos ); count > 0; count-- )
+        instructions.push( getText( record, pos ) );
+
+    recipe = Recipe( std::move( title ), std::move( ingredients ), std::move( instructions ) );
+}
+
+Handle File::RecipeStore::TitleCursor::id() const {
+    const std::string& key = cursor.key();
+    Handle id( 0, 0 );
+    for ( size_t i = key.size() - 8; i < key.size() - 4; i++ ) id.index = ( id.index << 8 ) | (unsigned char)key[i];
+    for ( size_t i = key.size() - 4; i < key.size(); i++ ) id.generation = ( id.generation << 8 ) | (unsigned char)key[i];
+    return id;
+}
+
+Handle File::RecipeStore::insert( const Recipe& recipe ) {
+    Handle id( (unsigned int)pool.counter( NEXT_ID ), 0 );
+    pool.setCounter( NEXT_ID, id.index + 1ULL );
+
+    byId.insert( idKey( id ), serialize( recipe ) );
+    byTitle.insert( titleKey( recipe.getTitle(), id ), recipe.getTitle().c_str() );
+    return id;
+}
+
+bool File::RecipeStore::update( const Handle& id, const Recipe& recipe ) {
+    Recipe old;
+    if ( !find( id, old ) ) return false;
+
+    byTitle.erase( titleKey( old.getTitle(), id ) );
+    byTitle.insert( titleKey( recipe.getTitle(), id ), recipe.getTitle().c_str() );
+    byId.insert( idKey( id ), serialize( recipe ) );
+    return true;
+}
+
+bool File::RecipeStore::find( const Handle& id, Recipe& recipe ) {
+    std::string record;
+    if ( !byId.find( idKey( id ), record ) ) return false;
+
+    deserialize( record, recipe );
+    recipe.setId( id );
+    return true;
+}
+
+Handle File::RecipeStore::findTitle( const String& title ) {
+    std::string prefix = lower( title.c_str() );
+    if ( prefix.size() > BPlusTree::MAX_KEY - 9 ) prefix.resize( BPlusTree::MAX_KEY - 9 );
+    prefix.push_back( '\0' );
+
+    // Az azonos kisbetűs című receptek közül a pontosan egyező
+    for ( TitleCursor it = titles( prefix ); it.valid(); ++it )
+        if ( it.title() == title.c_str() ) return it.id();
+    return Handle();
+}
+
+bool File::RecipeStore::erase( const Handle& id ) {
+    Recipe recipe;
+    if ( !find( id, recipe ) ) return false;
+
+    byTitle.erase( titleKey( recipe.getTitle(), id ) );
+    byId.erase( idKey( id ) );
+    return true;
+}
+
+File::RecipeStore::TitleCursor File::RecipeStore::titles( const std::string& prefix ) {
+    return TitleCursor( byTitle.lowerBound( prefix ), prefix );
+}
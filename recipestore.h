@@ -0,0 +1,139 @@
+#ifndef NHF4_RECIPESTORE_H
+#define NHF4_RECIPESTORE_H
+/**
+ * \file recipestore.h
+ *
+ * Ez a fájl tartalmazza a lemezen tárolt receptkönyvhöz szükséges RecipeStore osztályt
+ */
+
+#include <string>
+#include "memtrace.h"
+#include "string5.h"
+#include "components.h"
+#include "bufferpool.h"
+#include "btree.h"
+
+namespace File
+{
+    /**
+     * RecipeStore osztály
+     * Lemezen tárolt receptkönyv a memóriánál nagyobb receptgyűjteményekhez. Egy lapokra osztott fájlban két
+     * B+fa van: az egyik az azonosító szerint a teljes receptet (cím, hozzávalók, kódolatlan instrukciók),
+     * a másik a kisbetűs cím és az azonosító szerint a címet tárolja - így a cím szerinti listázás, keresés
+     * és a név eleje alapján keresés csak a kis címindex lapjait olvassa. A memóriában a BufferPool keretében
+     * lévő lapok vannak; a módosítások a lapokon történnek, a fájl nem íródik újra.
+     * Az azonosítók (#index.0) sorban kerülnek kiosztásra, és törlés után sem használódnak fel újra.
+     */
+    class RecipeStore
+    {
+    public:
+        enum { DEFAULT_BUDGET = 4 << 20 };  /// Alapértelmezett lapkeret bájtban
+
+    private:
+        /// A fák és a számlálók helye a fájl fejlécében
+        enum { BY_ID = 0, BY_TITLE = 1, NEXT_ID = 2, IMPORTED = 3 };
+
+        BufferPool pool;    /// Lapok
+        BPlusTree byId;     /// Azonosító -> recept
+        BPlusTree byTitle;  /// Kisbetűs cím + '\0' + azonosító -> cím
+
+        /// Másolás tiltása
+        RecipeStore( const RecipeStore& );
+        RecipeStore& operator=( const RecipeStore& );
+
+        /// Az azonosító kulcsa: 8 bájt, nagy helyiértékkel kezdve (így sorrendtartó)
+        static std::string idKey( const Components::Handle& id );
+
+        /// A címindex kulcsa: a kisbetűs cím (legfeljebb a fa kulcshosszáig), '\0', azonosító
+        static std::string titleKey( const String& title, const Components::Handle& id );
+
+        /// Recept bájtsorozattá alakítása és vissza
+        /// ifstream::failure hibát dob, ha a rekord sérült
+        static std::string serialize( const Components::Recipe& recipe );
+        static void deserialize( const std::string& record, Components::Recipe& recipe );
+
+    public:
+        /**
+         * TitleCursor osztály
+         * A receptek bejárása kisbetűs cím szerinti sorrendben, opcionálisan egy cím-előtagra szűkítve
+         */
+        class TitleCursor
+        {
+        private:
+            BPlusTree::Cursor cursor;   /// A címindex bejárója
+            std::string prefix;         /// Kisbetűs előtag
+
+            friend class RecipeStore;
+            TitleCursor( const BPlusTree::Cursor& c, const std::string& p ) :cursor( c ), prefix( p ) {};
+
+        public:
+            /// Érvényes elemen áll-e
+            bool valid() const { return cursor.valid() && cursor.key().compare( 0, prefix.size(), prefix ) == 0; }
+
+            /// A recept címe
+            std::string title() const { return cursor.value(); }
+
+            /// A recept azonosítója
+            Components::Handle id() const;
+
+            /// Lépés a következő receptre
+            TitleCursor& operator++() { ++cursor; return *this; }
+        };
+
+        /// Konstruktor - megnyitja (ha nem létezik, létrehozza) a fájlt
+        /// ifstream::failure hibát dob, ha a fájl nem nyitható meg, vagy nem ilyen formátumú
+        /// @param path - fájl útvonala
+        /// @param budget - a memóriában tartott lapok összmérete bájtban
+        explicit RecipeStore( const String& path, size_t budget = DEFAULT_BUDGET );
+
+        /// Receptek száma
+        size_t size() const { return byId.size(); }
+
+        /// Megtörtént-e már a receptfájl áttöltése (a receptek későbbi törlése után is igaz marad)
+        bool imported() const { return pool.counter( IMPORTED ) != 0; }
+
+        /// Az áttöltés megtörténtének rögzítése (a következő flush() írja ki)
+        void markImported() { pool.setCounter( IMPORTED, 1 ); }
+
+        /// Új recept felvétele
+        /// @param recipe - recept (kódolatlan instrukciókkal)
+        /// @return Handle - a kiosztott azonosító
+        Components::Handle insert( const Components::Recipe& recipe );
+
+        /// Recept felülírása (a cím is változhat)
+        /// @param id - azonosító
+        /// @param recipe - az új tartalom
+        /// @return bool - létezett-e a recept
+        bool update( const Components::Handle& id, const Components::Recipe& recipe );
+
+        /// Recept betöltése azonosító alapján
+        /// @param id - azonosító
+        /// @param recipe - ide töltődik (az azonosítóval együtt)
+        /// @return bool - létezik-e
+        bool find( const Components::Handle& id, Components::Recipe& recipe );
+
+        /// Recept keresése pontos cím alapján
+        /// @param title - cím
+        /// @return Handle - azonosító, ha nincs ilyen, érvénytelen
+        Components::Handle findTitle( const String& title );
+
+        /// Recept törlése
+        /// @param id - azonosító
+        /// @return bool - létezett-e
+        bool erase( const Components::Handle& id );
+
+        /// Bejárás cím szerint
+        /// @param prefix - kisbetűs cím-előtag (üres = az összes)
+        /// @return TitleCursor - bejáró
+        TitleCursor titles( const std::string& prefix = std::string() );
+
+        /// Minden módosítás kiírása a fájlba
+        /// ofstream::failure hibát dob, ha nem sikerült a művelet
+        void flush() { pool.flush(); }
+
+        /// A lapkeret (kimutatáshoz)
+        const BufferPool& buffers() const { return pool; }
+    };
+}
+
+#endif // NHF4_RECIPESTORE_H
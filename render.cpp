@@ -0,0 +1,26 @@
+/**
+ * \file render.cpp
+ *
+ * Ez a fájl tartalmazza a PageBuffer osztály megvalósítását
+ */
+
+#include "render.h"
+#include "memtrace.h"
+
+void Components::PageBuffer::endRow() {
+    buffer << '\n';
+    if ( (size_t)buffer.tellp() >= capacity ) write();
+}
+
+void Components::PageBuffer::write() {
+    if ( buffer.tellp() <= 0 ) return;
+
+    const std::string content = buffer.str();
+    target.write( content.data(), content.size() );
+    buffer.str( std::string() );
+}
+
+void Components::PageBuffer::flush() {
+    write();
+    target.flush();
+}
@@ -0,0 +1,60 @@
+#ifndef NHF4_RENDER_H
+#define NHF4_RENDER_H
+/**
+ * \file render.h
+ *
+ * Ez a fájl tartalmazza a listák pufferelt kiírásához szükséges PageBuffer osztályt
+ */
+
+#include <iostream>
+#include <sstream>
+#include "memtrace.h"
+
+
+namespace Components
+{
+    /**
+     * PageBuffer osztály
+     * A sorokat egy belső pufferbe formázza, és egy oldalt egyetlen írással ad át a kimenetnek
+     * Soronként nincs flush (std::endl helyett '\n'), a kimenetet csak az oldal végén ürítjük.
+     * Ha a puffer egy oldalon belül eléri a kapacitást, a tartalmát flush nélkül kiírjuk,
+     * így nagy listák (pl. fájlba irányított kimenet) esetén is korlátos marad a memóriaigény.
+     */
+    class PageBuffer
+    {
+    public:
+        static const size_t DEFAULT_CAPACITY = 64 * 1024; /// Alapértelmezett kapacitás bájtban
+
+    private:
+        std::ostream& target;       /// Kimenet
+        std::ostringstream buffer;  /// Belső puffer
+        size_t capacity;            /// Ennyi bájt után a puffert mindenképp kiírjuk
+
+        PageBuffer( const PageBuffer& );
+        PageBuffer& operator=( const PageBuffer& );
+
+    public:
+        /// Konstruktor
+        /// @param ostream - kimenet
+        /// @param cap - kapacitás bájtban
+        explicit PageBuffer( std::ostream& ostream, size_t cap = DEFAULT_CAPACITY ) :target( ostream ), capacity( cap ) {};
+
+        /// Destruktor - kiírja a maradékot
+        ~PageBuffer() { flush(); }
+
+        /// A puffer, amibe a sort formázni kell
+        /// @return std::ostream& - belső puffer
+        std::ostream& row() { return buffer; }
+
+        /// Sor lezárása; ha a puffer megtelt, flush nélkül kiírja
+        void endRow();
+
+        /// Kiírja a puffer tartalmát egyetlen írással (flush nélkül)
+        void write();
+
+        /// Kiírja a puffer tartalmát és üríti a kimenetet (oldal vége)
+        void flush();
+    };
+}
+
+#endif // NHF4_RENDER_H
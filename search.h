@@ -0,0 +1,98 @@
+#ifndef NHF4_SEARCH_H
+#define NHF4_SEARCH_H
+/**
+ * \file search.h
+ *
+ * Ez a fájl tartalmazza a generikus kereséshez szükséges funktorokat
+ * Külön fájlban vannak, hogy a vezérlőn kívül (pl. a teljesítménymérőben) is használhatóak legyenek
+ */
+
+#include <vector>
+#include "memtrace.h"
+#include "string5.h"
+#include "list.h"
+#include "components.h"
+#include "compact.h"
+
+
+/**
+ * title_contains funktor
+ * generikus kereséshez szükséges
+ * a recept címében keresi meg a megadott szövegrészletet
+ */
+class title_contains
+{
+    String compare; /// Megadott szövegrészlet
+public:
+    /// Konstruktor
+    /// Inicializálja a keresett szöveget
+    title_contains(String const &cmp): compare(cmp) {};
+
+    /// operator()
+    /// szerepel-e a címben a keresett szöveg
+    /// @param item - aktuális recept
+    /// @return bool - sikeres találat esetén igaz
+    bool operator()(Components::Recipe const &item) const
+    {
+        String title( item.getTitle() );
+        title.toLower();
+        String comp( compare );
+        comp.toLower();
+
+        return title.find(comp);
+    }
+};
+
+/**
+ * ingredient_contains funktor
+ * generikus kereséshez szükséges
+ * a recept hozzávalólistájában keresi meg a megadott alapanyagokat
+ * A keresett alapanyagok tömör táblában vannak, így receptenként egyszer kell végigmenni a hozzávalókon,
+ * és minden hozzávaló egy hash keresés (a keresett alapanyagok listájának bejárása helyett).
+ */
+class ingredient_contains
+{
+    Components::IngredientTable wanted; /// Keresett alapanyagok
+public:
+    /// Konstruktor
+    /// Inicializáljuk a keresett alapanyagokat
+    ingredient_contains( const Components::LinkedList<Components::Ingredient>& list ) { wanted.addAll( list ); };
+
+    /// operator()
+    /// a megadott alapanyaglista összes elemét megkeresi az aktuális recept hozzávalói között
+    /// @param item - aktuális recept
+    /// @return bool - sikeres találat esetén igaz
+    bool operator()(Components::Recipe const &item) const
+    {
+        const Components::NameTable& names = wanted.getNames();
+        size_t count = names.size();
+
+        // Legfeljebb 64 keresett alapanyagnál bitmaszk jelzi a megtaláltakat, fölötte egy tömb
+        unsigned long long mask = 0;
+        std::vector<char> seen( count > 64 ? count : 0, 0 );
+        size_t matched = 0;
+
+        Components::LinkedList<Components::IngredientQ>::Iterator it( *item.getIngredients() );
+        for ( ; it != Components::LinkedList<Components::IngredientQ>::Iterator() && matched < count; it++ )
+        {
+            unsigned int id = names.find( it->getName() );
+            if ( id == Components::NameTable::NONE ) continue;
+
+            if ( count <= 64 )
+            {
+                unsigned long long bit = 1ULL << id;
+                if ( mask & bit ) continue;
+                mask |= bit;
+            }
+            else
+            {
+                if ( seen[id] ) continue;
+                seen[id] = 1;
+            }
+            matched++;
+        }
+        return matched == count;
+    }
+};
+
+#endif // NHF4_SEARCH_H
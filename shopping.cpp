@@ -0,0 +1,127 @@
+/**
+ * \file shopping.cpp
+ *
+ * Ez a fájl tartalmazza a ShoppingList osztály megvalósítását
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include "shopping.h"
+#include "memtrace.h"
+
+namespace
+{
+    /// Összegezhető mennyiség: a hibás (negatív, az IngredientQ-ban átfordult) mennyiség 0-nak számít
+    unsigned long long amountOf( int quantity )
+    {
+        return quantity > 0 ? (unsigned long long)quantity : 0;
+    }
+
+    /// (név, mértékegység) azonosítópár kulcsok rendezése név, azon belül mértékegység szerint
+    struct ByName
+    {
+        const Components::NameTable& names;     /// Alapanyagnevek
+        const Components::NameTable& units;     /// Mértékegységek
+
+        bool operator()( unsigned long long a, unsigned long long b ) const
+        {
+            int order = std::strcmp( names.name( (unsigned int)( a >> 32 ) ), names.name( (unsigned int)( b >> 32 ) ) );
+            if ( order != 0 ) return order < 0;
+            return std::strcmp( units.name( (unsigned int)a ), units.name( (unsigned int)b ) ) < 0;
+        }
+    };
+}
+
+void Components::ShoppingList::aggregate( const std::vector<const Recipe*>& recipes, size_t from, size_t to, Partial& partial ) {
+    for ( size_t i = from; i < to; i++ )
+    {
+        LinkedList<IngredientQ>::Iterator it( *recipes[i]->getIngredients() );
+        for ( ; it != LinkedList<IngredientQ>::Iterator(); it++ )
+        {
+            unsigned long long key = Partial::key( partial.names.intern( it->getName() ), partial.units.intern( it->getUnit() ) );
+            partial.amounts[key].needed += amountOf( (int)it->getQuantity() );
+        }
+    }
+}
+
+void Components::ShoppingList::build( const std::vector<const Recipe*>& recipes, const LinkedList<IngredientQ>& pantry, unsigned int threads ) {
+    if ( threads == 0 ) threads = std::thread::hardware_concurrency();
+    if ( threads == 0 ) threads = 1;
+
+    size_t maxThreads = recipes.size() / MIN_RECIPES_PER_THREAD;
+    if ( threads > maxThreads ) threads = maxThreads > 0 ? (unsigned int)maxThreads : 1;
+
+    // Szeletenként külön részeredmény, így a szálaknak nem kell zárolniuk
+    std::vector<Partial> partial( threads );
+    if ( threads == 1 )
+    {
+        aggregate( recipes, 0, recipes.size(), partial[0] );
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        size_t chunk = ( recipes.size() + threads - 1 ) / threads;
+        for ( unsigned int t = 0; t < threads; t++ )
+        {
+            size_t from = t * chunk;
+            size_t to = std::min( recipes.size(), from + chunk );
+            workers.push_back( std::thread( aggregate, std::cref( recipes ), from, to, std::ref( partial[t] ) ) );
+        }
+        for ( size_t t = 0; t < workers.size(); t++ ) workers[t].join();
+    }
+
+    // A részeredmények összefésülése az elsőbe - az azonosítók szeletenként mások, a nevek alapján
+    Partial& table = partial[0];
+    for ( size_t t = 1; t < partial.size(); t++ )
+    {
+        const Partial& part = partial[t];
+        for ( std::unordered_map<unsigned long long, Amount>::const_iterator it = part.amounts.begin(); it != part.amounts.end(); it++ )
+        {
+            unsigned int name = (unsigned int)( it->first >> 32 );
+            unsigned int unit = (unsigned int)it->first;
+            unsigned long long key = Partial::key( table.names.intern( part.names.name( name ), part.names.length( name ) ),
+                                                   table.units.intern( part.units.name( unit ), part.units.length( unit ) ) );
+            table.amounts[key].needed += it->second.needed;
+        }
+    }
+
+    // Kamra levonása - csak azonos mértékegység esetén
+    LinkedList<IngredientQ>::Iterator it( pantry );
+    for ( ; it != LinkedList<IngredientQ>::Iterator(); it++ )
+    {
+        unsigned int name = table.names.find( it->getName() );
+        unsigned int unit = table.units.find( it->getUnit() );
+        if ( name == NameTable::NONE || unit == NameTable::NONE ) continue;
+
+        std::unordered_map<unsigned long long, Amount>::iterator found = table.amounts.find( Partial::key( name, unit ) );
+        if ( found != table.amounts.end() ) found->second.stock += amountOf( (int)it->getQuantity() );
+    }
+
+    // A hiányzó tételek név, azon belül mértékegység szerint
+    std::vector<unsigned long long> missing;
+    for ( std::unordered_map<unsigned long long, Amount>::const_iterator amount = table.amounts.begin(); amount != table.amounts.end(); amount++ )
+        if ( amount->second.needed > amount->second.stock ) missing.push_back( amount->first );
+
+    ByName byName = { table.names, table.units };
+    std::sort( missing.begin(), missing.end(), byName );
+
+    items = IngredientTable();
+    amounts.clear();
+    items.reserve( missing.size() );
+    amounts.reserve( missing.size() );
+    for ( size_t i = 0; i < missing.size(); i++ )
+    {
+        unsigned int name = (unsigned int)( missing[i] >> 32 );
+        unsigned int unit = (unsigned int)missing[i];
+        const Amount& amount = table.amounts[missing[i]];
+
+        // A rekord 32 bites mennyisége telítődik, a pontos összegek az amounts-ban vannak
+        unsigned long long lacking = amount.needed - amount.stock;
+        items.add( table.names.name( name ), table.names.length( name ), table.units.name( unit ), table.units.length( unit ),
+                   lacking > INT_MAX ? INT_MAX : (int)lacking );
+        amounts.push_back( amount );
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef NHF4_SHOPPING_H
+#define NHF4_SHOPPING_H
+/**
+ * \file shopping.h
+ *
+ * Ez a fájl tartalmazza a bevásárlólista összesítéséhez szükséges ShoppingList osztályt
+ */
+
+#include <unordered_map>
+#include <vector>
+#include "memtrace.h"
+#include "components.h"
+#include "compact.h"
+
+
+namespace Components
+{
+    /**
+     * ShoppingList osztály
+     * A kiválasztott receptek hozzávalóit (alapanyag, mértékegység) páronként összegzi egy hash táblában,
+     * majd levonja a kamrában lévő mennyiséget, és visszaadja a hiányzó tételeket.
+     * A receptek hozzávalóin egyszer megy végig (O(összes hozzávaló)); nagy kiválasztásnál a recepteket
+     * szeletekre osztja, a szeleteket külön szálakon összegzi, végül a részeredményeket összefésüli.
+     * Eltérő mértékegységeket nem váltunk át, ezek külön tételként szerepelnek.
+     * Az eredmény tömör IngredientTable (név, mértékegység, hiányzó mennyiség), IngredientPrinter-rel írható ki.
+     */
+    class ShoppingList
+    {
+    public:
+        static const size_t MIN_RECIPES_PER_THREAD = 256; /// Ennél kevesebb receptet nem adunk egy szálnak
+
+    private:
+        /// Egy (alapanyag, mértékegység) pár összegei
+        struct Amount
+        {
+            unsigned long long needed;  /// Szükséges mennyiség
+            unsigned long long stock;   /// Kamrában lévő mennyiség
+
+            Amount() :needed( 0 ), stock( 0 ) {};
+        };
+
+        /**
+         * Partial struktúra
+         * Egy szelet részeredménye tömör formában: a nevek és a mértékegységek internálva vannak, az összegek
+         * kulcsa a két azonosítóból álló egész, így hozzávalónként nem kell sztringet másolni vagy foglalni
+         */
+        struct Partial
+        {
+            NameTable names;    /// Alapanyagnevek
+            NameTable units;    /// Mértékegységek
+            std::unordered_map<unsigned long long, Amount> amounts; /// (név, mértékegység) azonosítópár -> összegek
+
+            /// Azonosítópár kulcsa
+            static unsigned long long key( unsigned int name, unsigned int unit ) { return ( (unsigned long long)name << 32 ) | unit; }
+        };
+
+        /// Összegzi a [from, to) tartományba eső receptek hozzávalóit
+        /// @param recipes - receptek
+        /// @param from - első recept indexe
+        /// @param to - utolsó utáni recept indexe
+        /// @param partial - ide összegez
+        static void aggregate( const std::vector<const Recipe*>& recipes, size_t from, size_t to, Partial& partial );
+
+        IngredientTable items;          /// Hiányzó tételek, a rekord mennyisége a hiányzó mennyiség
+        std::vector<Amount> amounts;    /// Tételenként a szükséges és a kamrában lévő mennyiség
+
+    public:
+        /// Bevásárlólista összeállítása (a korábbi tartalom elvész)
+        /// Egy recept többször is szerepelhet (több adag)
+        /// A hiányzó tételek név, azon belül mértékegység szerint rendezve kerülnek a listába
+        /// @param recipes - kiválasztott receptek
+        /// @param pantry - kamra
+        /// @param threads - szálak száma, 0 esetén a hardver alapján választ
+        void build( const std::vector<const Recipe*>& recipes, const LinkedList<IngredientQ>& pantry, unsigned int threads = 0 );
+
+        /// Hiányzó tételek száma
+        size_t size() const { return items.size(); }
+
+        /// Hiányzó tételek (kiíráshoz: IngredientPrinter)
+        const IngredientTable& getItems() const { return items; }
+
+        /// A tétel szükséges mennyisége
+        unsigned long long needed( size_t index ) const { return amounts[index].needed; }
+
+        /// A tétel kamrában lévő mennyisége
+        unsigned long long stock( size_t index ) const { return amounts[index].stock; }
+    };
+}
+
+#endif // NHF4_SHOPPING_H
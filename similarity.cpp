@@ -0,0 +1,154 @@
+/**
+ * \file similarity.cpp
+ *
+ * Ez a fájl tartalmazza a SimilarityIndex osztály megvalósítását
+ */
+
+#include <algorithm>
+#include <climits>
+#include "similarity.h"
+#include "memtrace.h"
+
+namespace
+{
+    /// FNV-1a hash egy nullával lezárt sztringre
+    unsigned long long fnv1a( const char* text )
+    {
+        unsigned long long hash = 14695981039346656037ULL;
+        for ( ; *text != '\0'; text++ )
+        {
+            hash ^= (unsigned char)*text;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    /// splitmix64 keverő - az i. hash függvény: mix( x + (i+1) * arany metszés konstans )
+    unsigned long long mix( unsigned long long x )
+    {
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    /// Találatok rendezése csökkenő hasonlóság, azonos hasonlóságnál azonosító szerint
+    bool better( const Components::SimilarityIndex::Match& a, const Components::SimilarityIndex::Match& b )
+    {
+        if ( a.second != b.second ) return a.second > b.second;
+        return a.first < b.first;
+    }
+}
+
+bool Components::SimilarityIndex::sign( const Components::Recipe& recipe, Signature& signature ) {
+    const LinkedList<IngredientQ>* ingredients = recipe.getIngredients();
+    if ( ingredients->empty() ) return false;
+
+    signature.assign( HASHES, UINT_MAX );
+
+    LinkedList<IngredientQ>::Iterator it( *ingredients );
+    for ( ; it != LinkedList<IngredientQ>::Iterator(); it++ )
+    {
+        unsigned long long base = fnv1a( it->getName().c_str() );
+        for ( int i = 0; i < HASHES; i++ )
+        {
+            unsigned int value = (unsigned int)mix( base + ( i + 1 ) * 0x9e3779b97f4a7c15ULL );
+            if ( value < signature[i] ) signature[i] = value;
+        }
+    }
+
+    return true;
+}
+
+unsigned long long Components::SimilarityIndex::bandHash( const Signature& signature, int band ) {
+    unsigned long long hash = 14695981039346656037ULL ^ (unsigned long long)band;
+    for ( int i = band * ROWS; i < ( band + 1 ) * ROWS; i++ )
+    {
+        hash ^= signature[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+double Components::SimilarityIndex::estimate( const Signature& a, const Signature& b ) {
+    int same = 0;
+    for ( int i = 0; i < HASHES; i++ ) if ( a[i] == b[i] ) same++;
+    return (double)same / HASHES;
+}
+
+void Components::SimilarityIndex::update( const Components::Handle& id, const Components::Recipe& recipe ) {
+    remove( id );
+
+    Signature signature;
+    if ( !sign( recipe, signature ) ) return;
+
+    for ( int band = 0; band < BANDS; band++ )
+        buckets[band][bandHash( signature, band )].push_back( id );
+
+    signatures[id.key()].swap( signature );
+}
+
+bool Components::SimilarityIndex::remove( const Components::Handle& id ) {
+    std::unordered_map<unsigned long long, Signature>::iterator found = signatures.find( id.key() );
+    if ( found == signatures.end() ) return false;
+
+    for ( int band = 0; band < BANDS; band++ )
+    {
+        std::unordered_map<unsigned long long, std::vector<Handle> >::iterator bucket = buckets[band].find( bandHash( found->second, band ) );
+        if ( bucket == buckets[band].end() ) continue;
+
+        std::vector<Handle>& members = bucket->second;
+        std::vector<Handle>::iterator member = std::find( members.begin(), members.end(), id );
+        if ( member != members.end() )
+        {
+            *member = members.back();
+            members.pop_back();
+        }
+        if ( members.empty() ) buckets[band].erase( bucket );
+    }
+
+    signatures.erase( found );
+    return true;
+}
+
+std::vector<Components::SimilarityIndex::Match> Components::SimilarityIndex::similar( const Components::Handle& id, size_t k ) const {
+    std::vector<Match> result;
+
+    std::unordered_map<unsigned long long, Signature>::const_iterator self = signatures.find( id.key() );
+    if ( self == signatures.end() || k == 0 ) return result;
+
+    // Jelöltek: akik legalább egy sávban egy vödörbe kerültek a recepttel
+    std::vector<Handle> candidates;
+    for ( int band = 0; band < BANDS; band++ )
+    {
+        std::unordered_map<unsigned long long, std::vector<Handle> >::const_iterator bucket = buckets[band].find( bandHash( self->second, band ) );
+        if ( bucket != buckets[band].end() ) candidates.insert( candidates.end(), bucket->second.begin(), bucket->second.end() );
+    }
+
+    std::sort( candidates.begin(), candidates.end() );
+    candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+    for ( size_t i = 0; i < candidates.size(); i++ )
+    {
+        if ( candidates[i] == id ) continue;
+        std::unordered_map<unsigned long long, Signature>::const_iterator other = signatures.find( candidates[i].key() );
+        if ( other != signatures.end() ) result.push_back( Match( candidates[i], estimate( self->second, other->second ) ) );
+    }
+
+    if ( result.size() > k )
+    {
+        std::partial_sort( result.begin(), result.begin() + k, result.end(), better );
+        result.resize( k );
+    }
+    else
+    {
+        std::sort( result.begin(), result.end(), better );
+    }
+
+    return result;
+}
+
+void Components::SimilarityIndex::clear() {
+    signatures.clear();
+    for ( int band = 0; band < BANDS; band++ ) buckets[band].clear();
+}
@@ -0,0 +1,84 @@
+#ifndef NHF4_SIMILARITY_H
+#define NHF4_SIMILARITY_H
+/**
+ * \file similarity.h
+ *
+ * Ez a fájl tartalmazza a hasonló receptek kereséséhez szükséges SimilarityIndex osztályt
+ */
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "memtrace.h"
+#include "components.h"
+
+
+namespace Components
+{
+    /**
+     * SimilarityIndex osztály
+     * A receptek hozzávaló-halmazaihoz MinHash szignatúrát számol, és ezeket LSH vödrökbe rendezi
+     * Két recept szignatúrájában az egyező pozíciók aránya a hozzávaló-halmazok Jaccard-hasonlóságát becsli.
+     * A szignatúrát BANDS sávra bontjuk (sávonként ROWS érték); ha két recept valamelyik sávja teljesen
+     * megegyezik, akkor ugyanabba a vödörbe kerülnek. Lekérdezéskor csak az azonos vödrökben lévő
+     * jelölteket hasonlítjuk össze, így nem kell az összes receptet végignézni.
+     * (J = 0.5 hasonlóságnál ~65%, J = 0.8-nál ~100% eséllyel lesz jelölt)
+     */
+    class SimilarityIndex
+    {
+    public:
+        static const int BANDS = 16;                /// Sávok száma
+        static const int ROWS = 4;                  /// Egy sáv hossza
+        static const int HASHES = BANDS * ROWS;     /// Szignatúra hossza
+
+        /// Egy találat: a recept azonosítója és a becsült hasonlóság (0-1)
+        typedef std::pair<Handle, double> Match;
+
+    private:
+        /// Receptenként tárolt szignatúra
+        typedef std::vector<unsigned int> Signature;
+
+        /// Azonosító kulcsa -> szignatúra
+        std::unordered_map<unsigned long long, Signature> signatures;
+
+        /// Sávonként: sáv hash -> az oda tartozó receptek azonosítói
+        std::unordered_map<unsigned long long, std::vector<Handle> > buckets[BANDS];
+
+        /// Kiszámolja a recept szignatúráját
+        /// @param recipe - recept
+        /// @param signature - ide kerül a szignatúra
+        /// @return bool - van-e hozzávalója (üres halmazhoz nem számolunk szignatúrát)
+        static bool sign( const Recipe& recipe, Signature& signature );
+
+        /// A szignatúra adott sávjának hash értéke
+        static unsigned long long bandHash( const Signature& signature, int band );
+
+        /// Két szignatúra egyező pozícióinak aránya
+        static double estimate( const Signature& a, const Signature& b );
+
+    public:
+        /// Indexben lévő receptek száma
+        size_t size() const { return signatures.size(); }
+
+        /// Recept felvétele vagy frissítése (pl. a hozzávalók módosítása után)
+        /// @param id - recept azonosítója
+        /// @param recipe - recept
+        void update( const Handle& id, const Recipe& recipe );
+
+        /// Recept törlése az indexből
+        /// @param id - recept azonosítója
+        /// @return bool - szerepelt-e
+        bool remove( const Handle& id );
+
+        /// A megadott recepthez leginkább hasonló receptek
+        /// @param id - recept azonosítója (az indexben kell lennie)
+        /// @param k - legfeljebb ennyi találat
+        /// @return std::vector<Match> - találatok csökkenő hasonlóság szerint (a receptet magát nem tartalmazza)
+        std::vector<Match> similar( const Handle& id, size_t k ) const;
+
+        /// Minden elem törlése
+        void clear();
+    };
+}
+
+#endif // NHF4_SIMILARITY_H
@@ -0,0 +1,272 @@
+#ifndef NHF4_SKIPLIST_H
+#define NHF4_SKIPLIST_H
+/**
+ * \file skiplist.h
+ *
+ * Ez a fájl tartalmazza a rendezett indexekhez használt SkipList osztályt
+ */
+
+#include <cstddef>
+#include "memtrace.h"
+
+
+namespace Components
+{
+    /**
+     * SkipList osztály
+     * Rendezett halmaz, indexelhető skip list-tel megvalósítva
+     * Minden szinten tároljuk az ugrás hosszát (span), így a beszúrás, törlés, alsó korlát keresése,
+     * a sorszám (rang) lekérdezése és a k. elem elérése is várhatóan O(log n) idejű.
+     * Egy [rang, rang+k) tartomány bejárása így O(log n + k).
+     * A T típusnak operator<-t kell megvalósítania, az egyenlő elemeket nem tárolja kétszer.
+     */
+    template<class T>
+    class SkipList
+    {
+    public:
+        static const int MAX_LEVEL = 32; /// Szintek maximális száma
+
+    private:
+        /**
+         * Node osztály
+         * Egy elem, a szintenkénti következő elemekkel és ugráshosszakkal
+         */
+        struct Node
+        {
+            T value;        /// Tárolt elem
+            int height;     /// Szintek száma
+            Node** next;    /// Szintenként a következő elem
+            size_t* span;   /// Szintenként a következő elemig megtett lépések száma
+
+            Node( const T& v, int h ) :value( v ), height( h ), next( new Node*[h] ), span( new size_t[h] )
+            {
+                for ( int i = 0; i < h; i++ ) { next[i] = nullptr; span[i] = 0; }
+            }
+
+            ~Node() { delete[] next; delete[] span; }
+        };
+
+        Node* head;                 /// Fej (strázsa), minden szinten jelen van
+        int level;                  /// Jelenleg használt szintek száma
+        size_t siz;                 /// Elemek száma
+        unsigned long long seed;    /// Véletlenszám-generátor állapota a szintek sorsolásához
+
+        /// Szint sorsolása (1/4 valószínűséggel lép feljebb)
+        int randomLevel();
+
+        /// Egyenlő-e a két elem (operator< alapján)
+        static bool equal( const T& a, const T& b ) { return !( a < b ) && !( b < a ); }
+
+        SkipList( const SkipList& );
+        SkipList& operator=( const SkipList& );
+
+    public:
+        /**
+         * Cursor osztály
+         * Előre haladó bejáró a rendezett elemeken
+         */
+        class Cursor
+        {
+            Node* current; /// Aktuális elem
+            friend class SkipList<T>;
+            explicit Cursor( Node* n ) :current( n ) {};
+
+        public:
+            /// Érvényes elemre mutat-e
+            bool valid() const { return current != nullptr; }
+
+            /// Aktuális elem
+            const T& operator*() const { return current->value; }
+            const T* operator->() const { return &current->value; }
+
+            /// Lépés a következő elemre
+            Cursor& operator++() { if ( current ) current = current->next[0]; return *this; }
+        };
+
+        /// Default konstruktor
+        SkipList() :head( new Node( T(), MAX_LEVEL ) ), level( 1 ), siz( 0 ), seed( 0x2545F4914F6CDD1DULL ) {};
+
+        /// Destruktor
+        ~SkipList() { clear(); delete head; }
+
+        /// Elemek száma
+        size_t size() const { return siz; }
+
+        /// Üres-e
+        bool empty() const { return siz == 0; }
+
+        /// Elem beszúrása
+        /// @param value - beszúrandó elem
+        /// @return bool - beszúrtuk-e (hamis, ha már szerepelt)
+        bool insert( const T& value );
+
+        /// Elem törlése
+        /// @param value - törlendő elem
+        /// @return bool - szerepelt-e
+        bool erase( const T& value );
+
+        /// A megadott elemnél kisebb elemek száma (= az első, nem kisebb elem rangja)
+        /// @param value - keresett elem
+        /// @return size_t - 0-tól számozott rang
+        size_t rankOf( const T& value ) const;
+
+        /// A megadott rangú elemre mutató bejáró
+        /// @param rank - 0-tól számozott rang
+        /// @return Cursor - bejáró, ha rank >= size() akkor érvénytelen
+        Cursor at( size_t rank ) const;
+
+        /// Az első elemre mutató bejáró
+        Cursor begin() const { return Cursor( head->next[0] ); }
+
+        /// Minden elem törlése
+        void clear();
+    };
+
+    template<class T>
+    int SkipList<T>::randomLevel() {
+        int h = 1;
+        while ( h < MAX_LEVEL )
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            if ( ( seed & 3 ) != 0 ) break;
+            h++;
+        }
+        return h;
+    }
+
+    template<class T>
+    bool SkipList<T>::insert( const T& value ) {
+        Node* update[MAX_LEVEL];
+        size_t rank[MAX_LEVEL];
+
+        Node* x = head;
+        for ( int i = level - 1; i >= 0; i-- )
+        {
+            rank[i] = ( i == level - 1 ) ? 0 : rank[i + 1];
+            while ( x->next[i] != nullptr && x->next[i]->value < value )
+            {
+                rank[i] += x->span[i];
+                x = x->next[i];
+            }
+            update[i] = x;
+        }
+
+        if ( x->next[0] != nullptr && equal( x->next[0]->value, value ) ) return false;
+
+        int h = randomLevel();
+        if ( h > level )
+        {
+            for ( int i = level; i < h; i++ )
+            {
+                rank[i] = 0;
+                update[i] = head;
+                head->span[i] = siz;
+            }
+            level = h;
+        }
+
+        Node* node = new Node( value, h );
+        for ( int i = 0; i < h; i++ )
+        {
+            node->next[i] = update[i]->next[i];
+            update[i]->next[i] = node;
+
+            node->span[i] = update[i]->span[i] - ( rank[0] - rank[i] );
+            update[i]->span[i] = ( rank[0] - rank[i] ) + 1;
+        }
+
+        // A magasabb szinteken az átugrott elemek száma eggyel nő
+        for ( int i = h; i < level; i++ ) update[i]->span[i]++;
+
+        siz++;
+        return true;
+    }
+
+    template<class T>
+    bool SkipList<T>::erase( const T& value ) {
+        Node* update[MAX_LEVEL];
+
+        Node* x = head;
+        for ( int i = level - 1; i >= 0; i-- )
+        {
+            while ( x->next[i] != nullptr && x->next[i]->value < value ) x = x->next[i];
+            update[i] = x;
+        }
+
+        x = x->next[0];
+        if ( x == nullptr || !equal( x->value, value ) ) return false;
+
+        for ( int i = 0; i < level; i++ )
+        {
+            if ( update[i]->next[i] == x )
+            {
+                update[i]->span[i] += x->span[i] - 1;
+                update[i]->next[i] = x->next[i];
+            }
+            else
+            {
+                update[i]->span[i]--;
+            }
+        }
+
+        while ( level > 1 && head->next[level - 1] == nullptr ) level--;
+
+        delete x;
+        siz--;
+        return true;
+    }
+
+    template<class T>
+    size_t SkipList<T>::rankOf( const T& value ) const {
+        size_t rank = 0;
+        Node* x = head;
+        for ( int i = level - 1; i >= 0; i-- )
+        {
+            while ( x->next[i] != nullptr && x->next[i]->value < value )
+            {
+                rank += x->span[i];
+                x = x->next[i];
+            }
+        }
+        return rank;
+    }
+
+    template<class T>
+    typename SkipList<T>::Cursor SkipList<T>::at( size_t rank ) const {
+        if ( rank >= siz ) return Cursor( nullptr );
+
+        size_t target = rank + 1;
+        size_t traversed = 0;
+        Node* x = head;
+        for ( int i = level - 1; i >= 0; i-- )
+        {
+            while ( x->next[i] != nullptr && traversed + x->span[i] <= target )
+            {
+                traversed += x->span[i];
+                x = x->next[i];
+            }
+            if ( traversed == target ) return Cursor( x );
+        }
+
+        return Cursor( nullptr );
+    }
+
+    template<class T>
+    void SkipList<T>::clear() {
+        Node* x = head->next[0];
+        while ( x != nullptr )
+        {
+            Node* next = x->next[0];
+            delete x;
+            x = next;
+        }
+
+        for ( int i = 0; i < MAX_LEVEL; i++ ) { head->next[i] = nullptr; head->span[i] = 0; }
+        level = 1;
+        siz = 0;
+    }
+}
+
+#endif // NHF4_SKIPLIST_H
@@ -0,0 +1,202 @@
+#ifndef NHF4_SLOTMAP_H
+#define NHF4_SLOTMAP_H
+/**
+ * \file slotmap.h
+ *
+ * Ez a fájl tartalmazza a stabil azonosítókhoz szükséges Handle és SlotMap osztályokat
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "memtrace.h"
+
+
+namespace Components
+{
+    /**
+     * Handle osztály
+     * Stabil azonosító, ami egy slot indexéből és a slot generációjából áll
+     * Ha a slotban lévő elemet töröljük, a generáció nő, így a régi azonosító érvénytelenné válik,
+     * de az összes többi elem azonosítója változatlan marad
+     * Szöveges formája: #index.generacio (pl. #12.0)
+     */
+    struct Handle
+    {
+        static const unsigned int INVALID = 0xffffffffu; /// Érvénytelen index
+
+        unsigned int index;         /// Slot indexe
+        unsigned int generation;    /// Slot generációja
+
+        /// Default konstruktor - érvénytelen azonosító
+        Handle() :index( INVALID ), generation( 0 ) {};
+
+        /// Konstruktor
+        /// @param i - slot indexe
+        /// @param g - slot generációja
+        Handle( unsigned int i, unsigned int g ) :index( i ), generation( g ) {};
+
+        /// Érvényes-e az azonosító (nem azt jelenti, hogy élő elemre mutat!)
+        bool valid() const { return index != INVALID; }
+
+        /// Egyetlen számba tömörített alak (pl. hash kulcsnak)
+        unsigned long long key() const { return ( (unsigned long long)generation << 32 ) | index; }
+
+        bool operator==( const Handle& other ) const { return index == other.index && generation == other.generation; }
+        bool operator!=( const Handle& other ) const { return !( *this == other ); }
+        bool operator<( const Handle& other ) const { return key() < other.key(); }
+
+        /// Megvizsgálja, hogy a szöveg azonosító formátumú-e (#-tel kezdődik, vagy tartalmaz pontot)
+        /// @param text - vizsgált szöveg
+        /// @return bool - azonosítónak tűnik-e
+        static bool looksLike( const std::string& text );
+
+        /// Azonosító beolvasása szövegből (#index.generacio vagy index.generacio)
+        /// @param text - beolvasandó szöveg
+        /// @param out - ide kerül a beolvasott azonosító
+        /// @return bool - sikeres volt-e a beolvasás
+        static bool parse( const std::string& text, Handle& out );
+    };
+
+    /// Kiírja az azonosítót #index.generacio formában
+    std::ostream& operator<<( std::ostream& os, const Handle& h );
+
+    /**
+     * SlotMap osztály
+     * Generációs slot map: O(1) beszúrás, keresés és törlés stabil azonosítókkal
+     * Az elemek egy tömör tömbben vannak (így a bejárás és a véletlen elem választása is O(1)/elem),
+     * a slotok pedig a tömör tömbbeli pozícióra mutatnak. Törléskor az utolsó elem a törölt helyére kerül.
+     */
+    template<class T>
+    class SlotMap
+    {
+        /**
+         * Slot osztály
+         * Foglalt slot esetén a tömör tömbbeli pozíciót, szabad slot esetén a következő szabad slotot tárolja
+         */
+        struct Slot
+        {
+            unsigned int generation;    /// Generáció
+            unsigned int target;        /// Tömör pozíció / következő szabad slot
+            bool used;                  /// Foglalt-e
+        };
+
+        std::vector<Slot> slots;            /// Slotok
+        std::vector<T> values;              /// Tömören tárolt elemek
+        std::vector<unsigned int> owners;   /// Tömör pozíció -> slot index
+        unsigned int freeHead;              /// Első szabad slot
+
+    public:
+        /// Default konstruktor
+        SlotMap() :freeHead( Handle::INVALID ) {};
+
+        /// Elemek száma
+        size_t size() const { return values.size(); }
+
+        /// Üres-e
+        bool empty() const { return values.empty(); }
+
+        /// Új elem beszúrása
+        /// @param value - beszúrandó elem
+        /// @return Handle - az elem stabil azonosítója
+        Handle insert( const T& value );
+
+        /// Elem lekérdezése azonosító alapján
+        /// @param h - azonosító
+        /// @return T* - az elemre mutató pointer, elavult/érvénytelen azonosító esetén nullptr
+        T* get( const Handle& h );
+        const T* get( const Handle& h ) const;
+
+        /// Él-e még az azonosítóhoz tartozó elem
+        bool contains( const Handle& h ) const;
+
+        /// Elem törlése azonosító alapján
+        /// @param h - azonosító
+        /// @return bool - volt-e ilyen elem
+        bool erase( const Handle& h );
+
+        /// A tömör tömb adott pozícióján lévő elem
+        /// @param pos - pozíció (0 <= pos < size())
+        T& valueAt( size_t pos ) { return values[pos]; }
+
+        /// A tömör tömb adott pozícióján lévő elem azonosítója
+        /// @param pos - pozíció (0 <= pos < size())
+        Handle handleAt( size_t pos ) const { return Handle( owners[pos], slots[owners[pos]].generation ); }
+
+        /// Minden elem törlése (a generációk megmaradnak, így a régi azonosítók nem élednek újra)
+        void clear();
+    };
+
+    template<class T>
+    Handle SlotMap<T>::insert( const T& value ) {
+        unsigned int index;
+        if ( freeHead != Handle::INVALID )
+        {
+            index = freeHead;
+            freeHead = slots[index].target;
+        }
+        else
+        {
+            index = (unsigned int)slots.size();
+            Slot slot;
+            slot.generation = 0;
+            slots.push_back( slot );
+        }
+
+        slots[index].target = (unsigned int)values.size();
+        slots[index].used = true;
+        values.push_back( value );
+        owners.push_back( index );
+
+        return Handle( index, slots[index].generation );
+    }
+
+    template<class T>
+    bool SlotMap<T>::contains( const Handle& h ) const {
+        return h.index < slots.size() && slots[h.index].used && slots[h.index].generation == h.generation;
+    }
+
+    template<class T>
+    T* SlotMap<T>::get( const Handle& h ) {
+        if ( !contains( h ) ) return nullptr;
+        return &values[slots[h.index].target];
+    }
+
+    template<class T>
+    const T* SlotMap<T>::get( const Handle& h ) const {
+        if ( !contains( h ) ) return nullptr;
+        return &values[slots[h.index].target];
+    }
+
+    template<class T>
+    bool SlotMap<T>::erase( const Handle& h ) {
+        if ( !contains( h ) ) return false;
+
+        // Az utolsó elemet a törölt helyére mozgatjuk
+        unsigned int pos = slots[h.index].target;
+        unsigned int last = (unsigned int)values.size() - 1;
+        if ( pos != last )
+        {
+            values[pos] = values[last];
+            owners[pos] = owners[last];
+            slots[owners[pos]].target = pos;
+        }
+        values.pop_back();
+        owners.pop_back();
+
+        // A slot generációja nő, így a régi azonosító elavul
+        slots[h.index].used = false;
+        slots[h.index].generation++;
+        slots[h.index].target = freeHead;
+        freeHead = h.index;
+
+        return true;
+    }
+
+    template<class T>
+    void SlotMap<T>::clear() {
+        while ( !values.empty() ) erase( handleAt( values.size() - 1 ) );
+    }
+}
+
+#endif // NHF4_SLOTMAP_H
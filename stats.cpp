@@ -0,0 +1,155 @@
+/**
+ * \file stats.cpp
+ *
+ * Ez a fájl tartalmazza a futásidejű statisztikák gyűjtésének és kiírásának megvalósítását
+ */
+
+#include <climits>
+#include <iomanip>
+#include "stats.h"
+#include "memtrace.h"
+
+namespace
+{
+    /// Műveletek nevei - a Stats::Operation sorrendjében
+    const char* const operationNames[Stats::OP_COUNT] = {
+            "load", "load_instructions", "save", "search_title", "search_random", "search_one_ingredient",
+            "search_more_ingredient", "search_prefix", "search_similar", "search_combined", "rank_results", "add_recipe",
+            "remove_recipe", "modify_recipe", "add_ingredient", "remove_ingredient", "add_pantry", "remove_pantry",
+            "shopping_list", "publish"
+    };
+
+    /// Számlálók nevei - a Stats::Counter sorrendjében
+    const char* const counterNames[Stats::COUNTER_COUNT] = { "nodes_visited", "comparisons", "cache_hits", "cache_misses" };
+
+    Stats::Histogram histograms[Stats::OP_COUNT];                       /// Műveletenkénti hisztogramok
+    std::atomic<unsigned long long> counters[Stats::COUNTER_COUNT];     /// Számlálók
+
+    /// A vödör indexe (log2) a megadott értékhez
+    int bucketOf( unsigned long long ns )
+    {
+        int i = 0;
+        while ( ns > 1 && i < Stats::Histogram::BUCKETS - 1 ) { ns >>= 1; i++; }
+        return i;
+    }
+
+    /// Nanoszekundum -> mikroszekundum (kiíráshoz)
+    double us( unsigned long long ns ) { return ns / 1000.0; }
+}
+
+Stats::Histogram::Histogram() {
+    reset();
+}
+
+void Stats::Histogram::record( unsigned long long ns ) {
+    buckets[bucketOf( ns )].fetch_add( 1, std::memory_order_relaxed );
+    count.fetch_add( 1, std::memory_order_relaxed );
+    total.fetch_add( ns, std::memory_order_relaxed );
+
+    unsigned long long current = min.load( std::memory_order_relaxed );
+    while ( ns < current && !min.compare_exchange_weak( current, ns, std::memory_order_relaxed ) );
+
+    current = max.load( std::memory_order_relaxed );
+    while ( ns > current && !max.compare_exchange_weak( current, ns, std::memory_order_relaxed ) );
+}
+
+void Stats::Histogram::reset() {
+    for ( int i = 0; i < BUCKETS; i++ ) buckets[i].store( 0, std::memory_order_relaxed );
+    count.store( 0, std::memory_order_relaxed );
+    total.store( 0, std::memory_order_relaxed );
+    min.store( ULLONG_MAX, std::memory_order_relaxed );
+    max.store( 0, std::memory_order_relaxed );
+}
+
+unsigned long long Stats::Histogram::percentile( double p ) const {
+    unsigned long long all = getCount();
+    if ( all == 0 ) return 0;
+
+    unsigned long long target = (unsigned long long)( all * p / 100.0 );
+    if ( target < 1 ) target = 1;
+
+    unsigned long long seen = 0;
+    for ( int i = 0; i < BUCKETS; i++ )
+    {
+        seen += getBucket( i );
+        if ( seen >= target )
+        {
+            // A vödör felső határa, de legfeljebb a mért maximum
+            unsigned long long upper = ( 2ULL << i ) - 1;
+            return upper < getMax() ? upper : getMax();
+        }
+    }
+
+    return getMax();
+}
+
+void Stats::record( Operation op, unsigned long long ns ) {
+    histograms[op].record( ns );
+}
+
+void Stats::count( Counter counter, unsigned long long n ) {
+    counters[counter].fetch_add( n, std::memory_order_relaxed );
+}
+
+void Stats::reset() {
+    for ( int i = 0; i < OP_COUNT; i++ ) histograms[i].reset();
+    for ( int i = 0; i < COUNTER_COUNT; i++ ) counters[i].store( 0, std::memory_order_relaxed );
+}
+
+void Stats::dump( std::ostream& ostream ) {
+    if ( !enabled() ) { ostream << "A statisztika gyujtes ki van kapcsolva (forditas NHF_STATS nelkul)." << std::endl; return; }
+
+    std::ios_base::fmtflags flags = ostream.flags();
+    ostream << std::fixed << std::setprecision( 1 )
+            << std::left << std::setw( 24 ) << "Muvelet" << std::right
+            << std::setw( 8 ) << "db" << std::setw( 12 ) << "atlag(us)" << std::setw( 12 ) << "min(us)"
+            << std::setw( 12 ) << "p50(us)" << std::setw( 12 ) << "p99(us)" << std::setw( 12 ) << "max(us)" << '\n';
+
+    for ( int i = 0; i < OP_COUNT; i++ )
+    {
+        const Histogram& h = histograms[i];
+        if ( h.getCount() == 0 ) continue;
+
+        ostream << std::left << std::setw( 24 ) << operationNames[i] << std::right
+                << std::setw( 8 ) << h.getCount() << std::setw( 12 ) << us( h.getTotal() / h.getCount() )
+                << std::setw( 12 ) << us( h.getMin() ) << std::setw( 12 ) << us( h.percentile( 50 ) )
+                << std::setw( 12 ) << us( h.percentile( 99 ) ) << std::setw( 12 ) << us( h.getMax() ) << '\n';
+    }
+
+    ostream << "Szamlalok:" << '\n';
+    for ( int i = 0; i < COUNTER_COUNT; i++ )
+        ostream << "  " << std::left << std::setw( 22 ) << counterNames[i] << std::right << counters[i].load( std::memory_order_relaxed ) << '\n';
+
+    ostream.flush();
+    ostream.flags( flags );
+}
+
+void Stats::dumpJson( std::ostream& ostream ) {
+    ostream << "{\"enabled\":" << ( enabled() ? "true" : "false" ) << ",\"operations\":{";
+
+    bool first = true;
+    for ( int i = 0; i < OP_COUNT; i++ )
+    {
+        const Histogram& h = histograms[i];
+        if ( h.getCount() == 0 ) continue;
+
+        ostream << ( first ? "" : "," ) << "\"" << operationNames[i] << "\":{"
+                << "\"count\":" << h.getCount() << ",\"total_ns\":" << h.getTotal()
+                << ",\"min_ns\":" << h.getMin() << ",\"max_ns\":" << h.getMax()
+                << ",\"p50_ns\":" << h.percentile( 50 ) << ",\"p90_ns\":" << h.percentile( 90 )
+                << ",\"p99_ns\":" << h.percentile( 99 ) << ",\"histogram\":[";
+
+        // Csak az utolsó nem üres vödörig írjuk ki
+        int last = Histogram::BUCKETS - 1;
+        while ( last > 0 && h.getBucket( last ) == 0 ) last--;
+        for ( int b = 0; b <= last; b++ ) ostream << ( b ? "," : "" ) << h.getBucket( b );
+
+        ostream << "]}";
+        first = false;
+    }
+
+    ostream << "},\"counters\":{";
+    for ( int i = 0; i < COUNTER_COUNT; i++ )
+        ostream << ( i ? "," : "" ) << "\"" << counterNames[i] << "\":" << counters[i].load( std::memory_order_relaxed );
+    ostream << "}}" << std::endl;
+}
@@ -0,0 +1,167 @@
+#ifndef NHF4_STATS_H
+#define NHF4_STATS_H
+/**
+ * \file stats.h
+ *
+ * Ez a fájl tartalmazza a futásidejű statisztikák (időmérők, számlálók) gyűjtését
+ * A gyűjtés csak NHF_STATS definiálása esetén aktív. Ha nincs definiálva, akkor a
+ * STATS_TIMER és STATS_COUNT makrók üresek, így a mérésnek nincs semmilyen költsége.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include "memtrace.h"
+
+namespace Stats
+{
+    /// Mért műveletek
+    /// Új művelet felvételekor a stats.cpp-ben lévő névtömböt is bővíteni kell
+    enum Operation
+    {
+        OP_LOAD,
+        OP_LOAD_INSTRUCTIONS,
+        OP_SAVE,
+        OP_SEARCH_TITLE,
+        OP_SEARCH_RANDOM,
+        OP_SEARCH_ONE_INGREDIENT,
+        OP_SEARCH_MORE_INGREDIENT,
+        OP_SEARCH_PREFIX,
+        OP_SEARCH_SIMILAR,
+        OP_SEARCH_COMBINED,
+        OP_RANK_RESULTS,
+        OP_ADD_RECIPE,
+        OP_REMOVE_RECIPE,
+        OP_MODIFY_RECIPE,
+        OP_ADD_INGREDIENT,
+        OP_REMOVE_INGREDIENT,
+        OP_ADD_PANTRY,
+        OP_REMOVE_PANTRY,
+        OP_SHOPPING_LIST,
+        OP_PUBLISH,
+        OP_COUNT    /// Végjel
+    };
+
+    /// Számlálók
+    enum Counter
+    {
+        NODES_VISITED,  /// Listabejárás során érintett elemek
+        COMPARISONS,    /// Listabejárás során végzett összehasonlítások
+        CACHE_HITS,     /// Gyorsítótárból kiszolgált keresések
+        CACHE_MISSES,   /// Gyorsítótárban nem talált keresések
+        COUNTER_COUNT   /// Végjel
+    };
+
+    /// Be van-e kapcsolva a gyűjtés
+    /// @return bool - NHF_STATS definiálva van-e
+    inline bool enabled()
+    {
+#ifdef NHF_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Histogram osztály
+     * Egy művelet késleltetéseinek eloszlását tárolja kettő hatványai szerinti vödrökben
+     * (az i. vödör a [2^i, 2^(i+1)) nanoszekundum közötti értékeket számolja)
+     * Az adattagok atomiak, így több szálról is rögzíthető
+     */
+    class Histogram
+    {
+    public:
+        static const int BUCKETS = 48;  /// Vödrök száma (~2^48 ns, kb. 3 nap felső határ)
+
+    private:
+        std::atomic<unsigned long long> buckets[BUCKETS];   /// Vödrök
+        std::atomic<unsigned long long> count;              /// Mérések száma
+        std::atomic<unsigned long long> total;              /// Összes idő (ns)
+        std::atomic<unsigned long long> min;                /// Legkisebb mért érték (ns)
+        std::atomic<unsigned long long> max;                /// Legnagyobb mért érték (ns)
+
+    public:
+        /// Default konstruktor
+        Histogram();
+
+        /// Új mérés rögzítése
+        /// @param ns - eltelt idő nanoszekundumban
+        void record( unsigned long long ns );
+
+        /// Nullázza a hisztogramot
+        void reset();
+
+        unsigned long long getCount() const { return count.load( std::memory_order_relaxed ); }
+        unsigned long long getTotal() const { return total.load( std::memory_order_relaxed ); }
+        unsigned long long getMin() const { return getCount() ? min.load( std::memory_order_relaxed ) : 0; }
+        unsigned long long getMax() const { return max.load( std::memory_order_relaxed ); }
+        unsigned long long getBucket( int i ) const { return buckets[i].load( std::memory_order_relaxed ); }
+
+        /// Percentilis becslése a vödrök alapján (a vödör felső határát adja vissza)
+        /// @param p - percentilis (0-100)
+        /// @return becsült érték nanoszekundumban
+        unsigned long long percentile( double p ) const;
+    };
+
+    /// Rögzít egy mérést a megadott művelethez
+    /// @param op - művelet
+    /// @param ns - eltelt idő nanoszekundumban
+    void record( Operation op, unsigned long long ns );
+
+    /// Növeli a megadott számlálót
+    /// @param counter - számláló
+    /// @param n - növelés mértéke
+    void count( Counter counter, unsigned long long n );
+
+    /// Nullázza az összes statisztikát
+    void reset();
+
+    /// Kiírja a statisztikákat szöveges formában
+    /// @param ostream - kimenet
+    void dump( std::ostream& ostream );
+
+    /// Kiírja a statisztikákat JSON formátumban
+    /// @param ostream - kimenet
+    void dumpJson( std::ostream& ostream );
+
+    /**
+     * ScopedTimer osztály
+     * Létrehozásától a megszűnéséig méri az időt, majd rögzíti a megadott művelethez
+     */
+    class ScopedTimer
+    {
+    private:
+        Operation op;                                   /// Mért művelet
+        std::chrono::steady_clock::time_point begin;    /// Kezdés időpontja
+
+        ScopedTimer( const ScopedTimer& );
+        ScopedTimer& operator=( const ScopedTimer& );
+
+    public:
+        /// Konstruktor - elindítja a mérést
+        /// @param o - mért művelet
+        explicit ScopedTimer( Operation o ) :op( o ), begin( std::chrono::steady_clock::now() ) {};
+
+        /// Destruktor - rögzíti az eltelt időt
+        ~ScopedTimer()
+        {
+            record( op, std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - begin ).count() );
+        }
+    };
+}
+
+#ifdef NHF_STATS
+    /// A blokk végéig méri az időt az adott művelethez (blokkonként egyszer használható)
+    #define STATS_TIMER(op) Stats::ScopedTimer stats_scoped_timer( Stats::op )
+    /// Mint a STATS_TIMER, de a művelet futásidejű Stats::Operation érték
+    #define STATS_TIMER_OP(op) Stats::ScopedTimer stats_scoped_timer( (op) )
+    /// Növeli a megadott számlálót
+    #define STATS_COUNT(counter, n) Stats::count( Stats::counter, (n) )
+#else
+    #define STATS_TIMER(op)
+    #define STATS_TIMER_OP(op) (void)( op )
+    #define STATS_COUNT(counter, n)
+#endif
+
+#endif // NHF4_STATS_H
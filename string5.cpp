@@ -48,7 +48,7 @@ String::String(const String& s1) {
     // Helyet foglalunk
     pData = new char[len+1];
     // Bemásoljuk a stringet, ami le van zárva 0-val így használható az strcpy is
-    strcpy(pData, s1.pData);
+    strcpy(pData, s1.c_str());
 }
 
 // operator=
@@ -59,11 +59,22 @@ String& String::operator=(const String& rhs_s) {
         // Helyet foglalunk
         pData = new char[len+1];
         // Bemásoljuk a stringet, ami le van zárva 0-val így használható az strcpy is
-        strcpy(pData, rhs_s.pData);
+        strcpy(pData, rhs_s.c_str());
     }
     return *this;
 }
 
+// mozgató operator=
+String& String::operator=(String&& rhs_s) {
+    char* tmpData = pData;
+    size_t tmpLen = len;
+    pData = rhs_s.pData;
+    len = rhs_s.len;
+    rhs_s.pData = tmpData;
+    rhs_s.len = tmpLen;
+    return *this;
+}
+
 // [] operátorok: egy megadott indexű elem REFERENCIÁJÁVAL térnek vissza.
 // indexhiba esetén dobjon egy const char * típusú hibát!
 char& String::operator[](unsigned int idx) {
@@ -86,9 +97,9 @@ String String::operator+(const String& rhs_s) const {
     // lefoglalja a memóriát az új stringnek.
     temp.pData = new char[temp.len+1];
     // Az elejére bemásolja az első stringet
-    strcpy(temp.pData, pData);
+    strcpy(temp.pData, c_str());
     // Bemásolja a második stringet.
-    strcat(temp.pData, rhs_s.pData);
+    strcat(temp.pData, rhs_s.c_str());
 
     return temp;		// visszatér az eredménnyel
 
@@ -23,6 +23,10 @@ public:
     /// @return Sztring hossza
 	size_t size() const { return len; }
 
+    /// A dinamikusan foglalt terület mérete (a lezáró nullával együtt)
+    /// @return 0, ha nincs foglalt terület (pl. mozgatás után)
+    size_t capacity() const { return pData != nullptr ? len + 1 : 0; }
+
 
     /// Default konstruktor
     /// String() :pData(0), len(0) {}
@@ -30,7 +34,7 @@ public:
 
     /// C-sztringet ad vissza
     /// @return pinter egy '\0'-val lezárt (C) sztringre
-    const char* c_str() const { return pData;}
+    const char* c_str() const { return pData != nullptr ? pData : ""; }
 
     /// Konstruktor egy char karakterből
     /// @param ch - karakter
@@ -45,6 +49,11 @@ public:
     /// @param s1 - String, amiből létrehozzuk az új String-et
     String(const String& s1);
 
+    /// Mozgató konstruktor
+    /// Átveszi a másik String tárolóját, a másik üres (nullptr) lesz
+    /// @param s1 - String, aminek a tartalmát átvesszük
+    String(String&& s1) :pData(s1.pData), len(s1.len) { s1.pData = nullptr; s1.len = 0; }
+
     /// Destruktor
     virtual ~String() { delete[] pData; }
 
@@ -82,6 +91,12 @@ public:
     /// @return baoldali (módosított) string (referenciája)
     String& operator=(const String& rhs_s);
 
+    /// Mozgató értékadó operátor.
+    /// Kicseréli a két String tárolóját, a régi tartalmat a jobboldal szabadítja fel
+    /// @param rhs_s - jobboldali String
+    /// @return baoldali (módosított) string (referenciája)
+    String& operator=(String&& rhs_s);
+
     /// Két Stringet összefűz
     /// @param rhs_s - jobboldali String
     /// @return új String, ami tartalmazza a két stringet egmás után
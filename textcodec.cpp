@@ -0,0 +1,171 @@
+/**
+ * \file textcodec.cpp
+ *
+ * Ez a fájl tartalmazza a TextCodec osztály megvalósítását
+ */
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include "textcodec.h"
+#include "memtrace.h"
+
+namespace
+{
+    /// Tanítási jelölt: megtakarítás és szöveg
+    typedef std::pair<unsigned long long, std::string> Candidate;
+
+    /// Jelöltek rendezése: nagyobb megtakarítás előre, egyezésnél ábécérendben (determinisztikus)
+    bool byGain( const Candidate& a, const Candidate& b )
+    {
+        if ( a.first != b.first ) return a.first > b.first;
+        return a.second < b.second;
+    }
+
+    const char* const HEX = "0123456789abcdef";
+}
+
+Components::TextCodec::TextCodec() :byFirst( 256 ) {
+}
+
+void Components::TextCodec::rebuildIndex() {
+    for ( size_t i = 0; i < byFirst.size(); i++ ) byFirst[i].clear();
+    for ( size_t i = 0; i < entries.size(); i++ )
+        byFirst[(unsigned char)entries[i][0]].push_back( (unsigned char)i );
+
+    // A leghosszabb illeszkedést keressük, ezért hossz szerint csökkenő sorrend
+    for ( size_t c = 0; c < byFirst.size(); c++ )
+    {
+        std::vector<unsigned char>& list = byFirst[c];
+        for ( size_t i = 1; i < list.size(); i++ )
+            for ( size_t j = i; j > 0 && entries[list[j-1]].size() < entries[list[j]].size(); j-- )
+                std::swap( list[j-1], list[j] );
+    }
+}
+
+void Components::TextCodec::train( const std::vector<std::string>& samples ) {
+    std::unordered_map<std::string, unsigned long long> counts;
+
+    size_t step = ( samples.size() + MAX_SAMPLES - 1 ) / MAX_SAMPLES;
+    if ( step == 0 ) step = 1;
+
+    std::vector<size_t> starts;
+    for ( size_t i = 0; i < samples.size(); i += step )
+    {
+        const std::string& s = samples[i];
+
+        // Szavak kezdete; egy szó a következő szó elejéig tart (a szóközzel együtt)
+        starts.clear();
+        for ( size_t j = 0; j < s.size(); j++ )
+            if ( s[j] != ' ' && ( j == 0 || s[j-1] == ' ' ) ) starts.push_back( j );
+        starts.push_back( s.size() );
+
+        for ( size_t k = 0; k + 1 < starts.size(); k++ )
+        {
+            size_t word = starts[k+1] - starts[k];
+            if ( word >= 2 && word <= MAX_ENTRY_LENGTH ) counts[s.substr( starts[k], word )]++;
+
+            // Szópár
+            if ( k + 2 < starts.size() )
+            {
+                size_t pair = starts[k+2] - starts[k];
+                if ( pair <= MAX_ENTRY_LENGTH ) counts[s.substr( starts[k], pair )]++;
+            }
+        }
+    }
+
+    std::vector<Candidate> candidates;
+    for ( std::unordered_map<std::string, unsigned long long>::iterator it = counts.begin(); it != counts.end(); it++ )
+    {
+        // Egyszer előforduló elem nem spórol (a szótárban is helyet foglal)
+        if ( it->second < 2 ) continue;
+        candidates.push_back( Candidate( it->second * ( it->first.size() - 1 ), it->first ) );
+    }
+    std::sort( candidates.begin(), candidates.end(), byGain );
+
+    entries.clear();
+    for ( size_t i = 0; i < candidates.size() && entries.size() < MAX_ENTRIES; i++ )
+        entries.push_back( candidates[i].second );
+    rebuildIndex();
+}
+
+std::string Components::TextCodec::encode( const std::string& text ) const {
+    std::string out;
+    out.reserve( text.size() );
+
+    for ( size_t p = 0; p < text.size(); )
+    {
+        unsigned char c = text[p];
+        const std::vector<unsigned char>& list = byFirst[c];
+
+        bool matched = false;
+        for ( size_t i = 0; i < list.size() && !matched; i++ )
+        {
+            const std::string& e = entries[list[i]];
+            if ( text.compare( p, e.size(), e ) == 0 )
+            {
+                out.push_back( (char)( FIRST_CODE + list[i] ) );
+                p += e.size();
+                matched = true;
+            }
+        }
+        if ( matched ) continue;
+
+        if ( c >= FIRST_CODE ) out.push_back( (char)ESCAPE );
+        out.push_back( (char)c );
+        p++;
+    }
+
+    return out;
+}
+
+std::string Components::TextCodec::decode( const std::string& data ) const {
+    std::string out;
+    out.reserve( data.size() * 2 );
+
+    for ( size_t p = 0; p < data.size(); p++ )
+    {
+        unsigned char c = data[p];
+        if ( c == ESCAPE ) { if ( ++p < data.size() ) out.push_back( data[p] ); }
+        else if ( c >= FIRST_CODE ) { if ( size_t( c - FIRST_CODE ) < entries.size() ) out += entries[c - FIRST_CODE]; }
+        else out.push_back( (char)c );
+    }
+
+    return out;
+}
+
+void Components::TextCodec::add( const std::string& entry ) {
+    if ( entry.empty() || entries.size() >= MAX_ENTRIES ) return;
+    entries.push_back( entry );
+    rebuildIndex();
+}
+
+void Components::TextCodec::clear() {
+    entries.clear();
+    rebuildIndex();
+}
+
+std::string Components::TextCodec::toHex( const std::string& entry ) {
+    std::string out;
+    for ( size_t i = 0; i < entry.size(); i++ )
+    {
+        unsigned char c = entry[i];
+        out.push_back( HEX[c >> 4] );
+        out.push_back( HEX[c & 0xf] );
+    }
+    return out;
+}
+
+bool Components::TextCodec::fromHex( const std::string& hex, std::string& entry ) {
+    if ( hex.size() % 2 != 0 ) return false;
+
+    entry.clear();
+    for ( size_t i = 0; i < hex.size(); i += 2 )
+    {
+        const char* hi = std::find( HEX, HEX + 16, hex[i] );
+        const char* lo = std::find( HEX, HEX + 16, hex[i+1] );
+        if ( hi == HEX + 16 || lo == HEX + 16 ) return false;
+        entry.push_back( (char)( ( ( hi - HEX ) << 4 ) | ( lo - HEX ) ) );
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef NHF4_TEXTCODEC_H
+#define NHF4_TEXTCODEC_H
+/**
+ * \file textcodec.h
+ *
+ * Ez a fájl tartalmazza az instrukciók tömörítéséhez használt TextCodec osztályt
+ */
+
+#include <string>
+#include <vector>
+#include "memtrace.h"
+
+
+namespace Components
+{
+    /**
+     * TextCodec osztály
+     * Szótár alapú tömörítő rövid, ismétlődő szövegekhez (receptek instrukciói)
+     * A szótárat a korpuszon tanítjuk: a leggyakoribb szavak és szópárok közül azokat választjuk,
+     * amelyek a legtöbb bájtot spórolják (előfordulás * (hossz - 1)).
+     * Kódolás: a 0x80-nál kisebb bájtok önmagukat jelentik, a 0x80 + i bájt a szótár i. elemét,
+     * a 0xff után pedig egy tetszőleges (pl. UTF-8) bájt következik. Mivel 0 és '\n' bájt
+     * nem keletkezik, a kódolt szöveg sorként tárolható a fájlban és String-ben is.
+     * Kódoláskor minden pozícióban a leghosszabb illeszkedő szótárelemet választjuk.
+     */
+    class TextCodec
+    {
+    public:
+        enum { MAX_ENTRIES = 127 };      /// A szótár legnagyobb mérete (0x80 .. 0xfe kódok)
+        enum { MAX_ENTRY_LENGTH = 32 };  /// A leghosszabb szótárelem
+        enum { MAX_SAMPLES = 20000 };    /// Tanításkor legfeljebb ennyi mintát vizsgálunk (egyenletes ritkítással)
+
+    private:
+        enum { FIRST_CODE = 0x80 };     /// Az első szótárkód
+        enum { ESCAPE = 0xff };         /// Nyers bájt jelzése
+
+        std::vector<std::string> entries;   /// Szótár
+        std::vector<std::vector<unsigned char> > byFirst;   /// Első bájt -> szótárelemek, hossz szerint csökkenő sorrendben
+
+        /// Felépíti a byFirst indexet
+        void rebuildIndex();
+
+    public:
+        /// Default konstruktor - üres szótár (csak a nem ASCII bájtokat védi)
+        TextCodec();
+
+        /// Szótár tanítása a megadott mintákon (a korábbi szótár elvész)
+        /// @param samples - minták (pl. az összes instrukció)
+        void train( const std::vector<std::string>& samples );
+
+        /// Szöveg kódolása
+        /// @param text - nyers szöveg
+        /// @return std::string - kódolt szöveg
+        std::string encode( const std::string& text ) const;
+
+        /// Kódolt szöveg visszafejtése
+        /// @param data - kódolt szöveg
+        /// @return std::string - nyers szöveg
+        std::string decode( const std::string& data ) const;
+
+        /// Szótárelem felvétele (fájlból visszatöltéskor)
+        /// @param entry - szótárelem, MAX_ENTRIES után figyelmen kívül hagyjuk
+        void add( const std::string& entry );
+
+        /// Szótár törlése
+        void clear();
+
+        /// Szótár mérete
+        /// @return size_t - szótárelemek száma
+        size_t size() const { return entries.size(); }
+
+        /// Szótárelem getter
+        /// @param i - index
+        /// @return const std::string& - szótárelem
+        const std::string& entry( size_t i ) const { return entries[i]; }
+
+        /// Szótárelem fájlba írható (hexadecimális) alakja
+        /// @param entry - szótárelem
+        /// @return std::string - hexadecimális alak
+        static std::string toHex( const std::string& entry );
+
+        /// Hexadecimális alak visszafejtése
+        /// @param hex - hexadecimális alak
+        /// @param entry - ide kerül a szótárelem
+        /// @return bool - érvényes volt-e az input
+        static bool fromHex( const std::string& hex, std::string& entry );
+    };
+}
+
+#endif // NHF4_TEXTCODEC_H